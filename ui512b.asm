@@ -54,10 +54,135 @@ ShiftMaskRt		DB				0ffh, 0feh, 0fch, 0f8h, 0f0h, 0e0h, 0c0h, 080h
 ShiftMaskLt		DB				0ffh, 07fh, 03fh, 01fh, 0fh, 07h, 03h, 01h	
 	ENDIF
 
+				ALIGN			8
+; Bloom filter: multiplier (2^64 / golden ratio, odd) stepping a hash to the next bit position of the pattern
+BloomMul		QWORD			9E3779B97F4A7C15h
+
+				ALIGN			64
+; ui512 hash (Hash512): key words XORd with HashSecret, lanes then folded in pairs after XOR with HashFold (constants from
+; the XXH3 default secret), result avalanched by HashAval
+HashSecret		QWORD			0BE4BA423396CFEB8h, 01CAD21F72C81017Ch, 0DB979083E96DD4DEh, 01F67B3B7A4A44072h
+				QWORD			078E5C0CC4EE679CBh, 02172FFCC7DD05A82h, 08E2443F7744608B8h, 04C263A81E69035E0h
+HashFold		QWORD			0CB00C391BB52283Ch, 0A32E531B8B65D088h, 04EF90DA297486471h, 0D8ACDEA946EF1938h
+				QWORD			03F349CE33F76FAA8h, 01D4F0BC7C7BBDCF9h, 03159B4CD4BE0518Ah, 0647378D9C97E9FC8h
+HashAval		QWORD			165667919E3779F9h
+; hash set tag groups, Q: zero byte test (seven low bits of each byte), and multiplier gathering the top bit of each byte
+HashLow7		QWORD			7F7F7F7F7F7F7F7Fh
+HashGather		QWORD			0102040810204080h
+; bit matrix transpose: masks of the low half of each group of 2 * j bits, j = 32, 16, 8, 4, 2, 1
+BitMasks		QWORD			00000000FFFFFFFFh, 0000FFFF0000FFFFh, 00FF00FF00FF00FFh
+				QWORD			0F0F0F0F0F0F0F0Fh, 3333333333333333h, 5555555555555555h
+; random: SplitMix64 for seeding, the increment then the two multipliers
+SplitMix		QWORD			9E3779B97F4A7C15h, 0BF58476D1CE4E5B9h, 94D049BB133111EBh
+
+				ALIGN			64
+; text (to_hex_u ... from_bin_n), rows of 64 bytes (Y reads the first 32, X the first 16): lower case hex digits, for each
+; 128 bit lane (PSHUFB lookup by nibble)
+TextHex			DB				30h, 31h, 32h, 33h, 34h, 35h, 36h, 37h, 38h, 39h, 61h, 62h, 63h, 64h, 65h, 66h
+				DB				30h, 31h, 32h, 33h, 34h, 35h, 36h, 37h, 38h, 39h, 61h, 62h, 63h, 64h, 65h, 66h
+				DB				30h, 31h, 32h, 33h, 34h, 35h, 36h, 37h, 38h, 39h, 61h, 62h, 63h, 64h, 65h, 66h
+				DB				30h, 31h, 32h, 33h, 34h, 35h, 36h, 37h, 38h, 39h, 61h, 62h, 63h, 64h, 65h, 66h
+; to_hex (Z): VPERMI2B index of the nibbles, high (0 up) then low (64 up) of each byte, in text order
+TextNibbles		DB				07h, 47h, 06h, 46h, 05h, 45h, 04h, 44h, 03h, 43h, 02h, 42h, 01h, 41h, 00h, 40h
+				DB				0Fh, 4Fh, 0Eh, 4Eh, 0Dh, 4Dh, 0Ch, 4Ch, 0Bh, 4Bh, 0Ah, 4Ah, 09h, 49h, 08h, 48h
+				DB				17h, 57h, 16h, 56h, 15h, 55h, 14h, 54h, 13h, 53h, 12h, 52h, 11h, 51h, 10h, 50h
+				DB				1Fh, 5Fh, 1Eh, 5Eh, 1Dh, 5Dh, 1Ch, 5Ch, 1Bh, 5Bh, 1Ah, 5Ah, 19h, 59h, 18h, 58h
+				DB				27h, 67h, 26h, 66h, 25h, 65h, 24h, 64h, 23h, 63h, 22h, 62h, 21h, 61h, 20h, 60h
+				DB				2Fh, 6Fh, 2Eh, 6Eh, 2Dh, 6Dh, 2Ch, 6Ch, 2Bh, 6Bh, 2Ah, 6Ah, 29h, 69h, 28h, 68h
+				DB				37h, 77h, 36h, 76h, 35h, 75h, 34h, 74h, 33h, 73h, 32h, 72h, 31h, 71h, 30h, 70h
+				DB				3Fh, 7Fh, 3Eh, 7Eh, 3Dh, 7Dh, 3Ch, 7Ch, 3Bh, 7Bh, 3Ah, 7Ah, 39h, 79h, 38h, 78h
+; from_hex (Z): VPERMI2B index of the byte made from each pair of digits (VPMADDUBSW), to its place in the words
+TextPack		DB				0Eh, 0Ch, 0Ah, 08h, 06h, 04h, 02h, 00h, 1Eh, 1Ch, 1Ah, 18h, 16h, 14h, 12h, 10h
+				DB				2Eh, 2Ch, 2Ah, 28h, 26h, 24h, 22h, 20h, 3Eh, 3Ch, 3Ah, 38h, 36h, 34h, 32h, 30h
+				DB				4Eh, 4Ch, 4Ah, 48h, 46h, 44h, 42h, 40h, 5Eh, 5Ch, 5Ah, 58h, 56h, 54h, 52h, 50h
+				DB				6Eh, 6Ch, 6Ah, 68h, 66h, 64h, 62h, 60h, 7Eh, 7Ch, 7Ah, 78h, 76h, 74h, 72h, 70h
+; bytes reversed: within each QWORD, and of the whole row (PSHUFB: within each lane)
+TextRevQ		DB				07h, 06h, 05h, 04h, 03h, 02h, 01h, 00h, 0Fh, 0Eh, 0Dh, 0Ch, 0Bh, 0Ah, 09h, 08h
+				DB				17h, 16h, 15h, 14h, 13h, 12h, 11h, 10h, 1Fh, 1Eh, 1Dh, 1Ch, 1Bh, 1Ah, 19h, 18h
+				DB				27h, 26h, 25h, 24h, 23h, 22h, 21h, 20h, 2Fh, 2Eh, 2Dh, 2Ch, 2Bh, 2Ah, 29h, 28h
+				DB				37h, 36h, 35h, 34h, 33h, 32h, 31h, 30h, 3Fh, 3Eh, 3Dh, 3Ch, 3Bh, 3Ah, 39h, 38h
+TextRev			DB				3Fh, 3Eh, 3Dh, 3Ch, 3Bh, 3Ah, 39h, 38h, 37h, 36h, 35h, 34h, 33h, 32h, 31h, 30h
+				DB				2Fh, 2Eh, 2Dh, 2Ch, 2Bh, 2Ah, 29h, 28h, 27h, 26h, 25h, 24h, 23h, 22h, 21h, 20h
+				DB				1Fh, 1Eh, 1Dh, 1Ch, 1Bh, 1Ah, 19h, 18h, 17h, 16h, 15h, 14h, 13h, 12h, 11h, 10h
+				DB				0Fh, 0Eh, 0Dh, 0Ch, 0Bh, 0Ah, 09h, 08h, 07h, 06h, 05h, 04h, 03h, 02h, 01h, 00h
+; to_bin (Y, X): the byte of a broadcast DWORD each text byte takes, most significant first, and the bit it tests
+TextSpread		DB				03h, 03h, 03h, 03h, 03h, 03h, 03h, 03h, 02h, 02h, 02h, 02h, 02h, 02h, 02h, 02h
+				DB				01h, 01h, 01h, 01h, 01h, 01h, 01h, 01h, 00h, 00h, 00h, 00h, 00h, 00h, 00h, 00h
+				DB				03h, 03h, 03h, 03h, 03h, 03h, 03h, 03h, 02h, 02h, 02h, 02h, 02h, 02h, 02h, 02h
+				DB				01h, 01h, 01h, 01h, 01h, 01h, 01h, 01h, 00h, 00h, 00h, 00h, 00h, 00h, 00h, 00h
+TextBit			DB				80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h, 80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h
+				DB				80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h, 80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h
+				DB				80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h, 80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h
+				DB				80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h, 80h, 40h, 20h, 10h, 08h, 04h, 02h, 01h
+TextLow4		DB				64 DUP (0Fh)
+TextChar0		DB				64 DUP (30h)					; '0'
+TextCharA		DB				64 DUP (61h)					; 'a'
+TextCase		DB				64 DUP (20h)					; OR: upper case letters to lower
+TextNine		DB				64 DUP (9)
+TextFive		DB				64 DUP (5)
+TextTen			DB				64 DUP (10)
+TextOne			DB				64 DUP (1)
+TextMul			DB				32 DUP (16, 1)					; VPMADDUBSW: high digit * 16 + low digit
+
 ; end of memory resident constants
 ; end of data segment
 ui512D			ENDS											; end of data segment
 
+ui512T			SEGMENT			'RODATA' ALIGN (8)				; instrument_table_u: an entry added by each proc with __Instrument
+instrument_table_u LABEL		QWORD
+ui512T			ENDS
+
+ui512V			SEGMENT			'DATA' ALIGN (64)				; Writable: the vector policy, alone in its cache line
+VectorPolicy	DWORD			VectorWide						; set_vector_policy_u
+				DB				60 DUP (0)
+ui512V			ENDS
+
+ui512V			SEGMENT			'DATA' ALIGN (64)				; the id of the thread given each instrument slot number (with
+instrument_threads_u QWORD		InstrumentThreads DUP (0)		; __Instrument; without it, never written)
+ui512V			ENDS
+
+	IF __Instrument
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			InstrumentThread	-	the calling thread's instrument slot number, for the Leaf_Entry wrapper (not called from C)
+;			returns		-	in R11: the slot number, 0 to InstrumentThreads - 1, or InstrumentThreads (shared) if all are taken
+;			Note:	the thread id (TEB ClientId, GS:[48h], or with __SysV the thread pointer, FS:[0]) hashed to a first place in
+;					instrument_threads_u, then probed on from there: the place holding the id, or the first free one, claimed by
+;					LOCK CMPXCHG (once, on the thread's first call). Ids are unique among running threads, so no two share a
+;					slot; a thread that has ended leaves its place to the next given its id (or to ui512_instrument_reset).
+;					RAX, RCX, R8, R9 overwritten
+
+ui512			SEGMENT			PARA 'CODE'
+				ALIGN			16
+InstrumentThread PROC
+		IF __SysV
+				MOV				RCX, FS:[ 0 ]
+		ELSE
+				MOV				RCX, GS:[ 48h ]
+		ENDIF
+				MOV				R11, 9E3779B97F4A7C15h			; multiplicative hash: the top bits the first place
+				IMUL			R11, RCX
+				SHR				R11, 64 - InstrumentThreadBits
+				LEA				R8, instrument_threads_u
+				MOV				R9D, InstrumentThreads			; places left to probe
+@@probe:		MOV				RAX, Q_PTR [ R8 ] [ R11 * 8 ]
+				CMP				RAX, RCX
+				JE				@@found
+				TEST			RAX, RAX
+				JZ				@@claim
+@@next:			INC				R11D
+				AND				R11D, InstrumentThreads - 1
+				DEC				R9D
+				JNZ				@@probe
+				MOV				R11D, InstrumentThreads			; all taken: the shared slot
+@@found:		RET
+@@claim:		LOCK CMPXCHG	Q_PTR [ R8 ] [ R11 * 8 ], RCX	; RAX 0: take the free place, if still free
+				JNE				@@next							; another thread took it first
+				RET
+InstrumentThread ENDP
+ui512			ENDS
+	ENDIF
+
 
 ;--------------------------------------------------------------------------------------------------------------------------------------------------------------
 ;			shr_u		-	shift supplied source 512bit (8 QWORDS) right, put in destination
@@ -66,22 +191,25 @@ ui512D			ENDS											; end of data segment
 ;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
 ;			bits		-	Number of bits to shift. Will fill with zeros, truncate those shifted out (in R8W)
 ;			returns		-	nothing (0)
-;			Note: unwound loop(s). More instructions, but fewer executed (no loop save, setup, compare loop), faster, fewer regs used
+;			Note: __UseZ, a bit shift within the words then a word permute; otherwise (and VectorLight) ShiftGPR, a funnel
+;				shift word by word in volatile registers, so destination may be source, and nothing saved or restored
 
 				Leaf_Entry		shr_u, ui512
 				CheckAlign		RCX								; (OUT) destination of shifted 8 QWORDs
 				CheckAlign		RDX								; (IN)	source of 8 QWORDS
+				IfLight			@@light							; VectorLight: in GPRs
 
-				CMP				R8W, 512						; handle edge case, shift 512 or more bits
-				JL				@F
+				MOVZX			R8D, R8W						; the count is u16: compare unsigned
+				CMP				R8D, 512						; handle edge case, shift 512 or more bits
+				JB				@F
 				Zero512			RCX								; zero destination
-				RET
+				RetV
 @@:				AND				R8, 511							; ensure no high bits above shift count
 				JNZ				@F								; handle edge case, zero bits to shift
 				CMP				RCX, RDX
 				JE				@@ret							; destination is the same as the source: no copy needed
 				Copy512			RCX, RDX						; no shift, just copy (destination, source already in regs)
-@@ret:			RET
+@@ret:			RetV
 @@:
 
 	IF	__UseZ
@@ -105,145 +233,14 @@ ui512D			ENDS											; end of data segment
 				VMOVDQA64		ZMM29, ZM_PTR [ RAX ]			; load permute indices
 				VPERMQ			ZMM31 {k1}{z}, ZMM29, ZMM31		; permute words in zmm31 to achieve word shift
 				VMOVDQA64		ZM_PTR [ RCX ], ZMM31			; store result at callers destination
-				RET
-
-	ELSE
-; save non-volatile regs to be used as work regs			
-				PUSH			R12								; going to use 8 gp regs for the 8 qword source
-				PUSH			R13								; R9, R10, R11 are considered 'volatile' and dont need to be saved
-				PUSH			R14								; R12, R13, R14, R15, RDI must be returned to caller with current values. Save them
-				PUSH			R15
-				PUSH			RDI
-				PUSH			RCX								; need current value of RCX (dest), but also need to use the reg. Save it
-				PUSH			RBX								; non-volatile, need the reg, so save the value
+				RetV
 
-; load sequential regs with source 8 qwords
-				MOV				R9, Q_PTR [ RDX ] [ 0 * 8 ]		; R9 holds source at index [0], most significant qword
-				MOV				R10, Q_PTR [ RDX ] [ 1 * 8 ]	; R10 <- [1]
-				MOV				R11, Q_PTR [ RDX ] [ 2 * 8 ]	; R11 <- [2]
-				MOV				R12, Q_PTR [ RDX ] [ 3 * 8 ]	; R12 <- [3]
-				MOV				R13, Q_PTR [ RDX ] [ 4 * 8 ]	; R13 <- [4]
-				MOV				R14, Q_PTR [ RDX ] [ 5 * 8 ]	; R14 <- [5]
-				MOV				R15, Q_PTR [ RDX ] [ 6 * 8 ]	; R15 <- [6]
-				MOV				RDI, Q_PTR [ RDX ] [ 7 * 8 ]	; RDI holds source at index [7], least significant qword
-
-; determine if / how many bits to shift
-				LEA				RCX, [ R8 ]						; R8 still carries users shift count.
-				AND				RCX, 03Fh						; Mask down to Nr of bits to shift right -> RCX
-				JZ				@@nobits						; might be word shifts, but no bit shifts required
-				LEA				RBX, [ 64 ]
-				SUB				RBX, RCX						; Nr to shift left -> RBX
-
-; Using Macro for repetitive ops. Reduces chance of typo, easier to maintain, but not used anywhere else
-				ShiftOrR		R15, RDI						; RDI is target to shift, but need bits from R15 to fill in high bits
-				ShiftOrR		R14, R15						; now R15 is target, but need bits from R14
-				ShiftOrR		R13, R14						; and on ...
-				ShiftOrR		R12, R13
-				ShiftOrR		R11, R12
-				ShiftOrR		R10, R11
-				ShiftOrR		R9, R10				
-				SHRX			R9, R9, RCX						; no bits to OR in on the index 0 (high order) word, just shift it.
+@@light:		ShiftGPR		0
+				RetV
 
-; with the bits shifted within the words, if the desired shift is more than 64 bits, word shifts are required
-; verify Nr of word shift is zero to seven, use it as index into jump table; jump to appropriate shift
-@@nobits:		SHR				R8W, 6							; divide bit shift count by 64 to get Nr words to shift
-				AND				R8, 7							; mask out anything above seven (shouldnt happen, but . . . jump table, be sure)
-				SHL				R8W, 3							; multiply by 8 to get offset into jump table
-				LEA				RAX, jtbl						; base address of jump table
-				ADD				R8, RAX							; add to offset
-				XOR				RAX, RAX						; clear rax for use in zeroing words shifted "in"
-				POP				RBX
-				POP				RCX								; restore RBX, RCX
-				JMP				Q_PTR [ R8 ]
-jtbl:
-				QWORD			S0, S1, S2, S3, S4, S5, S6, S7
-; no word shift, just bits, so store words in destination in the same order as they are in the regs
-S0:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R15
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RDI	
-				JMP				@@R
-; one word shift, store from regs to callers destination offsetting one word (zeroing first, most significant, word)
-S1:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R15	
-				JMP				@@R
-; two word shift
-S2:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R14	
-				JMP				@@R
-
-S3:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R13	
-				JMP				@@R
-
-S4:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R12			
-				JMP				@@R
-
-S5:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R11	
-				JMP				@@R
-
-S6:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R10	
-				JMP				@@R
-
-S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], R9		
-
-; restore non-volatile regs to as-called condition
-@@R:			POP				RDI
-				POP				R15
-				POP				R14
-				POP				R13
-				POP				R12
-				RET
+	ELSE
+				ShiftGPR		0								; volatile registers only; destination may be source
+				RetV
 	ENDIF	
 				Leaf_End		shr_u, ui512
 
@@ -255,21 +252,24 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 ;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
 ;			bits		-	Number of bits to shift. Will fill with zeros, truncate those shifted out (in R8W)
 ;			returns		-	nothing (0)
+;			Note: as shr_u, mirrored
 
 				Leaf_Entry		shl_u, ui512
 				CheckAlign		RCX								; (OUT) destination of shifted 8 QWORDs
 				CheckAlign		RDX								; (IN)	source of 8 QWORDS
+				IfLight			@@light							; VectorLight: in GPRs
 
-				CMP				R8W, 512						; handle edge case, shift 512 or more bits
-				JL				@F
+				MOVZX			R8D, R8W						; the count is u16: compare unsigned
+				CMP				R8D, 512						; handle edge case, shift 512 or more bits
+				JB				@F
 				Zero512			RCX								; zero destination
-				RET
+				RetV
 @@:				AND				R8, 511							; mask out high bits above shift count, test for 0
 				JNE				@F								; handle edge case, shift zero bits
 				CMP				RCX, RDX						; destination same as source?
 				JE				@@r								; no copy needed
 				Copy512			RCX, RDX						; no shift, just copy (destination, source already in regs)
-@@r:			RET
+@@r:			RetV
 @@:
 
 	IF __UseZ	
@@ -295,155 +295,14 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				VMOVDQA64		ZMM29, ZM_PTR [ RAX ]			; load permute indices
 				VPERMQ			ZMM31 {k1}{z}, ZMM29, ZMM31		; permute words in zmm31 to achieve word shift
 				VMOVDQA64		ZM_PTR [ RCX ], ZMM31			; store result at callers destination
-				RET
+				RetV
+
+@@light:		ShiftGPR		1
+				RetV
 				
 	ELSE
-; save non-volatile regs to be used as work regs			
-				PUSH			R12								; going to use 8 gp regs for the 8 qword source
-				PUSH			R13								; R9, R10, R11 are considered 'volatile' and dont need to be saved
-				PUSH			R14								; R12, R13, R14, R15, RDI must be returned to caller with current values. Save them
-				PUSH			R15
-				PUSH			RDI
-				PUSH			RCX								; need current value of RCX (dest), but also need to use the reg. Save it
-				PUSH			RBX								; non-volatile, need the reg, so save the value
-
-; load sequential regs with source 8 qwords
-				MOV				R9, Q_PTR [ RDX ] [ 0 * 8 ]		; R9 holds source at index [0], most significant qword
-				MOV				R10, Q_PTR [ RDX ] [ 1 * 8 ]	; R10 <- [1]
-				MOV				R11, Q_PTR [ RDX ] [ 2 * 8 ]	; R11 <- [2]
-				MOV				R12, Q_PTR [ RDX ] [ 3 * 8 ]	; R12 <- [3]
-				MOV				R13, Q_PTR [ RDX ] [ 4 * 8 ]	; R13 <- [4]
-				MOV				R14, Q_PTR [ RDX ] [ 5 * 8 ]	; R14 <- [5]
-				MOV				R15, Q_PTR [ RDX ] [ 6 * 8 ]	; R15 <- [6]
-				MOV				RDI, Q_PTR [ RDX ] [ 7 * 8 ]	; RDI holds source at index [7], least significant qword
-
-; determine if / how many bits to shift
-				LEA				RCX, [ R8 ]						; R8 still carries users shift count.
-				AND				RCX, 03Fh						; Mask down to Nr of bits to shift left -> RCX
-				JZ				@@nobits						; might be word shifts, but no bit shifts required
-				LEA				RBX, [ 64 ]
-				SUB				RBX, RCX						; Nr to shift right -> RBX
-
-; Macro for repetitive ops. Reduces chance of typo, easier to maintain, but not used anywhere else
-				ShiftOrL		R10, R9							; R9 is target to shift, but need bits from R10 to fill in low bits
-				ShiftOrL		R11, R10
-				ShiftOrL		R12, R11
-				ShiftOrL		R13, R12
-				ShiftOrL		R14, R13
-				ShiftOrL		R15, R14
-				ShiftOrL		RDI, R15				
-				SHLX			RDI, RDI, RCX					; no bits to OR in on the index 0 (high order) word, just shift it.
-
-; with the bits shifted within the words, if the desired shift is more than 64 bits, word shifts are required
-; verify Nr of word shift is zero to seven, use it as index into jump table; jump to appropriate shift
-@@nobits:		SHR				R8W, 6
-				AND				R8, 07h 
-				SHL				R8W, 3
-				LEA				RAX, @@jtbl
-				ADD				R8, RAX
-				XOR				RAX, RAX						; clear rax for use as zeroing words shifted "in"
-				POP				RBX								
-				POP				RCX								; restore RCX, destination address
-				JMP				Q_PTR [ R8 ]
-
-@@jtbl:
-				QWORD			@@0, @@1, @@2, @@3, @@4, @@5, @@6, @@7
-
-; no word shift, just bits, so store words in destination in the same order as they are
-@@0:			MOV				Q_PTR [ RCX ] [ 0 * 8 ], R9
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], R15
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RDI	
-				JMP				@@R
-
-; one word shift, shifting one word (64+ bits) so store words in destination shifted left one, fill with zero
-@@1:			MOV				Q_PTR [ RCX ] [ 0 * 8 ], R10
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R11
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], R15
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], RDI
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RAX	
-				JMP				@@R
-
-; two word shift
-@@2:			MOV				Q_PTR [ RCX ] [ 0 * 8], R11
-				MOV				Q_PTR [ RCX ] [ 1 * 8], R12
-				MOV				Q_PTR [ RCX ] [ 2 * 8], R13
-				MOV				Q_PTR [ RCX ] [ 3 * 8], R14
-				MOV				Q_PTR [ RCX ] [ 4 * 8], R15
-				MOV				Q_PTR [ RCX ] [ 5 * 8], RDI
-				MOV				Q_PTR [ RCX ] [ 6 * 8], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8], RAX	
-				JMP				@@R
-
-; three word shift
-@@3:			MOV				Q_PTR [ RCX ] [ 0 * 8 ], R12
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], R15
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RDI
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RAX	
-				JMP				@@R
-
-; four word shift
-@@4:			MOV				Q_PTR [ RCX ] [ 0 * 8 ], R13
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], R15
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RDI
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RAX	
-				JMP				@@R
-
-; five word shift
-@@5:			MOV				Q_PTR [ RCX ] [ 0 * 8 ], R14
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], R15
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RDI
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RAX	
-				JMP				@@R
-
-; six word shift
-@@6:			MOV				Q_PTR [ RCX ] [ 0 * 8], R15
-				MOV				Q_PTR [ RCX ] [ 1 * 8], RDI
-				MOV				Q_PTR [ RCX ] [ 2 * 8], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8], RAX	
-				JMP				@@R
-
-; seven word shift
-@@7:			MOV				Q_PTR [ RCX ] [ 0 * 8 ], RDI
-				MOV				Q_PTR [ RCX ] [ 1 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 2 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 3 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 4 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 5 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 6 * 8 ], RAX
-				MOV				Q_PTR [ RCX ] [ 7 * 8 ], RAX
-
-;	restore non-volatile regs to as-called condition
-@@R:			POP				RDI
-				POP				R15
-				POP				R14
-				POP				R13
-				POP				R12
-@@ret:			RET
-
+				ShiftGPR		1								; volatile registers only; destination may be source
+				RetV
 	ENDIF
 				Leaf_End		shl_u, ui512
 
@@ -461,9 +320,12 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				CheckAlign		R8
 
 	IF __UseZ	
+				IfLight			@@light
 				VMOVDQA64		ZMM31, ZM_PTR [ RDX ]			; load lh_op	
 				VPANDQ			ZMM31, ZMM31, ZM_PTR [ R8 ]		; 'AND' with rh_op
 				VMOVDQA64		ZM_PTR [ RCX ], ZMM31			; store at destination address
+				RetV
+@@light:		Logic512Y		RCX, RDX, R8, VPANDQ		; VectorLight: two 256 bit halves
 
 	ELSEIF __UseY
 				VMOVDQA64		YMM4, YM_PTR [ RDX + 0 * 8 ]
@@ -496,7 +358,7 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				ENDM
 
 	ENDIF
-				RET		
+				RetV		
 				Leaf_End		and_u, ui512
 
 ;--------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -513,9 +375,12 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				CheckAlign		R8
 
 	IF __UseZ	
+				IfLight			@@light
 				VMOVDQA64		ZMM31, ZM_PTR [ RDX ]			
 				VPORQ			ZMM31, ZMM31, ZM_PTR [ R8 ]
 				VMOVDQA64		ZM_PTR [ RCX ], ZMM31
+				RetV
+@@light:		Logic512Y		RCX, RDX, R8, VPORQ		; VectorLight: two 256 bit halves
 
 	ELSEIF __UseY
 				VMOVDQA64		YMM4, YM_PTR [ RDX + 0 * 8 ]
@@ -547,7 +412,7 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				ENDM
 
 	ENDIF
-				RET 
+				RetV 
 				Leaf_End		or_u, ui512
 
 ;--------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -564,9 +429,12 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				CheckAlign		R8
 
 	IF __UseZ	
+				IfLight			@@light
 				VMOVDQA64		ZMM31, ZM_PTR [ RDX ]			
 				VPXORQ			ZMM31, ZMM31, ZM_PTR [ R8 ]
 				VMOVDQA64		ZM_PTR [ RCX ], ZMM31
+				RetV
+@@light:		Logic512Y		RCX, RDX, R8, VPXORQ		; VectorLight: two 256 bit halves
 
 	ELSEIF __UseY
 				VMOVDQA64		YMM4, YM_PTR [ RDX + 0 * 8 ]
@@ -598,7 +466,7 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				ENDM
 
 	ENDIF
-				RET 
+				RetV 
 				Leaf_End		xor_u, ui512
 
 ;--------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -613,9 +481,12 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				CheckAlign		RDX
 
 	IF __UseZ	
+				IfLight			@@light
 				VMOVDQA64		ZMM31, ZM_PTR [RDX]			
 				VPANDNQ			ZMM31, ZMM31, qOnes					; qOnes (declared in the data section of this module) is 8 QWORDS, binary all ones
 				VMOVDQA64		ZM_PTR [RCX], ZMM31
+				RetV
+@@light:		Logic512Y		RCX, RDX, qOnes, VPANDNQ		; VectorLight: two 256 bit halves
 
 	ELSEIF __UseY
 				VMOVDQA64		YMM4, YM_PTR [ RDX + 0 * 8 ]
@@ -647,7 +518,7 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				ENDM
 
 	ENDIF
-				RET	
+				RetV	
 				Leaf_End		not_u, ui512
 
 ;--------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -662,6 +533,7 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				CheckAlign		RCX								; (IN) source to scan 
 
 	IF __UseZ
+				IfLight			@@scan							; VectorLight: the GPR scan
 				VMOVDQA64		ZMM31, ZM_PTR [RCX]				; Load source 
 				VPTESTMQ		k1, ZMM31, ZMM31				; find non-zero words (if any)
 				KMOVB			EAX, k1							; ZMM regs in least significant word to most ([0] lsw to [7] msw)
@@ -672,14 +544,17 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 @@:				LEA				EAX, [ 7 ]						; numbering of words in Z regs (and hence in k1 mask) is reverse in significance order
 				SUB				EAX, ECX						; so 7 minus leading k bit index becomes index to our ui512 bit qword
 				SHL				EAX, 6							; convert index to offset
-				VPCOMPRESSQ		ZMM0 {k1}{z}, ZMM31				; compress it into first word of ZMM0, which is also XMM0
-				VMOVQ			RCX, XMM0						; extract the non-zero word (k1 still has index to it)
+				VPCOMPRESSQ		ZMM30 {k1}{z}, ZMM31			; compress it into first word of ZMM30 (ZMM16 up: no upper state left)
+				VMOVQ			RCX, XMM30						; extract the non-zero word (k1 still has index to it)
 				LZCNT			RCX, RCX						; get the index of the non-zero bit within the word
 				ADD				EAX, 63							; LZCNT counts leading non-zero bits. Subtract from 63 to get our bit index
 				SUB				EAX, ECX						; Word index * 64 + bit index becomes bit index to first non-zero bit (0 to 511, where )
 				RET
 
-	ELSE
+	ENDIF
+
+; the other paths, and Z with VectorLight: a word at a time in GPRs
+@@scan:
 				LEA				R10, [ -1 ]						; Initialize loop counter (and index)
 @@NextWord:
 				INC				R10D
@@ -697,7 +572,6 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				ADD				EAX, ECX						; plus the found bit position within the word yields the bit position within the 512 bit source
 				RET	
 
-	ENDIF
 				Leaf_End		msb_u, ui512
 
 ;--------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -712,6 +586,7 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				CheckAlign		RCX								; (IN) source to scan
 
 	IF __UseZ
+				IfLight			@@scan							; VectorLight: the GPR scan
 				VMOVDQA64		ZMM31, ZM_PTR [ RCX ]			; Load source 
 				VPTESTMQ		k1, ZMM31, ZMM31				; find non-zero words (if any)
 				KMOVB			EAX, k1
@@ -727,14 +602,17 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				MOV				CL, AL
 				SHL				R9D, CL
 				KMOVB			k1, R9D
-				VPCOMPRESSQ		ZMM0 {k1}{z}, ZMM31
-				VMOVQ			RAX, XMM0						; extract the non-zero word
+				VPCOMPRESSQ		ZMM30 {k1}{z}, ZMM31			; ZMM16 up: no upper state left
+				VMOVQ			RAX, XMM30						; extract the non-zero word
 				SHL				R10D, 6							; convert index to offset
 				TZCNT			RAX, RAX						; get the index of the non-zero bit within the word
 				ADD				EAX, R10D						; Word index * 64 + bit index becomes bit index to first non-zero bit (0 to 511, where )
 				RET
 
-	ELSE
+	ENDIF
+
+; the other paths, and Z with VectorLight: a word at a time in GPRs
+@@scan:
 				LEA				R10D, [ 8 ]		 				; Initialize loop counter (and index)
 @@NextWord:
 				DEC				R10D
@@ -750,7 +628,3222 @@ S7:				MOV				Q_PTR [ RCX ] [ 0 * 8 ], RAX
 				ADD				EAX, R11D						; plus the BSF found bit position within the word yields the bit position within the 512 bit source
 				RET
 
-	ENDIF
 				Leaf_End		lsb_u, ui512
 
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			popcnt_u	-	count the set bits in supplied source 512bit (8 QWORDS)
+;			Prototype:		s16 popcnt_u( u64* source );
+;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			returns		-	number of set bits, 0 to 512 inclusive
+
+				Leaf_Entry		popcnt_u, ui512
+				CheckAlign		RCX								; (IN) source to count
+
+	IF __UseZ
+				VPOPCNTQ		ZMM31, ZM_PTR [ RCX ]			; count of set bits in each word
+				HSum31			RAX								; add them up
+	ELSE
+				POPCNT			RAX, Q_PTR [ RCX ] [ 0 * 8 ]
+				FOR				idx, < 1, 2, 3, 4, 5, 6, 7 >
+				POPCNT			RDX, Q_PTR [ RCX ] [ idx * 8 ]
+				ADD				RAX, RDX
+				ENDM
+	ENDIF
+				RET
+				Leaf_End		popcnt_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			rank_u		-	count the set bits below the supplied bit number in source 512bit (8 QWORDS)
+;			Prototype:		s16 rank_u( u64* source, u16 bit );
+;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			bit			-	Bit number (0 to 511, numbered as msb_u / lsb_u), count bits below it. 512 or more counts all (in DX)
+;			returns		-	number of set bits numbered 0 to bit-1
+
+				Leaf_Entry		rank_u, ui512
+				CheckAlign		RCX								; (IN) source to count
+
+				MOVZX			R8D, DX
+				MOV				EAX, 512
+				CMP				R8D, EAX
+				CMOVA			R8D, EAX						; rank past the end is the count of all bits
+				MOV				R9, RCX							; RCX is a work reg for the count
+				Rank512			R9, R8
+				RET
+				Leaf_End		rank_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			select_u	-	find the k-th (zero based, counting up from bit 0) set bit in supplied source 512bit (8 QWORDS)
+;			Prototype:		s16 select_u( u64* source, u16 k );
+;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			k			-	Rank of the set bit to find; zero finds the same bit as lsb_u (in DX)
+;			returns		-	-1 if fewer than k+1 bits are set, bit number otherwise, bits numbered 0 to 511 inclusive
+;			Note:	word found by POPCNT, bit within word by PDEP / TZCNT (or clearing low bits if not __UseBMI2)
+
+				Leaf_Entry		select_u, ui512
+				CheckAlign		RCX								; (IN) source to scan
+
+				MOVZX			EDX, DX							; k
+				Select512		RCX, RDX, R10, R11
+				RET
+				Leaf_End		select_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			rsindex_n	-	build rank / select index over an array of 512bit blocks in one pass
+;			Prototype:		u64 rsindex_n( u64* counts, u64* hints, u64* blocks, u64 nblocks );
+;			counts		-	Address of nblocks+1 QWORDS, receives the number of set bits before each block, and the total (in RCX)
+;			hints		-	Address of (nblocks / 8) + 2 QWORDS, receives the block index of every (1 SHL RSHintShift)th set bit,
+;								followed by the last block index (in RDX)
+;			blocks		-	Address of 64 byte aligned array of nblocks 512 bit blocks (in R8)
+;			nblocks		-	Number of blocks (in R9)
+;			returns		-	total number of set bits
+;			Note:	bits in the array are numbered block * 512 + bit within block (numbered as msb_u / lsb_u)
+
+				Leaf_Entry		rsindex_n, ui512
+				CheckAlign		R8								; (IN) blocks to index
+
+				PUSH			RBX								; non-volatile, need the reg, so save the value
+				XOR				EAX, EAX						; running count of set bits
+				XOR				R10D, R10D						; block index
+				XOR				R11D, R11D						; rank of the next set bit to sample into hints
+@@block:		CMP				R10, R9
+				JAE				@@done
+				PREFETCHT0		B_PTR [ R8 ] [ 8 * 64 ]			; stream: fetch eight blocks ahead
+				MOV				Q_PTR [ RCX ] [ R10 * 8 ], RAX	; set bits before this block
+	IF __UseZ
+				VPOPCNTQ		ZMM31, ZM_PTR [ R8 ]
+				HSum31			RBX
+				ADD				RAX, RBX
+	ELSE
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				POPCNT			RBX, Q_PTR [ R8 ] [ idx * 8 ]
+				ADD				RAX, RBX
+				ENDM
+	ENDIF
+@@hint:			CMP				R11, RAX						; next sampled bit within this block?
+				JAE				@@next
+				MOV				Q_PTR [ RDX ], R10				; yes, record the block index
+				ADD				RDX, 8
+				ADD				R11, 1 SHL RSHintShift
+				JMP				@@hint
+@@next:			ADD				R8, 64
+				INC				R10
+				JMP				@@block
+
+@@done:			MOV				Q_PTR [ RCX ] [ R10 * 8 ], RAX	; final count entry is the total
+				LEA				RBX, [ R10 - 1 ]
+				MOV				Q_PTR [ RDX ], RBX				; final hint is the last block, bounds the search for ranks past the last sample
+				POP				RBX
+				RET
+				Leaf_End		rsindex_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			rank_n		-	count the set bits below bit 'i' in an indexed array of 512bit blocks
+;			Prototype:		u64 rank_n( u64* counts, u64* blocks, u64 i );
+;			counts		-	Address of counts built by rsindex_n (in RCX)
+;			blocks		-	Address of 64 byte aligned array of 512 bit blocks (in RDX)
+;			i			-	Bit number, 0 to nblocks * 512 inclusive (in R8)
+;			returns		-	number of set bits numbered 0 to i-1
+
+				Leaf_Entry		rank_n, ui512
+				MOV				RAX, R8
+				SHR				RAX, 9							; block holding bit i
+				MOV				R9, Q_PTR [ RCX ] [ RAX * 8 ]	; set bits before that block
+				AND				R8, 511							; bit within block
+				JNZ				@F
+				MOV				RAX, R9							; first bit of a block (or end of array), count is all in the index
+				RET
+@@:				SHL				RAX, 6
+				ADD				RDX, RAX						; address of block
+				CheckAlign		RDX
+				Rank512			RDX, R8
+				ADD				RAX, R9
+				RET
+				Leaf_End		rank_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			select_n	-	find the k-th (zero based) set bit in an indexed array of 512bit blocks
+;			Prototype:		u64 select_n( u64* counts, u64* hints, u64* blocks, u64 nblocks, u64 k );
+;			counts		-	Address of counts built by rsindex_n (in RCX)
+;			hints		-	Address of hints built by rsindex_n (in RDX)
+;			blocks		-	Address of 64 byte aligned array of 512 bit blocks (in R8)
+;			nblocks		-	Number of blocks (in R9)
+;			k			-	Rank of the set bit to find (on stack)
+;			returns		-	bit number (block * 512 + bit within block), -1 (all ones) if fewer than k+1 bits are set
+;			Note:	hints bound the block search to those holding 2^RSHintShift set bits, then binary search on counts
+
+				Stack_Entry		select_n, ui512
+				MOV				RAX, Q_PTR [ RSP ] [ 5 * 8 ]	; k (fifth parameter, above return address and home space)
+				CMP				RAX, Q_PTR [ RCX ] [ R9 * 8 ]	; below the total number of set bits?
+				JB				@F
+				LEA				RAX, [ retcode_neg_one ]
+				RET
+@@:				MOV				R10, RAX
+				SHR				R10, RSHintShift				; hint index
+				MOV				R11, Q_PTR [ RDX ] [ R10 * 8 ] [ 8 ]	; block holding next sampled bit: last possible block
+				INC				R11								; exclusive upper bound of search
+				MOV				R10, Q_PTR [ RDX ] [ R10 * 8 ]	; block holding sampled bit: first possible block
+
+; binary search for the last block in [ R10, R11 ) with set bits before it not more than k
+@@search:		LEA				RDX, [ R10 + 1 ]
+				CMP				RDX, R11
+				JAE				@@found
+				LEA				RDX, [ R10 + R11 ]
+				SHR				RDX, 1							; midpoint
+				CMP				Q_PTR [ RCX ] [ RDX * 8 ], RAX
+				CMOVA			R11, RDX						; more than k before mid: mid becomes upper bound
+				CMOVBE			R10, RDX						; otherwise it becomes lower bound
+				JMP				@@search
+
+@@found:		MOV				RDX, RAX
+				SUB				RDX, Q_PTR [ RCX ] [ R10 * 8 ]	; k, relative to the block
+				MOV				R9, R10
+				SHL				R10, 6
+				ADD				R8, R10							; address of block
+				CheckAlign		R8
+				Select512		R8, RDX, R10, R11
+				SHL				R9, 9							; block index times 512
+				ADD				RAX, R9							; plus bit within block
+				RET
+				Stack_End		select_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bloom_pattern_u	-	build the k bit Bloom filter pattern for a hash (the bits that bloom_add_u sets in its block)
+;			Prototype:		void bloom_pattern_u( u64* destination, u64 hash, u16 k );
+;			destination	-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			hash		-	64 bit hash of the key (in RDX)
+;			k			-	Number of bits to set; steps may coincide, so the pattern has 1 to k bits set (in R8W)
+
+				Leaf_Entry		bloom_pattern_u, ui512
+				CheckAlign		RCX								; (OUT) pattern
+
+				MOVZX			R8D, R8W
+	IF __UseZ
+				BloomBits		RDX, R8, R9, RCX
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM31
+	ELSE
+				Zero512Q		RCX
+				BloomBits		RDX, R8, R9, RCX
+	ENDIF
+				RET
+				Leaf_End		bloom_pattern_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bloom_add_u	-	add a hash to a blocked Bloom filter: set the k bits of its pattern in the one block it selects
+;			Prototype:		void bloom_add_u( u64* filter, u64 nblocks, u64 hash, u16 k );
+;			filter		-	Address of 64 byte aligned array of nblocks 512 bit blocks (in RCX)
+;			nblocks		-	Number of blocks (in RDX)
+;			hash		-	64 bit hash of the key (in R8)
+;			k			-	Number of bits per key (in R9W)
+;			Note:	block is chosen by the high bits of the hash (multiply-shift), so any nblocks works; one cache line per key
+
+				Leaf_Entry		bloom_add_u, ui512
+				MOVZX			R9D, R9W
+				BloomBlock		R8, RDX, RCX
+				MOV				RCX, RDX
+				CheckAlign		RCX								; (IN/OUT) block
+				BloomBits		R8, R9, RDX, RCX
+	IF __UseZ
+				VPORQ			ZMM31, ZMM31, ZM_PTR [ RCX ]
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM31
+	ENDIF
+				RET
+				Leaf_End		bloom_add_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bloom_test_u	-	test a hash against a blocked Bloom filter
+;			Prototype:		s16 bloom_test_u( u64* filter, u64 nblocks, u64 hash, u16 k );
+;			filter		-	Address of 64 byte aligned array of nblocks 512 bit blocks (in RCX)
+;			nblocks		-	Number of blocks (in RDX)
+;			hash		-	64 bit hash of the key (in R8)
+;			k			-	Number of bits per key, as added (in R9W)
+;			returns		-	1 if all bits of the pattern are set (the hash may have been added), 0 if not (it definitely was not)
+
+				Leaf_Entry		bloom_test_u, ui512
+				MOVZX			R9D, R9W
+				BloomBlock		R8, RDX, RCX
+				MOV				RCX, RDX
+				CheckAlign		RCX								; (IN) block
+	IF __UseZ
+				BloomBits		R8, R9, RDX, RCX
+				VPANDQ			ZMM30, ZMM31, ZM_PTR [ RCX ]	; pattern bits present in the block
+				VPCMPQ			k1, ZMM30, ZMM31, CPNE			; any word missing one?
+				XOR				EAX, EAX
+				KORTESTB		k1, k1
+				SETZ			AL
+				RET
+	ELSE
+				BloomBits		R8, R9, RDX, RCX, @@absent
+				MOV				EAX, 1
+				RET
+@@absent:		XOR				EAX, EAX
+				RET
+	ENDIF
+				Leaf_End		bloom_test_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bloom_add_n	-	add n hashes to a blocked Bloom filter
+;			Prototype:		void bloom_add_n( u64* filter, u64 nblocks, u64* hashes, u64 n, u16 k );
+;			filter		-	Address of 64 byte aligned array of nblocks 512 bit blocks (in RCX)
+;			nblocks		-	Number of blocks (in RDX)
+;			hashes		-	Address of n 64 bit hashes (in R8)
+;			n			-	Number of hashes (in R9)
+;			k			-	Number of bits per key (on stack)
+;			Note:	same result as bloom_add_u for each hash; the block for the hash BloomAhead further on is prefetched
+
+				Stack_Entry		bloom_add_n, ui512
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				RSI, RCX						; filter
+				MOV				RDI, RDX						; nblocks
+@@next:			TEST			R9, R9
+				JZ				@@done
+				CMP				R9, BloomAhead
+				JBE				@F
+				BloomBlock		Q_PTR [ R8 ] [ BloomAhead * 8 ], RDI, RSI
+				PREFETCHT0		B_PTR [ RDX ]					; block for a later hash
+@@:				MOV				RBX, Q_PTR [ R8 ]
+				BloomBlock		RBX, RDI, RSI
+				CheckAlign		RDX								; (IN/OUT) block
+				MOVZX			R11D, W_PTR [ RSP ] [ 8 * 8 ]	; k (fifth parameter, above saved regs, return address and home space)
+				BloomBits		RBX, R11, RCX, RDX
+	IF __UseZ
+				VPORQ			ZMM31, ZMM31, ZM_PTR [ RDX ]
+				VMOVDQA64		ZM_PTR [ RDX ], ZMM31
+	ENDIF
+				ADD				R8, 8
+				DEC				R9
+				JMP				@@next
+@@done:			POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+				Stack_End		bloom_add_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bloom_test_n	-	test n hashes against a blocked Bloom filter
+;			Prototype:		void bloom_test_n( u64* filter, u64 nblocks, u64* hashes, u64 n, u16 k, u64* results );
+;			filter		-	Address of 64 byte aligned array of nblocks 512 bit blocks (in RCX)
+;			nblocks		-	Number of blocks (in RDX)
+;			hashes		-	Address of n 64 bit hashes (in R8)
+;			n			-	Number of hashes (in R9)
+;			k			-	Number of bits per key, as added (on stack)
+;			results		-	Address of (n + 63) / 64 QWORDS, bit i mod 64 of QWORD i / 64 set if hash i may have been added (on stack)
+;			Note:	same result as bloom_test_u for each hash; the block for the hash BloomAhead further on is prefetched
+
+				Stack_Entry		bloom_test_n, ui512
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				MOV				RSI, RCX						; filter
+				MOV				RDI, RDX						; nblocks
+				MOV				R12, Q_PTR [ RSP ] [ 12 * 8 ]	; results (sixth parameter)
+				XOR				R13D, R13D						; result bits for the current QWORD
+				XOR				R14D, R14D						; hash index
+@@next:			CMP				R14, R9
+				JAE				@@done
+				LEA				RAX, [ R14 + BloomAhead ]
+				CMP				RAX, R9
+				JAE				@F
+				BloomBlock		Q_PTR [ R8 ] [ R14 * 8 ] [ BloomAhead * 8 ], RDI, RSI
+				PREFETCHT0		B_PTR [ RDX ]					; block for a later hash
+@@:				MOV				RBX, Q_PTR [ R8 ] [ R14 * 8 ]
+				BloomBlock		RBX, RDI, RSI
+				CheckAlign		RDX								; (IN) block
+				MOVZX			R11D, W_PTR [ RSP ] [ 11 * 8 ]	; k (fifth parameter)
+	IF __UseZ
+				BloomBits		RBX, R11, RCX, RDX
+				VPANDQ			ZMM30, ZMM31, ZM_PTR [ RDX ]	; pattern bits present in the block
+				VPCMPQ			k1, ZMM30, ZMM31, CPNE			; any word missing one?
+				KORTESTB		k1, k1
+				JNZ				@@absent
+	ELSE
+				BloomBits		RBX, R11, RCX, RDX, @@absent
+	ENDIF
+				BTS				R13, R14						; present: set result bit (index mod 64)
+@@absent:		INC				R14
+				TEST			R14D, 63
+				JNZ				@@next
+				MOV				Q_PTR [ R12 ], R13				; QWORD of results complete, store it
+				ADD				R12, 8
+				XOR				R13D, R13D
+				JMP				@@next
+@@done:			TEST			R14D, 63
+				JZ				@F
+				MOV				Q_PTR [ R12 ], R13				; partial final QWORD
+@@:				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+				Stack_End		bloom_test_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			match_n		-	select the records of an array of 512bit records for which ( record AND mask ) equals pattern
+;			Prototype:		u64 match_n( u64* records, u64 n, u64* mask, u64* pattern, u64* out_indices );
+;			records		-	Address of 64 byte aligned array of n 512 bit records (in RCX)
+;			n			-	Number of records (in RDX)
+;			mask		-	Address of 64 byte aligned 512 bit mask (in R8)
+;			pattern		-	Address of 64 byte aligned 512 bit pattern (in R9)
+;			out_indices	-	Address of room for n QWORDS, receives the index of each matching record, ascending (on stack)
+;			returns		-	number of matching records
+;			Note:	one pass, no branch on the match: every index is stored, and the count advanced by the match (carry) flag
+
+				Stack_Entry		match_n, ui512
+				CheckAlign		RCX								; (IN) records
+				CheckAlign		R8								; (IN) mask
+				CheckAlign		R9								; (IN) pattern
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				MOV				R10, Q_PTR [ RSP ] [ 7 * 8 ]	; out_indices (fifth parameter, above saved regs, return address and home space)
+				XOR				EBX, EBX						; count of matches
+				XOR				ESI, ESI						; record index
+	IF __UseZ
+				VMOVDQA64		ZMM29, ZM_PTR [ R8 ]			; mask and pattern held for the pass
+				VMOVDQA64		ZMM28, ZM_PTR [ R9 ]
+	ENDIF
+@@next:			CMP				RSI, RDX
+				JAE				@@done
+				PREFETCHT0		B_PTR [ RCX ] [ 8 * 64 ]		; stream: fetch eight records ahead
+	IF __UseZ
+				Match512		ZM_PTR [ RCX ], ZMM29, ZMM28
+	ELSE
+				Match512		RCX, R8, R9
+	ENDIF
+				MOV				Q_PTR [ R10 ] [ RBX * 8 ], RSI	; store index, kept only if it matched
+				ADC				RBX, 0
+				ADD				RCX, 64
+				INC				RSI
+				JMP				@@next
+@@done:			MOV				RAX, RBX
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		match_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			match_bits_n	-	as match_n, but setting a bit for each matching record
+;			Prototype:		u64 match_bits_n( u64* records, u64 n, u64* mask, u64* pattern, u64* bitmap );
+;			records		-	Address of 64 byte aligned array of n 512 bit records (in RCX)
+;			n			-	Number of records (in RDX)
+;			mask		-	Address of 64 byte aligned 512 bit mask (in R8)
+;			pattern		-	Address of 64 byte aligned 512 bit pattern (in R9)
+;			bitmap		-	Address of (n + 63) / 64 QWORDS, bit i mod 64 of QWORD i / 64 set if record i matches (on stack)
+;			returns		-	number of matching records
+;			Note:	match (carry) flag is rotated into the top of the QWORD of results, so after 64 records the first is bit 0
+
+				Stack_Entry		match_bits_n, ui512
+				CheckAlign		RCX								; (IN) records
+				CheckAlign		R8								; (IN) mask
+				CheckAlign		R9								; (IN) pattern
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				R10, Q_PTR [ RSP ] [ 8 * 8 ]	; bitmap (fifth parameter)
+				XOR				EBX, EBX						; result bits for the current QWORD
+				XOR				ESI, ESI						; record index
+				XOR				EDI, EDI						; count of matches
+	IF __UseZ
+				VMOVDQA64		ZMM29, ZM_PTR [ R8 ]			; mask and pattern held for the pass
+				VMOVDQA64		ZMM28, ZM_PTR [ R9 ]
+	ENDIF
+@@next:			CMP				RSI, RDX
+				JAE				@@done
+				PREFETCHT0		B_PTR [ RCX ] [ 8 * 64 ]		; stream: fetch eight records ahead
+	IF __UseZ
+				Match512		ZM_PTR [ RCX ], ZMM29, ZMM28
+	ELSE
+				Match512		RCX, R8, R9
+	ENDIF
+				RCR				RBX, 1							; match flag in at the top
+				ADD				RCX, 64
+				INC				RSI
+				TEST			ESI, 63
+				JNZ				@@next
+				MOV				Q_PTR [ R10 ], RBX				; QWORD of results complete, store it
+				POPCNT			RAX, RBX
+				ADD				RDI, RAX
+				ADD				R10, 8
+				JMP				@@next
+@@done:			MOV				ECX, ESI
+				NEG				ECX
+				AND				ECX, 63							; 64 less records in the partial final QWORD
+				JZ				@F
+				SHR				RBX, CL							; move them down to start at bit 0
+				MOV				Q_PTR [ R10 ], RBX
+				POPCNT			RAX, RBX
+				ADD				RDI, RAX
+@@:				MOV				RAX, RDI
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		match_bits_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			match_any_n	-	select the records of an array of 512bit records matching any of several masked patterns
+;			Prototype:		u64 match_any_n( u64* records, u64 n, u64* masks, u64* patterns, u64 npat, u64* out_indices );
+;			records		-	Address of 64 byte aligned array of n 512 bit records (in RCX)
+;			n			-	Number of records (in RDX)
+;			masks		-	Address of 64 byte aligned array of npat 512 bit masks (in R8)
+;			patterns	-	Address of 64 byte aligned array of npat 512 bit patterns (in R9)
+;			npat		-	Number of mask / pattern pairs (on stack)
+;			out_indices	-	Address of room for n QWORDS, receives the index of each record for which ( record AND masks[j] )
+;								equals patterns[j] for any j, ascending (on stack)
+;			returns		-	number of matching records
+;			Note:	patterns are tried in order for each record, stopping at the first that matches
+
+				Stack_Entry		match_any_n, ui512
+				CheckAlign		RCX								; (IN) records
+				CheckAlign		R8								; (IN) masks
+				CheckAlign		R9								; (IN) patterns
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				MOV				RSI, Q_PTR [ RSP ] [ 9 * 8 ]	; npat (fifth parameter)
+				SHL				RSI, 6							; times 64: end offset of masks / patterns
+				MOV				RDI, Q_PTR [ RSP ] [ 10 * 8 ]	; out_indices (sixth parameter)
+				XOR				EBX, EBX						; record index
+				XOR				R12D, R12D						; count of matches
+@@next:			CMP				RBX, RDX
+				JAE				@@done
+				PREFETCHT0		B_PTR [ RCX ] [ 8 * 64 ]		; stream: fetch eight records ahead
+				XOR				R10D, R10D						; offset of mask / pattern pair
+				JMP				@@more
+@@pat:
+	IF __UseZ
+				VMOVDQA64		ZMM29, ZM_PTR [ R8 + R10 ]
+				Match512		ZM_PTR [ RCX ], ZMM29, <ZM_PTR [ R9 + R10 ]>
+	ELSE
+				Match512		RCX, <R8 + R10>, <R9 + R10>
+	ENDIF
+				JC				@@hit							; carry set: matched
+				ADD				R10, 64
+@@more:			CMP				R10, RSI
+				JB				@@pat							; falls through with carry clear: no pattern matched
+@@hit:			MOV				Q_PTR [ RDI ] [ R12 * 8 ], RBX	; store index, kept only if it matched
+				ADC				R12, 0
+				ADD				RCX, 64
+				INC				RBX
+				JMP				@@next
+@@done:			MOV				RAX, R12
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		match_any_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			popcnt_n	-	count the set bits of each of an array of 512bit records
+;			Prototype:		u64 popcnt_n( u16* counts, u64* records, u64 n );
+;			counts		-	Address of n WORDS, receives the set bit count of each record (in RCX)
+;			records		-	Address of 64 byte aligned array of n 512 bit records (in RDX)
+;			n			-	Number of records (in R8)
+;			returns		-	total number of set bits
+
+				Leaf_Entry		popcnt_n, ui512
+				CheckAlign		RDX								; (IN) records
+
+				XOR				EAX, EAX						; running total
+				XOR				R9D, R9D						; record index
+@@next:			CMP				R9, R8
+				JAE				@@done
+				PREFETCHT0		B_PTR [ RDX ] [ 8 * 64 ]		; stream: fetch eight records ahead
+	IF __UseZ
+				VPOPCNTQ		ZMM31, ZM_PTR [ RDX ]
+				HSum31			R10
+	ELSE
+				POPCNT			R10, Q_PTR [ RDX ] [ 0 * 8 ]
+				FOR				idx, < 1, 2, 3, 4, 5, 6, 7 >
+				POPCNT			R11, Q_PTR [ RDX ] [ idx * 8 ]
+				ADD				R10, R11
+				ENDM
+	ENDIF
+				MOV				W_PTR [ RCX ] [ R9 * 2 ], R10W
+				ADD				RAX, R10
+				ADD				RDX, 64
+				INC				R9
+				JMP				@@next
+@@done:			RET
+				Leaf_End		popcnt_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			tanimoto_u	-	Tanimoto (Jaccard) similarity of two 512bit values: popcount( a AND b ) / popcount( a OR b )
+;			Prototype:		u32 tanimoto_u( u64* a, u64* b );
+;			a			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			b			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	similarity in units of 2^-TanimotoShift, 1 SHL TanimotoShift if identical; two zero values score zero
+;			Note:	Z: both counts from one pass, the 'OR' count of each word shifted into the high DWORD before one horizontal add
+
+				Leaf_Entry		tanimoto_u, ui512
+				CheckAlign		RCX								; (IN) a
+				CheckAlign		RDX								; (IN) b
+
+	IF __UseZ
+				VMOVDQA64		ZMM30, ZM_PTR [ RCX ]
+				VPANDQ			ZMM31, ZMM30, ZM_PTR [ RDX ]
+				VPORQ			ZMM30, ZMM30, ZM_PTR [ RDX ]
+				VPOPCNTQ		ZMM31, ZMM31					; 'AND' count per word
+				VPOPCNTQ		ZMM30, ZMM30					; 'OR' count per word
+				VPSLLQ			ZMM30, ZMM30, 32
+				VPADDQ			ZMM31, ZMM31, ZMM30				; 'OR' count high DWORD, 'AND' count low
+				HSum31			RAX
+				MOV				R8, RAX
+				SHR				R8, 32							; 'OR' count
+				MOV				EAX, EAX						; 'AND' count
+	ELSE
+				XOR				EAX, EAX						; 'AND' count
+				XOR				R8D, R8D						; 'OR' count
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOV				R9, Q_PTR [ RCX ] [ idx * 8 ]
+				MOV				R10, R9
+				AND				R9, Q_PTR [ RDX ] [ idx * 8 ]
+				OR				R10, Q_PTR [ RDX ] [ idx * 8 ]
+				POPCNT			R9, R9
+				POPCNT			R10, R10
+				ADD				RAX, R9
+				ADD				R8, R10
+				ENDM
+	ENDIF
+				CMP				R8, 1
+				ADC				R8, 0							; both zero: divide zero by one
+				SHL				RAX, TanimotoShift
+				XOR				EDX, EDX
+				DIV				R8
+				RET
+				Leaf_End		tanimoto_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			tanimoto_topk_n	-	find the k records most similar (Tanimoto) to a query
+;			Prototype:		u64 tanimoto_topk_n( u64* results, u64 k, u64* query, u64* records, u16* counts, u64 n );
+;			results		-	Address of k QWORDS, receives best first: score (as tanimoto_u) in the high DWORD, record index in the low (in RCX)
+;			k			-	Number of results wanted (in RDX)
+;			query		-	Address of 64 byte aligned 512 bit query (in R8)
+;			records		-	Address of 64 byte aligned array of n 512 bit records (in R9)
+;			counts		-	Address of n WORDS, set bit count of each record, from popcnt_n (on stack)
+;			n			-	Number of records, less than 2^32 - 1 (on stack)
+;			returns		-	number of results, the lesser of k and n; equal scores are ordered by index
+;			Note:	results is a min-heap during the scan, of keys: score high, NOT index low, so that a better key is a larger one.
+;					Only the 'AND' count is needed per record, the 'OR' count being the sum of the counts less it, and a record
+;					whose best possible score (its count and the query's, the lesser over the greater) can't beat the heap root
+;					is skipped without being read. Heap is sorted in place at the end. Reentrant: a thread can scan a slice of
+;					the records into its own results, then the slices' results (indices offset by slice start) be merged.
+
+				Stack_Entry		tanimoto_topk_n, ui512
+				CheckAlign		R8								; (IN) query
+				CheckAlign		R9								; (IN) records
+
+				XOR				EAX, EAX
+				TEST			RDX, RDX
+				JNZ				@F
+				RET												; nothing wanted
+@@:				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				R12, RCX						; results: heap
+				MOV				R13, RDX						; k: heap size
+				MOV				RSI, R9							; record address
+				MOV				RDI, Q_PTR [ RSP ] [ 12 * 8 ]	; counts (fifth parameter, above saved regs, return address and home space)
+				MOV				R15, Q_PTR [ RSP ] [ 13 * 8 ]	; n (sixth parameter)
+				XOR				R14D, R14D						; record index
+				XOR				R9D, R9D						; threshold: score a record must reach to replace the heap root
+
+				XOR				ECX, ECX						; heap starts as k keys of zero, below any record
+@@fill:			MOV				Q_PTR [ R12 ] [ RCX * 8 ], R14
+				INC				RCX
+				CMP				RCX, R13
+				JB				@@fill
+
+	IF __UseZ
+				VMOVDQA64		ZMM29, ZM_PTR [ R8 ]			; query held for the scan
+				VPOPCNTQ		ZMM31, ZMM29
+				HSum31			RBX								; query count
+	ELSE
+				POPCNT			RBX, Q_PTR [ R8 ] [ 0 * 8 ]
+				FOR				idx, < 1, 2, 3, 4, 5, 6, 7 >
+				POPCNT			R10, Q_PTR [ R8 ] [ idx * 8 ]
+				ADD				RBX, R10
+				ENDM
+	ENDIF
+
+@@next:			CMP				R14, R15
+				JAE				@@sort
+				PREFETCHT0		B_PTR [ RSI ] [ 8 * 64 ]		; stream: fetch eight records ahead
+				MOVZX			R10D, W_PTR [ RDI ] [ R14 * 2 ]	; record count
+				MOV				R11, R10
+				CMP				R11, RBX
+				CMOVA			R11, RBX						; lesser count
+				MOV				RCX, R10
+				CMP				RCX, RBX
+				CMOVB			RCX, RBX						; greater count
+				SHL				R11, TanimotoShift
+				IMUL			RCX, R9
+				CMP				R11, RCX						; best possible score below threshold?
+				JB				@@skip							;	then no need to look at the record
+
+	IF __UseZ
+				VPANDQ			ZMM31, ZMM29, ZM_PTR [ RSI ]
+				VPOPCNTQ		ZMM31, ZMM31
+				HSum31			R11								; 'AND' count
+	ELSE
+				MOV				R11, Q_PTR [ R8 ] [ 0 * 8 ]
+				AND				R11, Q_PTR [ RSI ] [ 0 * 8 ]
+				POPCNT			R11, R11
+				FOR				idx, < 1, 2, 3, 4, 5, 6, 7 >
+				MOV				RAX, Q_PTR [ R8 ] [ idx * 8 ]
+				AND				RAX, Q_PTR [ RSI ] [ idx * 8 ]
+				POPCNT			RAX, RAX
+				ADD				R11, RAX
+				ENDM
+	ENDIF
+				LEA				RCX, [ RBX + R10 ]
+				SUB				RCX, R11						; 'OR' count
+				CMP				RCX, 1
+				ADC				RCX, 0							; both zero: divide zero by one
+				SHL				R11, TanimotoShift
+				MOV				RAX, RCX
+				IMUL			RAX, R9
+				CMP				R11, RAX						; score below threshold?
+				JB				@@skip
+
+				MOV				RAX, R11
+				XOR				EDX, EDX
+				DIV				RCX								; score
+				SHL				RAX, 32
+				MOV				EDX, R14D
+				NOT				EDX								; NOT index: lower index is the larger key
+				OR				RAX, RDX
+				HeapDown		R12, R13, RAX					; replaces the root
+				MOV				RAX, Q_PTR [ R12 ]				; new root
+				MOV				R9, RAX
+				SHR				R9, 32							; its score
+				CMP				EAX, 1
+				SBB				R9, -1							; plus one, unless the root is an initial zero key
+@@skip:			ADD				RSI, 64
+				INC				R14
+				JMP				@@next
+
+@@sort:			MOV				RBX, R13
+				CMP				RBX, R15
+				CMOVA			RBX, R15						; number of results
+@@pop:			DEC				R13								; heap sort: move root (least) to the end, sift the last key down from the root
+				JZ				@@out
+				MOV				RAX, Q_PTR [ R12 ] [ R13 * 8 ]
+				MOV				RDX, Q_PTR [ R12 ]
+				MOV				Q_PTR [ R12 ] [ R13 * 8 ], RDX
+				HeapDown		R12, R13, RAX
+				JMP				@@pop
+
+@@out:			XOR				ECX, ECX						; keys to results: score high, index low
+@@result:		CMP				RCX, RBX
+				JAE				@@done
+				MOV				RAX, Q_PTR [ R12 ] [ RCX * 8 ]
+				MOV				EDX, EAX
+				NOT				EDX
+				SHR				RAX, 32
+				SHL				RAX, 32
+				OR				RAX, RDX
+				MOV				Q_PTR [ R12 ] [ RCX * 8 ], RAX
+				INC				RCX
+				JMP				@@result
+@@done:			MOV				RAX, RBX
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+				Stack_End		tanimoto_topk_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			lcp_u		-	count the leading (most significant) bits two 512bit values have in common
+;			Prototype:		s16 lcp_u( u64* a, u64* b );
+;			a			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			b			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	0 to 512 inclusive, 512 if equal; 511 - lcp_u is msb_u of a 'XOR' b, the crit bit
+
+				Leaf_Entry		lcp_u, ui512
+				CheckAlign		RCX								; (IN) a
+				CheckAlign		RDX								; (IN) b
+
+				Lcp512			RCX, RDX
+				RET
+				Leaf_End		lcp_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			critbit_build_n	-	build a crit-bit tree over a sorted array of distinct 512bit keys
+;			Prototype:		u64 critbit_build_n( u64* nodes, u64* keys, u64 n );
+;			nodes		-	Address of 64 byte aligned room for n 64 byte lines (one if n is 1), receives the tree (in RCX)
+;			keys		-	Address of 64 byte aligned array of n 512 bit keys, ascending, no duplicates (in RDX)
+;			n			-	Number of keys, less than 2^31 (in R8)
+;			returns		-	number of lines used, at most n - 1 (one if n is 1)
+;			Note:	the crit bit of a run of sorted keys is the first bit where its first and last keys differ (lcp of the two),
+;					and the run splits at the first key with that bit set (binary search). Lines are filled in order; each
+;					line's key run is written to it (CBRange) when it is allocated, so no recursion or stack of runs is needed.
+
+				Leaf_Entry		critbit_build_n, ui512
+				CheckAlign		RCX								; (OUT) nodes
+				CheckAlign		RDX								; (IN) keys
+
+				XOR				EAX, EAX
+				TEST			R8, R8
+				JNZ				@F
+				RET												; no keys, no lines
+@@:				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				SUB				RSP, 16 * 8						; key runs of the 15 positions of a line: first low DWORD, last high
+				MOV				RSI, RCX						; nodes
+				MOV				RDI, RDX						; keys
+				LEA				RAX, [ R8 - 1 ]
+				SHL				RAX, 32
+				MOV				Q_PTR [ RSI ] [ CBRange ], RAX	; root line: all keys
+				XOR				R13D, R13D						; line being filled
+				LEA				R14, [ 1 ]						; next line to allocate
+
+@@line:			CMP				R13, R14
+				JAE				@@built
+				MOV				R15, R13
+				SHL				R15, 6
+				ADD				R15, RSI						; address of line
+				MOV				RAX, Q_PTR [ R15 ] [ CBRange ]
+				MOV				Q_PTR [ RSP ], RAX				; root slot: the line's run
+				XOR				EBX, EBX						; slot
+
+@@slot:			MOV				RAX, Q_PTR [ RSP ] [ RBX * 8 ]
+				MOV				R8D, EAX						; first key of run
+				MOV				R9, RAX
+				SHR				R9, 32							; last key of run
+				LEA				RCX, [ RBX * 2 + 1 ]			; left child position
+				CMP				R8, R9
+				JNE				@@split
+				MOV				W_PTR [ R15 ] [ RBX * 2 ], CBNone	; single key: no test, both children the same key
+				MOV				Q_PTR [ RSP ] [ RCX * 8 ], RAX
+				MOV				Q_PTR [ RSP ] [ RCX * 8 ] [ 8 ], RAX
+				JMP				@@nextslot
+
+@@split:		MOV				RDX, R8
+				SHL				RDX, 6
+				ADD				RDX, RDI
+				MOV				R10, R9
+				SHL				R10, 6
+				ADD				R10, RDI
+				Lcp512			RDX, R10						; crit bit of the run
+				MOV				W_PTR [ R15 ] [ RBX * 2 ], AX
+				MOV				R10, RAX
+				SHR				R10, 6
+				LEA				R10, [ RDI + R10 * 8 ]			; address of the word holding it, in key zero
+				NOT				EAX
+				AND				EAX, 63
+				MOV				R12, RAX						; bit within word
+				MOV				RDX, R8							; key known to have the bit clear
+				MOV				R11, R9							; key known to have the bit set
+@@search:		LEA				RCX, [ RDX + 1 ]
+				CMP				RCX, R11
+				JAE				@@searched
+				LEA				RCX, [ RDX + R11 ]
+				SHR				RCX, 1							; midpoint
+				MOV				RAX, RCX
+				SHL				RAX, 6
+				MOV				RAX, Q_PTR [ R10 + RAX ]
+				BT				RAX, R12
+				CMOVC			R11, RCX
+				CMOVNC			RDX, RCX
+				JMP				@@search
+@@searched:		LEA				RCX, [ RBX * 2 + 1 ]
+				LEA				RAX, [ R11 - 1 ]
+				SHL				RAX, 32
+				OR				RAX, R8
+				MOV				Q_PTR [ RSP ] [ RCX * 8 ], RAX	; left: first to before the split
+				MOV				RAX, R9
+				SHL				RAX, 32
+				OR				RAX, R11
+				MOV				Q_PTR [ RSP ] [ RCX * 8 ] [ 8 ], RAX	; right: split to last
+@@nextslot:		INC				EBX
+				CMP				EBX, 7
+				JB				@@slot
+
+				XOR				EBX, EBX						; the eight children of the bottom slots
+@@ref:			MOV				RAX, Q_PTR [ RSP ] [ RBX * 8 ] [ 7 * 8 ]
+				MOV				R8D, EAX
+				MOV				R9, RAX
+				SHR				R9, 32
+				CMP				R8, R9
+				JNE				@@child
+				BTS				R8D, CBLeaf						; single key: leaf
+				MOV				D_PTR [ R15 ] [ RBX * 4 ] [ CBRef ], R8D
+				JMP				@@nextref
+@@child:		MOV				D_PTR [ R15 ] [ RBX * 4 ] [ CBRef ], R14D	; more: allocate a line for them
+				MOV				RCX, R14
+				SHL				RCX, 6
+				MOV				Q_PTR [ RSI + RCX ] [ CBRange ], RAX
+				INC				R14
+@@nextref:		INC				EBX
+				CMP				EBX, 8
+				JB				@@ref
+				MOV				W_PTR [ R15 ] [ 7 * 2 ], 0
+				MOV				Q_PTR [ R15 ] [ 7 * 8 ], 0
+				INC				R13
+				JMP				@@line
+
+@@built:		MOV				RAX, R14
+				ADD				RSP, 16 * 8
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+				Leaf_End		critbit_build_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			critbit_lcp_n	-	find the key sharing the longest prefix with a query
+;			Prototype:		u64 critbit_lcp_n( u64* nodes, u64* query );
+;			nodes		-	Address of 64 byte aligned crit-bit tree from critbit_build_n, of one or more keys (in RCX)
+;			query		-	Address of 64 byte aligned 512 bit query (in RDX)
+;			returns		-	index of a key with the longest prefix in common with the query (lcp_u gives its length)
+;			Note:	descends testing only the crit bits, without comparing any key
+
+				Leaf_Entry		critbit_lcp_n, ui512
+				CheckAlign		RCX								; (IN) nodes
+				CheckAlign		RDX								; (IN) query
+
+				MOV				R9, RCX							; root line
+				XOR				R10D, R10D						; root slot
+				CBDescend		RCX, RDX, R9, R10, 10000h, R11, @@leaf
+@@leaf:			RET
+				Leaf_End		critbit_lcp_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			critbit_find_n	-	find the key equal to a query
+;			Prototype:		u64 critbit_find_n( u64* nodes, u64* keys, u64* query );
+;			nodes		-	Address of 64 byte aligned crit-bit tree from critbit_build_n, of one or more keys (in RCX)
+;			keys		-	Address of 64 byte aligned array of the keys the tree was built from (in RDX)
+;			query		-	Address of 64 byte aligned 512 bit query (in R8)
+;			returns		-	index of the key, or -1 (all ones) if none is equal
+
+				Leaf_Entry		critbit_find_n, ui512
+				CheckAlign		RCX								; (IN) nodes
+				CheckAlign		RDX								; (IN) keys
+				CheckAlign		R8								; (IN) query
+
+				MOV				R9, RCX
+				XOR				R10D, R10D
+				CBDescend		RCX, R8, R9, R10, 10000h, R11, @@leaf
+@@leaf:			MOV				R9, RAX
+				SHL				RAX, 6
+				LEA				R10, [ RDX + RAX ]				; the one key that can be equal
+				Lcp512			R8, R10
+				CMP				EAX, 512
+				MOV				RAX, R9
+				JE				@F
+				LEA				RAX, [ retcode_neg_one ]
+@@:				RET
+				Leaf_End		critbit_find_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			critbit_lower_n	-	find the first key not less than a query
+;			Prototype:		u64 critbit_lower_n( u64* nodes, u64* keys, u64* query );
+;			nodes		-	Address of 64 byte aligned crit-bit tree from critbit_build_n, of one or more keys (in RCX)
+;			keys		-	Address of 64 byte aligned array of the keys the tree was built from (in RDX)
+;			query		-	Address of 64 byte aligned 512 bit query (in R8)
+;			returns		-	index of the key, n if the query is above all keys. Keys from critbit_lower_n( a ) to before
+;							critbit_lower_n( b ) are those from a up to, not including, b.
+;			Note:	the key reached by following the query's bits shares d, the longest prefix, with it. All keys with that
+;					prefix are below the first slot testing position d or beyond, and differ from the query at d the same way,
+;					so the answer is the first key below that slot, or the one after the last.
+
+				Leaf_Entry		critbit_lower_n, ui512
+				CheckAlign		RCX								; (IN) nodes
+				CheckAlign		RDX								; (IN) keys
+				CheckAlign		R8								; (IN) query
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				MOV				R9, RCX
+				XOR				R10D, R10D
+				CBDescend		RCX, R8, R9, R10, 10000h, R11, @@leaf
+@@leaf:			MOV				RSI, RAX
+				SHL				RAX, 6
+				LEA				R9, [ RDX + RAX ]
+				Lcp512			R8, R9							; d
+				CMP				EAX, 512
+				JNE				@F
+				MOV				RAX, RSI						; equal
+				JMP				@@done
+@@:				MOV				RBX, RAX
+				MOV				RSI, RAX
+				CBBit			R8, RSI, R11					; query bit at d: set, query above the keys with the prefix
+				MOV				R9, RCX
+				XOR				R10D, R10D
+				CBDescend		RCX, R8, R9, R10, RBX, R11, @@found
+				CBEdge			RCX, R9, R10, RSI, R11, @@found
+@@found:		ADD				RAX, RSI						; first with the prefix, or one after the last
+@@done:			POP				RSI
+				POP				RBX
+				RET
+				Leaf_End		critbit_lower_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			critbit_prefix_n	-	find the keys sharing a prefix with a query
+;			Prototype:		u64 critbit_prefix_n( u64* nodes, u64* keys, u64* query, u16 plen, u64* first );
+;			nodes		-	Address of 64 byte aligned crit-bit tree from critbit_build_n, of one or more keys (in RCX)
+;			keys		-	Address of 64 byte aligned array of the keys the tree was built from (in RDX)
+;			query		-	Address of 64 byte aligned 512 bit query (in R8)
+;			plen		-	Prefix length, most significant bits of the query, 0 to 512 (in R9W)
+;			first		-	Address of a QWORD, receives the index of the first key with the prefix, if any (on stack)
+;			returns		-	number of keys with the prefix, their indices running from first
+
+				Stack_Entry		critbit_prefix_n, ui512
+				CheckAlign		RCX								; (IN) nodes
+				CheckAlign		RDX								; (IN) keys
+				CheckAlign		R8								; (IN) query
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOVZX			EBX, R9W
+				MOV				EAX, 512
+				CMP				EBX, EAX
+				CMOVA			EBX, EAX						; plen
+				MOV				R9, RCX
+				XOR				R10D, R10D
+				CBDescend		RCX, R8, R9, R10, 10000h, R11, @@leaf
+@@leaf:			MOV				RSI, RAX
+				SHL				RAX, 6
+				LEA				R9, [ RDX + RAX ]
+				Lcp512			R8, R9							; longest prefix of any key
+				CMP				RAX, RBX
+				JAE				@F
+				XOR				EAX, EAX						; shorter than plen: none
+				JMP				@@done
+@@:				MOV				R9, RCX
+				XOR				R10D, R10D
+				CBDescend		RCX, R8, R9, R10, RBX, R11, @@single
+				MOV				RSI, R9							; slot below which are all keys with the prefix
+				MOV				RDI, R10
+				CBEdge			RCX, R9, R10, 0, R11, @@first
+@@first:		MOV				R8, RAX
+				MOV				R9, RSI
+				MOV				R10, RDI
+				CBEdge			RCX, R9, R10, 1, R11, @@last
+@@single:		MOV				R8, RAX							; leaf above any slot testing plen or beyond: the one key
+@@last:			MOV				RCX, Q_PTR [ RSP ] [ 8 * 8 ]	; first (fifth parameter, above saved regs, return address and home space)
+				MOV				Q_PTR [ RCX ], R8
+				SUB				RAX, R8
+				INC				RAX
+@@done:			POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+				Stack_End		critbit_prefix_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			radix_sort_n	-	sort an array of 512bit keys ascending (as compare_u), stable, in place
+;			Prototype:		u64 radix_sort_n( u64* keys, u64 n, u64* temp, u64* work );
+;			keys		-	Address of 64 byte aligned array of n 512 bit keys, sorted in place (in RCX)
+;			n			-	Number of keys, less than 2^32 (in RDX)
+;			temp		-	Address of 64 byte aligned room for n keys and n QWORDS (9 * n QWORDS), overwritten (in R8)
+;			work		-	Address of 64 byte aligned work area of RadixWork bytes (in R9)
+;			returns		-	number of words sorted on (0 if all keys are equal)
+;			Note:	the keys are put in order as (word, index) pairs, a word at a time, most significant first (RadixOrder):
+;					random keys take one word, eleven bits a pass (fewer where bits are the same in every key). The keys are
+;					then gathered in order into temp, and copied back.
+
+				Leaf_Entry		radix_sort_n, ui512
+				CheckAlign		RCX								; (IN/OUT) keys
+				CheckAlign		R8								; (OUT) temp
+				CheckAlign		R9								; (OUT) work
+
+				XOR				EAX, EAX
+				TEST			RDX, RDX
+				JNZ				@F
+				RetV												; no keys
+@@:				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RCX						; keys
+				MOV				RDI, RDX						; n
+				MOV				R12, R8							; pairs
+				MOV				RBX, R9							; work
+				RadixOrder
+				TEST			RAX, RAX
+				JZ				@F								; all keys equal
+				RadixMove
+				MOV				RAX, Q_PTR [ RBX ] [ RadixLevels ]
+@@:				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Leaf_End		radix_sort_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			radix_sort_kv_n	-	sort an array of 512bit keys ascending, stable, in place, with a QWORD value moving with each key
+;			Prototype:		u64 radix_sort_kv_n( u64* keys, u64* values, u64 n, u64* temp, u64* work );
+;			keys		-	Address of 64 byte aligned array of n 512 bit keys, sorted in place (in RCX)
+;			values		-	Address of array of n QWORDS, reordered with the keys (in RDX)
+;			n			-	Number of keys, less than 2^32 (in R8)
+;			temp		-	Address of 64 byte aligned room for n keys and n QWORDS (9 * n QWORDS), overwritten (in R9)
+;			work		-	Address of 64 byte aligned work area of RadixWork bytes (on stack)
+;			returns		-	number of words sorted on, as radix_sort_n
+
+				Stack_Entry		radix_sort_kv_n, ui512
+				CheckAlign		RCX								; (IN/OUT) keys
+				CheckAlign		R9								; (OUT) temp
+
+				XOR				EAX, EAX
+				TEST			R8, R8
+				JNZ				@F
+				RetV												; no keys
+@@:				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RCX						; keys
+				MOV				RDI, R8							; n
+				MOV				R12, R9							; pairs
+				MOV				RBX, Q_PTR [ RSP ] [ 12 * 8 ]	; work (fifth parameter, above saved regs, return address and home space)
+				CheckAlign		RBX								; (OUT) work
+				MOV				Q_PTR [ RBX ] [ RadixValues ], RDX
+				RadixOrder
+				TEST			RAX, RAX
+				JZ				@F								; all keys equal
+				MOV				R13, Q_PTR [ RBX ] [ RadixValues ]	; values
+				RadixMove		R13
+				MOV				RAX, Q_PTR [ RBX ] [ RadixLevels ]
+@@:				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		radix_sort_kv_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			radix_index_n	-	sort the indices of an array of 512bit keys by key (ascending, stable), leaving the keys in place
+;			Prototype:		u64 radix_index_n( u64* index, u64* keys, u64 n, u64* temp, u64* work );
+;			index		-	Address of array of n QWORDS, receives the key indices in key order (in RCX)
+;			keys		-	Address of 64 byte aligned array of n 512 bit keys (in RDX)
+;			n			-	Number of keys, less than 2^32 (in R8)
+;			temp		-	Address of room for 4 * n QWORDS, overwritten (in R9)
+;			work		-	Address of 64 byte aligned work area of RadixWork bytes (on stack)
+;			returns		-	number of words sorted on, as radix_sort_n
+
+				Stack_Entry		radix_index_n, ui512
+				CheckAlign		RDX								; (IN) keys
+
+				XOR				EAX, EAX
+				TEST			R8, R8
+				JNZ				@F
+				RetV												; no keys
+@@:				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RDX						; keys
+				MOV				RDI, R8							; n
+				MOV				R12, R9							; pairs
+				MOV				RBX, Q_PTR [ RSP ] [ 12 * 8 ]	; work (fifth parameter, above saved regs, return address and home space)
+				CheckAlign		RBX								; (OUT) work
+				MOV				Q_PTR [ RBX ] [ RadixValues ], RCX
+				RadixOrder
+				MOV				RCX, Q_PTR [ RBX ] [ RadixValues ]	; index
+				MOV				R8, R12
+				XOR				EDX, EDX
+@@:				MOV				R9D, D_PTR [ R8 ] [ 8 ]			; key index of the pair
+				MOV				Q_PTR [ RCX + RDX * 8 ], R9
+				ADD				R8, 16
+				INC				RDX
+				CMP				RDX, RDI
+				JB				@B
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		radix_index_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			hash_u		-	hash a 512bit key to a QWORD
+;			Prototype:		u64 hash_u( u64* key );
+;			key			-	Address of 64 byte aligned 512 bit key (in RCX)
+;			returns		-	the hash
+;			Note:	multiply-fold (Hash512): each lane, the key word XOR a secret, its low half times its high half, plus the
+;					other word of its pair; the pairs (XOR fold constants) multiplied to 128 bits, halves XORd, summed, then
+;					avalanched. Z: one pass over the key in a ZMM reg, four 64 bit multiplies.
+
+				Leaf_Entry		hash_u, ui512
+				CheckAlign		RCX								; (IN) key
+
+				MOV				R8, RCX
+				Hash512			R8
+				RetV
+				Leaf_End		hash_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			hset_find_u	-	find a 512bit key in an open addressing hash set
+;			Prototype:		u64 hset_find_u( u8* tags, u64* slots, u64 capacity, u64* key );
+;			tags		-	Address of 64 byte aligned array of capacity tag bytes, zero for an empty slot (in RCX)
+;			slots		-	Address of 64 byte aligned array of capacity 512 bit slots (in RDX)
+;			capacity	-	Number of slots, a power of two, 64 or more (in R8)
+;			key			-	Address of 64 byte aligned 512 bit key (in R9)
+;			returns		-	slot index of the key, or -1 (all ones) if it is not in the set
+;			Note:	the tags of a group of 64 slots are one line: one compare of the line against the tag gives the candidates,
+;					each a full key compare (Z: VPCMPEQQ, KORTEST); a group with an empty slot ends the probe (HashFind)
+
+				Leaf_Entry		hset_find_u, ui512
+				CheckAlign		RCX								; (IN) tags
+				CheckAlign		RDX								; (IN) slots
+				CheckAlign		R9								; (IN) key
+
+				PUSH			RSI								; non-volatile, need the regs, so save the values
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RCX						; tags
+				MOV				RDI, RDX						; slots
+				MOV				R12, R8
+				SHR				R12, 6
+				DEC				R12								; group mask
+				MOV				R13, R9							; key
+				Hash512			R13
+				MOV				R14, RAX
+				HashFind		@@found, @@absent
+@@absent:		LEA				RAX, [ retcode_neg_one ]
+@@found:		POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				RetV
+				Leaf_End		hset_find_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			hset_insert_u	-	add a 512bit key to an open addressing hash set, if not there
+;			Prototype:		u64 hset_insert_u( u8* tags, u64* slots, u64 capacity, u64* key );
+;			tags		-	Address of 64 byte aligned array of capacity tag bytes, zero for an empty slot (in RCX)
+;			slots		-	Address of 64 byte aligned array of capacity 512 bit slots (in RDX)
+;			capacity	-	Number of slots, a power of two, 64 or more (in R8)
+;			key			-	Address of 64 byte aligned 512 bit key (in R9)
+;			returns		-	slot index of the key, with bit HSetNew (63) set if added by this call; -1 (all ones) if the key
+;							is not in the set and the set is full
+
+				Leaf_Entry		hset_insert_u, ui512
+				CheckAlign		RCX								; (IN/OUT) tags
+				CheckAlign		RDX								; (IN/OUT) slots
+				CheckAlign		R9								; (IN) key
+
+				PUSH			RSI								; non-volatile, need the regs, so save the values
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RCX						; tags
+				MOV				RDI, RDX						; slots
+				MOV				R12, R8
+				SHR				R12, 6
+				DEC				R12								; group mask
+				MOV				R13, R9							; key
+				Hash512			R13
+				MOV				R14, RAX
+				HashFind		@@found, @@absent
+@@absent:		CMP				RAX, -1
+				JE				@@found							; full
+				HashPlace
+@@found:		POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				RetV
+				Leaf_End		hset_insert_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			hset_find_n	-	find an array of 512bit keys in an open addressing hash set
+;			Prototype:		u64 hset_find_n( u8* tags, u64* slots, u64 capacity, u64* keys, u64 n, u64* results );
+;			tags		-	Address of 64 byte aligned array of capacity tag bytes, zero for an empty slot (in RCX)
+;			slots		-	Address of 64 byte aligned array of capacity 512 bit slots (in RDX)
+;			capacity	-	Number of slots, a power of two, 64 or more (in R8)
+;			keys		-	Address of 64 byte aligned array of n 512 bit keys (in R9)
+;			n			-	Number of keys (on stack)
+;			results		-	Address of array of n QWORDS, receives the slot index of each key, or -1 (on stack)
+;			returns		-	number of keys found
+;			Note:	hashes all keys to results first, then probes in order (HashBatch): the tag line for the key 2 * HSetAhead
+;					on is prefetched, and for the key HSetAhead on, the slot of its first candidate (or empty slot)
+
+				Stack_Entry		hset_find_n, ui512
+				CheckAlign		RCX								; (IN) tags
+				CheckAlign		RDX								; (IN) slots
+				CheckAlign		R9								; (IN) keys
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RBP
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RCX						; tags
+				MOV				RDI, RDX						; slots
+				MOV				R12, R8
+				SHR				R12, 6
+				DEC				R12								; group mask
+				MOV				RBX, R9							; keys
+				HashBatch		13 * 8, 12 * 8					; n, results (fifth, sixth parameters), count in the R9 home space
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBP
+				POP				RBX
+				RetV
+				Stack_End		hset_find_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			hset_insert_n	-	add an array of 512bit keys to an open addressing hash set, those not there
+;			Prototype:		u64 hset_insert_n( u8* tags, u64* slots, u64 capacity, u64* keys, u64 n, u64* results );
+;			tags		-	Address of 64 byte aligned array of capacity tag bytes, zero for an empty slot (in RCX)
+;			slots		-	Address of 64 byte aligned array of capacity 512 bit slots (in RDX)
+;			capacity	-	Number of slots, a power of two, 64 or more (in R8)
+;			keys		-	Address of 64 byte aligned array of n 512 bit keys (in R9)
+;			n			-	Number of keys (on stack)
+;			results		-	Address of array of n QWORDS, receives the slot index of each key as hset_insert_u (on stack)
+;			returns		-	number of keys added
+;			Note:	as hset_find_n; a key repeated in the array is added once, later copies find it
+
+				Stack_Entry		hset_insert_n, ui512
+				CheckAlign		RCX								; (IN/OUT) tags
+				CheckAlign		RDX								; (IN/OUT) slots
+				CheckAlign		R9								; (IN) keys
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RBP
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RSI, RCX						; tags
+				MOV				RDI, RDX						; slots
+				MOV				R12, R8
+				SHR				R12, 6
+				DEC				R12								; group mask
+				MOV				RBX, R9							; keys
+				HashBatch		13 * 8, 12 * 8, place			; n, results (fifth, sixth parameters), count in the R9 home space
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBP
+				POP				RBX
+				RetV
+				Stack_End		hset_insert_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			clmul_u		-	carry-less (GF(2) polynomial) product of two 512bit values
+;			Prototype:		void clmul_u( u64* dest_hi, u64* dest_lo, u64* a, u64* b );
+;			dest_hi		-	Address of 64 byte aligned 512 bits, receives product bits 1023 to 512 (in RCX)
+;			dest_lo		-	Address of 64 byte aligned 512 bits, receives product bits 511 to 0 (in RDX)
+;			a			-	Address of 64 byte aligned 512 bit polynomial, bit i the coefficient of x^i (in R8)
+;			b			-	Address of 64 byte aligned 512 bit polynomial (in R9)
+;			returns		-	nothing (0)
+;			Note:	either destination may be a or b. Z: sixteen VPCLMULQDQ, four products each; otherwise 48 PCLMULQDQ,
+;					Karatsuba on 128 bit digits (ClMul512)
+
+				Leaf_Entry		clmul_u, ui512
+				CheckAlign		RCX								; (OUT) dest_hi
+				CheckAlign		RDX								; (OUT) dest_lo
+				CheckAlign		R8								; (IN) a
+				CheckAlign		R9								; (IN) b
+
+	IF __UseZ
+				ClMul512		RCX, RDX, R8, R9
+	ELSE
+				SUB				RSP, 256 + 8					; scratch, 16 byte aligned
+				ClMul512		RCX, RDX, R8, R9, RSP
+				ADD				RSP, 256 + 8
+	ENDIF
+				RET
+				Leaf_End		clmul_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			clmod_mu_u	-	Barrett constant for carry-less reduction modulo x^512 + poly
+;			Prototype:		void clmod_mu_u( u64* mu, u64* poly );
+;			mu			-	Address of 64 byte aligned 512 bits, receives bits 511 to 0 of the quotient x^1024 / ( x^512 + poly )
+;							(bit 512 is implicit) (in RCX)
+;			poly		-	Address of 64 byte aligned 512 bit polynomial, the modulus less its x^512 term (in RDX)
+;			returns		-	nothing (0)
+;			Note:	long division, a quotient bit a step: 512 steps of shift and conditional XOR, in general regs on every path.
+;					Once per modulus.
+
+				Leaf_Entry		clmod_mu_u, ui512
+				CheckAlign		RCX								; (OUT) mu
+				CheckAlign		RDX								; (IN) poly
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RBP
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				R8, RCX
+				MOV				RBP, Q_PTR [ RDX ] [ 0 * 8 ]	; remainder, most significant word in RBP: after the first quotient
+				MOV				RBX, Q_PTR [ RDX ] [ 1 * 8 ]	;	bit (x^512), x^1024 less x^512 times the modulus is poly * x^512
+				MOV				RSI, Q_PTR [ RDX ] [ 2 * 8 ]
+				MOV				RDI, Q_PTR [ RDX ] [ 3 * 8 ]
+				MOV				R12, Q_PTR [ RDX ] [ 4 * 8 ]
+				MOV				R13, Q_PTR [ RDX ] [ 5 * 8 ]
+				MOV				R14, Q_PTR [ RDX ] [ 6 * 8 ]
+				MOV				R15, Q_PTR [ RDX ] [ 7 * 8 ]
+				XOR				R9D, R9D						; word of mu
+@@word:			MOV				R10D, 64
+@@bit:			SHL				R15, 1							; next power down: remainder shifted left, top bit out
+				RCL				R14, 1
+				RCL				R13, 1
+				RCL				R12, 1
+				RCL				RDI, 1
+				RCL				RSI, 1
+				RCL				RBX, 1
+				RCL				RBP, 1
+				SBB				R11, R11						; all ones if it was set (carry unchanged)
+				RCL				RAX, 1							; it is the quotient bit
+				MOV				RCX, Q_PTR [ RDX ] [ 0 * 8 ]	; if set, subtract the modulus: XOR poly
+				AND				RCX, R11
+				XOR				RBP, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 1 * 8 ]
+				AND				RCX, R11
+				XOR				RBX, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 2 * 8 ]
+				AND				RCX, R11
+				XOR				RSI, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 3 * 8 ]
+				AND				RCX, R11
+				XOR				RDI, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 4 * 8 ]
+				AND				RCX, R11
+				XOR				R12, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 5 * 8 ]
+				AND				RCX, R11
+				XOR				R13, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 6 * 8 ]
+				AND				RCX, R11
+				XOR				R14, RCX
+				MOV				RCX, Q_PTR [ RDX ] [ 7 * 8 ]
+				AND				RCX, R11
+				XOR				R15, RCX
+				DEC				R10D
+				JNZ				@@bit
+				MOV				Q_PTR [ R8 + R9 * 8 ], RAX		; 64 quotient bits, most significant first
+				INC				R9D
+				CMP				R9D, 8
+				JB				@@word
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBP
+				POP				RBX
+				RET
+				Leaf_End		clmod_mu_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			clmod_u		-	reduce a 1024 bit carry-less product modulo x^512 + poly
+;			Prototype:		void clmod_u( u64* destination, u64* hi, u64* lo, u64* poly, u64* mu );
+;			destination	-	Address of 64 byte aligned 512 bits, receives ( hi * x^512 + lo ) mod ( x^512 + poly ) (in RCX)
+;			hi			-	Address of 64 byte aligned 512 bits, coefficients of x^1023 to x^512 (in RDX)
+;			lo			-	Address of 64 byte aligned 512 bits, coefficients of x^511 to x^0 (in R8)
+;			poly		-	Address of 64 byte aligned 512 bit polynomial, the modulus less its x^512 term (in R9)
+;			mu			-	Address of 64 byte aligned 512 bits, from clmod_mu_u for poly (on stack)
+;			returns		-	nothing (0)
+;			Note:	Barrett: quotient q = hi XOR high half of ( hi * mu ), remainder lo XOR low half of ( q * poly ); two
+;					clmul_u products. destination may be any of the others
+
+				Stack_Entry		clmod_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN) hi
+				CheckAlign		R8								; (IN) lo
+				CheckAlign		R9								; (IN) poly
+
+				PUSH			RBP								; non-volatile, need the reg, so save the value
+				MOV				RBP, RSP
+				MOV				RAX, Q_PTR [ RBP ] [ 6 * 8 ]	; mu (fifth parameter, above saved reg, return address and home space)
+				CheckAlign		RAX								; (IN) mu
+				SUB				RSP, 512
+				AND				RSP, -64						; scratch, then product of hi and mu, then of q and poly
+				LEA				R10, [ RSP + 256 ]
+				LEA				R11, [ RSP + 320 ]
+				ClMul512		R10, R11, RDX, RAX, RSP
+				Xor512			R10, R10, RDX					; q
+				LEA				R11, [ RSP + 384 ]
+				LEA				RDX, [ RSP + 448 ]
+				ClMul512		R11, RDX, R10, R9, RSP
+				Xor512			RCX, R8, RDX					; remainder
+				MOV				RSP, RBP
+				POP				RBP
+				RetV
+				Stack_End		clmod_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bitmat_transpose_n	-	transpose a 512 x 512 bit matrix over GF(2)
+;			Prototype:		void bitmat_transpose_n( u64* destination, u64* source );
+;			destination	-	Address of 64 byte aligned 512 rows of 512 bits, receives bit j of source row i as bit i of row j (in RCX)
+;			source		-	Address of 64 byte aligned 512 rows of 512 bits (in RDX), may be the destination
+;			returns		-	nothing (0)
+;			Note:	the matrix is 64 x 64 bit blocks, a word of 64 rows. Each block is transposed by six rounds of swapping
+;					halves of its quarters (BitSwap), the same word of each row at once, a row at a time; eight rows are held
+;					for three rounds (BitTr8). Then the blocks are moved across the diagonal (BitPlace).
+
+				Leaf_Entry		bitmat_transpose_n, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN) source
+
+				PUSH			RSI								; non-volatile, need the regs, so save the values
+				PUSH			RDI
+				MOV				RSI, RCX
+				CMP				RCX, RDX
+				JE				@@inplace
+				MOV				R8, RCX
+				MOV				R9D, 512
+@@copy:			Copy512			R8, RDX
+				ADD				R8, 64
+				ADD				RDX, 64
+				DEC				R9D
+				JNZ				@@copy
+@@inplace:
+	IF __UseZ
+				VPBROADCASTQ	ZMM26, Q_PTR BitMasks				; masks for the shifts 32, 16, 8, 4, 2, 1
+				VPBROADCASTQ	ZMM27, Q_PTR BitMasks [ 8 ]
+				VPBROADCASTQ	ZMM28, Q_PTR BitMasks [ 16 ]
+				VPBROADCASTQ	ZMM29, Q_PTR BitMasks [ 24 ]
+				VPBROADCASTQ	ZMM30, Q_PTR BitMasks [ 32 ]
+				VPBROADCASTQ	ZMM31, Q_PTR BitMasks [ 40 ]
+	ENDIF
+				MOV				RDI, RSI						; block row: 64 rows
+				MOV				R10D, 8
+@@block:		XOR				R8D, R8D						; rows t, t + 8, .. t + 56: rounds 32, 16, 8
+@@far:			MOV				R9, R8
+				SHL				R9, 6
+				ADD				R9, RDI
+	IF __UseZ
+				BitTr8			R9, 8 * 64, 32, 16, 8, ZMM26, ZMM27, ZMM28
+	ELSE
+				BitTr8			R9, 8 * 64, 32, 16, 8, BitMasks, BitMasks [ 8 ], BitMasks [ 16 ]
+	ENDIF
+				INC				R8D
+				CMP				R8D, 8
+				JB				@@far
+				XOR				R8D, R8D						; rows 8g to 8g + 7: rounds 4, 2, 1
+@@near:			MOV				R9, R8
+				SHL				R9, 9
+				ADD				R9, RDI
+	IF __UseZ
+				BitTr8			R9, 64, 4, 2, 1, ZMM29, ZMM30, ZMM31
+	ELSE
+				BitTr8			R9, 64, 4, 2, 1, BitMasks [ 24 ], BitMasks [ 32 ], BitMasks [ 40 ]
+	ENDIF
+				INC				R8D
+				CMP				R8D, 8
+				JB				@@near
+				ADD				RDI, 64 * 64
+				DEC				R10D
+				JNZ				@@block
+
+				XOR				R8D, R8D						; row c of each block row
+@@place:		MOV				R9, R8
+				SHL				R9, 6
+				ADD				R9, RSI
+				BitPlace		R9
+				INC				R8D
+				CMP				R8D, 64
+				JB				@@place
+				POP				RDI
+				POP				RSI
+				RetV
+				Leaf_End		bitmat_transpose_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bitmat_vec_u	-	multiply a 512 bit row vector by a 512 x 512 bit matrix over GF(2)
+;			Prototype:		void bitmat_vec_u( u64* destination, u64* vector, u64* matrix );
+;			destination	-	Address of 64 byte aligned 512 bits, receives the XOR of the rows i of matrix for the bits i set in vector (in RCX)
+;			vector		-	Address of 64 byte aligned 512 bits (in RDX), may be the destination
+;			matrix		-	Address of 64 byte aligned 512 rows of 512 bits (in R8), row i of which for bit i of vector
+;			returns		-	nothing (0)
+
+				Leaf_Entry		bitmat_vec_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN) vector
+				CheckAlign		R8								; (IN) matrix
+
+				SUB				RSP, 64							; copy of vector, the destination may be it
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOV				RAX, Q_PTR [ RDX ] [ idx * 8 ]
+				MOV				Q_PTR [ RSP ] [ idx * 8 ], RAX
+				ENDM
+				RowZero			RCX
+				MOV				R9D, 7							; word of vector: bits 0 to 63 are word 7
+				MOV				R10, R8							; its 64 rows of matrix
+@@word:			MOV				RAX, Q_PTR [ RSP + R9 * 8 ]
+				JMP				@@test
+@@bit:			BSF				RDX, RAX
+				LEA				R11, [ RAX - 1 ]
+				AND				RAX, R11						; clear lowest set bit
+				SHL				EDX, 6
+				ADD				RDX, R10
+				RowXor			RDX, RCX
+@@test:			TEST			RAX, RAX
+				JNZ				@@bit
+				ADD				R10, 64 * 64
+				DEC				R9
+				JNS				@@word
+				RowStore		RCX
+				ADD				RSP, 64
+				RetV
+				Leaf_End		bitmat_vec_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			bitmat_mul_n	-	multiply an n x 512 bit matrix by a 512 x 512 bit matrix over GF(2), by the method of Four Russians
+;			Prototype:		void bitmat_mul_n( u64* c, u64* a, u64 n, u64* b, u64* work );
+;			c			-	Address of 64 byte aligned n rows of 512 bits, receives row i of a times b (bitmat_vec_u) (in RCX)
+;			a			-	Address of 64 byte aligned n rows of 512 bits (in RDX), may not overlap c
+;			n			-	Number of rows (in R8)
+;			b			-	Address of 64 byte aligned 512 rows of 512 bits (in R9)
+;			work		-	Address of 64 byte aligned BitMatWork (131072) bytes (on stack)
+;			returns		-	nothing (0)
+;			Note:	eight passes, one for each 64 rows of b. Each builds a table of the 256 XOR combinations of each 8 of those rows,
+;					then each row of c takes one entry of each of the 8 tables, per byte of that word of its row of a; 8 row XORs
+;					per row per pass, not 64. Rows whose word is zero are skipped.
+
+				Stack_Entry		bitmat_mul_n, ui512
+				CheckAlign		RCX								; (OUT) c
+				CheckAlign		RDX								; (IN) a
+				CheckAlign		R9								; (IN) b
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				MOV				RBX, RCX
+				MOV				RSI, RDX
+				MOV				RDI, R8
+				MOV				R12, R9
+				MOV				R13, Q_PTR [ RSP ] [ 12 * 8 ]	; work (fifth parameter, above saved regs, return address and home space)
+				CheckAlign		R13								; (IN) work
+				XOR				R14D, R14D						; pass: rows 64p of b, word 7 - p of the rows of a
+
+@@pass:			MOV				R15, R13						; table of each 8 rows
+				MOV				R10, R14
+				SHL				R10, 12
+				ADD				R10, R12
+@@table:		RowZero			R15
+				RowStore		R15
+				MOV				R9D, 64							; entries with a lower bit set, bytes: the next 2^b are these with bit b
+@@tbit:			XOR				R8D, R8D
+@@entry:		LEA				RAX, [ R15 + R8 ]
+				LEA				RDX, [ RAX + R9 ]
+				RowLoad			RAX, RDX
+				RowXor			R10, RDX
+				RowStore		RDX
+				ADD				R8, 64
+				CMP				R8, R9
+				JB				@@entry
+				ADD				R10, 64
+				SHL				R9D, 1
+				CMP				R9D, BitMatTable
+				JB				@@tbit
+				ADD				R15, BitMatTable
+				LEA				RAX, [ R13 + BitMatWork ]
+				CMP				R15, RAX
+				JB				@@table
+
+				MOV				R15, RBX
+				MOV				R8, RSI
+				MOV				R9, RDI
+				MOV				R10D, 7
+				SUB				R10, R14
+				TEST			R9, R9
+				JZ				@@next
+@@row:			MOV				RAX, Q_PTR [ R8 + R10 * 8 ]
+				TEST			R14, R14
+				JZ				@@first
+				TEST			RAX, RAX
+				JZ				@@skip
+				RowLoad			R15, R15
+				JMP				@@bytes
+@@first:		RowZero			R15
+@@bytes:
+				FOR				kx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOVZX			ECX, AL
+				SHR				RAX, 8
+				SHL				ECX, 6
+				RowXor			R13 + RCX + kx * BitMatTable, R15
+				ENDM
+				RowStore		R15
+@@skip:			ADD				R15, 64
+				ADD				R8, 64
+				DEC				R9
+				JNZ				@@row
+@@next:			INC				R14D
+				CMP				R14D, 8
+				JB				@@pass
+
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		bitmat_mul_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			pack_u		-	pack n values of k bits each into 512 bit blocks
+;			Prototype:		u64 pack_u( u64* dest_blocks, u64* values, u64 n, u64 k );
+;			dest_blocks	-	Address of 64 byte aligned blocks (in RCX), 512 / k values to a block, value i at bit ( i mod per ) * k of
+;							block i / per (bit 0 the least significant of word 7); unused high bits zero
+;			values		-	Address of n u64 values (in RDX), truncated to k bits
+;			n			-	Number of values (in R8)
+;			k			-	Field width, 1 to 64 (in R9)
+;			returns		-	number of blocks written, 0 if k is not 1 to 64
+;			Note:	the fields of each word are built in a register, the high part of one crossing into the next word carried over
+
+				Stack_Entry		pack_u, ui512
+				CheckAlign		RCX								; (OUT) dest_blocks
+				LEA				RAX, [ R9 - 1 ]
+				CMP				RAX, 63
+				JA				@@badk
+
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				MOV				RDI, RCX
+				MOV				RSI, RDX
+				PackGeometry	R9
+				MOV				R11D, 512						; end of the last field of a block
+				SUB				R11, RDX
+				MOV				R10, RAX
+				LEA				RAX, [ R8 + R10 - 1 ]
+				XOR				EDX, EDX
+				DIV				R10
+				MOV				Q_PTR [ RSP ] [ 5 * 8 ], RAX	; blocks, to return (home space)
+				FieldMask		RBX, R9
+				TEST			R8, R8
+				JZ				@@done
+
+@@block:
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOV				Q_PTR [ RDI ] [ idx * 8 ], 0
+				ENDM
+				XOR				R10D, R10D						; bit position
+				XOR				EDX, EDX						; word being built
+@@val:			MOV				RAX, Q_PTR [ RSI ]
+				ADD				RSI, 8
+				AND				RAX, RBX
+				MOV				RCX, R10
+				MOV				R12, RAX
+				SHL				R12, CL							; shift by position within the word
+				OR				RDX, R12
+				MOV				R12, RCX
+				AND				R12D, 63
+				ADD				R12, R9
+				CMP				R12, 64
+				JB				@@within
+				MOV				R12, R10						; word full: store it, start the next with the high part
+				SHR				R12, 6
+				XOR				R12, 7
+				MOV				Q_PTR [ RDI + R12 * 8 ], RDX
+				XOR				EDX, EDX
+				SHLD			RDX, RAX, CL
+@@within:		ADD				R10, R9
+				DEC				R8
+				JZ				@@last
+				CMP				R10, R11
+				JB				@@val
+@@last:			CMP				R10, 512						; store the part built, if any room
+				JAE				@@next
+				MOV				R12, R10
+				SHR				R12, 6
+				XOR				R12, 7
+				MOV				Q_PTR [ RDI + R12 * 8 ], RDX
+@@next:			ADD				RDI, 64
+				TEST			R8, R8
+				JNZ				@@block
+
+@@done:			MOV				RAX, Q_PTR [ RSP ] [ 5 * 8 ]
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+@@badk:			XOR				EAX, EAX
+				RET
+				Stack_End		pack_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			unpack_u	-	unpack n values of k bits each from 512 bit blocks (as packed by pack_u)
+;			Prototype:		u64 unpack_u( u64* values, u64* blocks, u64 n, u64 k );
+;			values		-	Address of n u64 values (in RCX), receives the fields zero extended
+;			blocks		-	Address of 64 byte aligned blocks (in RDX)
+;			n			-	Number of values (in R8)
+;			k			-	Field width, 1 to 64 (in R9)
+;			returns		-	n, 0 if k is not 1 to 64
+;			Note:	Z: eight fields at a time, a block in a register: the word each field starts in and the next are permuted to
+;					its lane (VPERMQ), shifted (VPSRLVQ, VPSLLVQ) and masked. Otherwise a field at a time (SHRD)
+
+				Stack_Entry		unpack_u, ui512
+				CheckAlign		RDX								; (IN) blocks
+				LEA				RAX, [ R9 - 1 ]
+				CMP				RAX, 63
+				JA				@@badk
+	IF __UseZ
+				MOV				Q_PTR [ RSP ] [ 1 * 8 ], R8		; n, to return (home space)
+				MOV				R10, RDX
+				MOV				R11, RCX
+				FieldConst		R9
+				PackGeometry	R9
+				MOV				RCX, R11
+				MOV				R9, RAX							; fields per block
+				TEST			R8, R8
+				JZ				@@done
+@@block:		VMOVDQA64		ZMM16, ZM_PTR [ R10 ]
+				VMOVDQA64		ZMM24, ZMM17
+				MOV				R11, R9							; fields of this block
+				CMP				R11, R8
+				CMOVA			R11, R8
+@@group:		MOV				EAX, 8							; fields of this group
+				CMP				R11, RAX
+				CMOVB			RAX, R11
+				MOV				EDX, 0FFh
+				BZHI			EDX, EDX, EAX
+				KMOVB			K1, EDX
+				FieldGet8
+				VMOVDQU64		ZM_PTR [ RCX ] {k1}, ZMM27
+				LEA				RCX, [ RCX + RAX * 8 ]
+				VPADDQ			ZMM24, ZMM24, ZMM19
+				SUB				R8, RAX
+				SUB				R11, RAX
+				JNZ				@@group
+				ADD				R10, 64
+				TEST			R8, R8
+				JNZ				@@block
+@@done:			MOV				RAX, Q_PTR [ RSP ] [ 1 * 8 ]
+				RET
+	ELSE
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				Q_PTR [ RSP ] [ 4 * 8 ], R8		; n, to return (home space)
+				MOV				RDI, RCX
+				MOV				RSI, RDX
+				PackGeometry	R9
+				MOV				R11D, 512						; end of the last field of a block
+				SUB				R11, RDX
+				FieldMask		RBX, R9
+				TEST			R8, R8
+				JZ				@@done
+				XOR				R10D, R10D						; bit position
+@@val:			FieldGet		RAX, RSI, R10
+				AND				RAX, RBX
+				MOV				Q_PTR [ RDI ], RAX
+				ADD				RDI, 8
+				ADD				R10, R9
+				DEC				R8
+				JZ				@@done
+				CMP				R10, R11
+				JB				@@val
+				ADD				RSI, 64
+				XOR				R10D, R10D
+				JMP				@@val
+@@done:			MOV				RAX, Q_PTR [ RSP ] [ 4 * 8 ]
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+	ENDIF
+@@badk:			XOR				EAX, EAX
+				RET
+				Stack_End		unpack_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			unpack_filter_u	-	unpack n values of k bits each from 512 bit blocks, keeping the indices of those within a range
+;			Prototype:		u64 unpack_filter_u( u64* indices, u64* blocks, u64 n, u64 k, u64 lo, u64 hi );
+;			indices		-	Address of room for n u64 (in RCX), receives the indices i, in order, of the values with lo <= value <= hi
+;			blocks		-	Address of 64 byte aligned blocks (in RDX), as packed by pack_u
+;			n			-	Number of values (in R8)
+;			k			-	Field width, 1 to 64 (in R9)
+;			lo			-	Least value kept (on stack)
+;			hi			-	Greatest value kept (on stack)
+;			returns		-	number of indices written, 0 if k is not 1 to 64 or lo > hi
+;			Note:	the values are not stored: unpacked as unpack_u, compared ( value - lo <= hi - lo, lo <= hi ), and the indices kept written
+;					(Z: compressed, VPCOMPRESSQ; otherwise each written, and the output advanced if kept)
+
+				Stack_Entry		unpack_filter_u, ui512
+				CheckAlign		RDX								; (IN) blocks
+				LEA				RAX, [ R9 - 1 ]
+				CMP				RAX, 63
+				JA				@@badk
+				MOV				RAX, Q_PTR [ RSP ] [ 5 * 8 ]	; lo (fifth parameter, above return address and home space)
+				CMP				RAX, Q_PTR [ RSP ] [ 6 * 8 ]	; hi
+				JA				@@badk							; lo > hi: the range is empty (hi - lo would wrap)
+	IF __UseZ
+				MOV				Q_PTR [ RSP ] [ 1 * 8 ], RCX	; start of indices (home space)
+				MOV				R10, RDX
+				MOV				R11, RCX
+				FieldConst		R9
+				MOV				RAX, Q_PTR [ RSP ] [ 5 * 8 ]	; lo (fifth parameter, above return address and home space)
+				VPBROADCASTQ	ZMM30, RAX
+				MOV				RDX, Q_PTR [ RSP ] [ 6 * 8 ]	; hi
+				SUB				RDX, RAX
+				VPBROADCASTQ	ZMM31, RDX
+				VMOVDQA64		ZMM29, ZM_PTR ShiftPermuteRt	; indices 0 to 7
+				PackGeometry	R9
+				MOV				RCX, R11
+				MOV				R9, RAX							; fields per block
+				TEST			R8, R8
+				JZ				@@done
+@@block:		VMOVDQA64		ZMM16, ZM_PTR [ R10 ]
+				VMOVDQA64		ZMM24, ZMM17
+				MOV				R11, R9							; fields of this block
+				CMP				R11, R8
+				CMOVA			R11, R8
+@@group:		MOV				EAX, 8							; fields of this group
+				CMP				R11, RAX
+				CMOVB			RAX, R11
+				MOV				EDX, 0FFh
+				BZHI			EDX, EDX, EAX
+				KMOVB			K1, EDX
+				FieldGet8
+				VPSUBQ			ZMM28, ZMM27, ZMM30
+				VPCMPUQ			K2 {k1}, ZMM28, ZMM31, 2		; value - lo <= hi - lo
+				VPCOMPRESSQ		ZMM28 {k2}{z}, ZMM29
+				VPBROADCASTQ	ZMM18, RAX
+				VPADDQ			ZMM29, ZMM29, ZMM18
+				VPADDQ			ZMM24, ZMM24, ZMM19
+				SUB				R8, RAX
+				SUB				R11, RAX
+				KMOVB			EAX, K2
+				POPCNT			EAX, EAX
+				MOV				EDX, 0FFh
+				BZHI			EDX, EDX, EAX
+				KMOVB			K3, EDX
+				VMOVDQU64		ZM_PTR [ RCX ] {k3}, ZMM28
+				LEA				RCX, [ RCX + RAX * 8 ]
+				TEST			R11, R11
+				JNZ				@@group
+				ADD				R10, 64
+				TEST			R8, R8
+				JNZ				@@block
+@@done:			MOV				RAX, RCX
+				SUB				RAX, Q_PTR [ RSP ] [ 1 * 8 ]
+				SHR				RAX, 3
+				RET
+	ELSE
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				MOV				Q_PTR [ RSP ] [ 7 * 8 ], RCX	; start of indices (home space)
+				MOV				RDI, RCX
+				MOV				RSI, RDX
+				PackGeometry	R9
+				MOV				R11D, 512						; end of the last field of a block
+				SUB				R11, RDX
+				FieldMask		RBX, R9
+				MOV				R13, Q_PTR [ RSP ] [ 11 * 8 ]	; lo (fifth parameter, above saved regs, return address and home space)
+				MOV				R14, Q_PTR [ RSP ] [ 12 * 8 ]	; hi
+				SUB				R14, R13
+				XOR				R12D, R12D						; index
+				TEST			R8, R8
+				JZ				@@done
+				XOR				R10D, R10D						; bit position
+@@val:			FieldGet		RAX, RSI, R10
+				AND				RAX, RBX
+				MOV				Q_PTR [ RDI ], R12
+				SUB				RAX, R13
+				LEA				RDX, [ RDI + 8 ]
+				CMP				RAX, R14
+				CMOVBE			RDI, RDX						; kept: advance
+				INC				R12
+				ADD				R10, R9
+				DEC				R8
+				JZ				@@done
+				CMP				R10, R11
+				JB				@@val
+				ADD				RSI, 64
+				XOR				R10D, R10D
+				JMP				@@val
+@@done:			MOV				RAX, RDI
+				SUB				RAX, Q_PTR [ RSP ] [ 7 * 8 ]
+				SHR				RAX, 3
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+	ENDIF
+@@badk:			XOR				EAX, EAX
+				RET
+				Stack_End		unpack_filter_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			shl_insert_u	-	shift a 512 bit source left, inserting new bits at the bottom
+;			Prototype:		void shl_insert_u( u64* destination, u64* source, u16 bits, u64 newbits );
+;			destination	-	Address of 64 byte aligned 512 bits, receives ( source << bits ) OR the low bits of newbits (in RCX)
+;			source		-	Address of 64 byte aligned 512 bits (in RDX), may be the destination
+;			bits		-	Number of bits to shift, 0 to 64, more taken as 64 (in R8W)
+;			newbits		-	Bits to insert, the low 'bits' of it (in R9)
+;			returns		-	nothing (0)
+;			Note:	one pass, in place of shl_u then or_u
+
+				Leaf_Entry		shl_insert_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN) source
+
+				MOVZX			R8D, R8W
+				TEST			R8D, R8D
+				JNZ				@F
+				CMP				RCX, RDX
+				JE				@@ret							; no shift, destination is the source: nothing to do
+				Copy512			RCX, RDX
+@@ret:			RetV
+@@:				MOV				EAX, 64
+				CMP				R8D, EAX
+				CMOVA			R8D, EAX
+	IF __UseZ
+				VMOVDQA64		ZMM31, ZM_PTR [ RDX ]
+				SUB				EAX, R8D
+				VPBROADCASTQ	ZMM28, RAX
+				ShlInsZ			ZMM31, R9, ZMM28
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM31
+				RetV
+	ELSE
+				MOV				RAX, RCX
+				CMP				R8D, 64
+				JE				@@words
+				MOV				ECX, R8D
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6 >
+				MOV				R10, Q_PTR [ RDX ] [ idx * 8 ]
+				MOV				R11, Q_PTR [ RDX ] [ ( idx + 1 ) * 8 ]
+				SHLD			R10, R11, CL
+				MOV				Q_PTR [ RAX ] [ idx * 8 ], R10	; source word idx + 1 still to be read, if the same
+				ENDM
+				MOV				R10, Q_PTR [ RDX ] [ 7 * 8 ]
+				ROR				R9, CL							; low bits of newbits to its top, to shift in
+				SHLD			R10, R9, CL
+				MOV				Q_PTR [ RAX ] [ 7 * 8 ], R10
+				RetV
+@@words:
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6 >
+				MOV				R10, Q_PTR [ RDX ] [ ( idx + 1 ) * 8 ]
+				MOV				Q_PTR [ RAX ] [ idx * 8 ], R10
+				ENDM
+				MOV				Q_PTR [ RAX ] [ 7 * 8 ], R9
+				RetV
+	ENDIF
+				Leaf_End		shl_insert_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			shr_insert_u	-	shift a 512 bit source right, inserting new bits at the top
+;			Prototype:		void shr_insert_u( u64* destination, u64* source, u16 bits, u64 newbits );
+;			destination	-	Address of 64 byte aligned 512 bits, receives ( source >> bits ) with the low bits of newbits above (in RCX)
+;			source		-	Address of 64 byte aligned 512 bits (in RDX), may be the destination
+;			bits		-	Number of bits to shift, 0 to 64, more taken as 64 (in R8W)
+;			newbits		-	Bits to insert, the low 'bits' of it, to bits 511 - bits + 1 to 511 (in R9)
+;			returns		-	nothing (0)
+
+				Leaf_Entry		shr_insert_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN) source
+
+				MOVZX			R8D, R8W
+				TEST			R8D, R8D
+				JNZ				@F
+				CMP				RCX, RDX
+				JE				@@ret							; no shift, destination is the source: nothing to do
+				Copy512			RCX, RDX
+@@ret:			RetV
+@@:				MOV				EAX, 64
+				CMP				R8D, EAX
+				CMOVA			R8D, EAX
+	IF __UseZ
+				VMOVDQA64		ZMM31, ZM_PTR [ RDX ]
+				SUB				EAX, R8D
+				VPBROADCASTQ	ZMM28, RAX						; 64 - bits
+				VPBROADCASTQ	ZMM29, R9
+				VALIGNQ			ZMM30, ZMM31, ZMM29, 7			; window moved down a word, newbits to the most significant
+				VPSHLDVQ		ZMM30, ZMM31, ZMM28				; each lane of that funnel shifted with the lane of the window
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM30
+				RetV
+	ELSE
+				MOV				RAX, RCX
+				CMP				R8D, 64
+				JE				@@words
+				MOV				ECX, R8D
+				FOR				idx, < 7, 6, 5, 4, 3, 2, 1 >
+				MOV				R10, Q_PTR [ RDX ] [ idx * 8 ]
+				MOV				R11, Q_PTR [ RDX ] [ ( idx - 1 ) * 8 ]
+				SHRD			R10, R11, CL
+				MOV				Q_PTR [ RAX ] [ idx * 8 ], R10	; source word idx - 1 still to be read, if the same
+				ENDM
+				MOV				R10, Q_PTR [ RDX ] [ 0 * 8 ]
+				SHRD			R10, R9, CL
+				MOV				Q_PTR [ RAX ] [ 0 * 8 ], R10
+				RetV
+@@words:
+				FOR				idx, < 7, 6, 5, 4, 3, 2, 1 >
+				MOV				R10, Q_PTR [ RDX ] [ ( idx - 1 ) * 8 ]
+				MOV				Q_PTR [ RAX ] [ idx * 8 ], R10
+				ENDM
+				MOV				Q_PTR [ RAX ] [ 0 * 8 ], R9
+				RetV
+	ENDIF
+				Leaf_End		shr_insert_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			shl_stream_n	-	roll a 512 bit window over a stream of symbols, writing each window
+;			Prototype:		u64 shl_stream_n( u64* windows, u64* window, u64* symbols, u64 n, u64 bits );
+;			windows		-	Address of 64 byte aligned room for n 512 bit windows (in RCX), window i after symbol i is inserted
+;			window		-	Address of 64 byte aligned 512 bit window (in RDX), the start, receives the last
+;			symbols		-	Address of n u64 symbols (in R8), the low 'bits' of each
+;			n			-	Number of symbols (in R9)
+;			bits		-	Bits of a symbol, 1 to 64 (on stack)
+;			returns		-	n, 0 if bits is not 1 to 64
+;			Note:	each symbol shl_insert_u, the window held in registers (Z: ZMM24; otherwise eight GPRs)
+
+				Stack_Entry		shl_stream_n, ui512
+				CheckAlign		RCX								; (OUT) windows
+				CheckAlign		RDX								; (IN/OUT) window
+
+				MOV				RAX, Q_PTR [ RSP ] [ 5 * 8 ]	; bits (fifth parameter, above return address and home space)
+				LEA				R10, [ RAX - 1 ]
+				CMP				R10, 63
+				JA				@@badbits
+	IF __UseZ
+				VMOVDQA64		ZMM24, ZM_PTR [ RDX ]
+				MOV				R10D, 64
+				SUB				R10, RAX
+				VPBROADCASTQ	ZMM28, R10						; 64 - bits
+				MOV				RAX, R9
+				TEST			R9, R9
+				JZ				@@done
+@@sym:			ShlInsZ			ZMM24, Q_PTR [ R8 ], ZMM28
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM24
+				ADD				RCX, 64
+				ADD				R8, 8
+				DEC				R9
+				JNZ				@@sym
+@@done:			VMOVDQA64		ZM_PTR [ RDX ], ZMM24
+				RET
+	ELSE
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				PUSH			RBP
+				MOV				Q_PTR [ RSP ] [ 9 * 8 ], R9		; n, to return (home space)
+				MOV				Q_PTR [ RSP ] [ 10 * 8 ], RDX	; window
+				WinLoad			RDX
+				MOV				RDX, RCX
+				MOV				RCX, RAX
+				TEST			R9, R9
+				JZ				@@done
+				CMP				ECX, 64
+				JE				@@words
+@@sym:			MOV				RAX, Q_PTR [ R8 ]
+				WinShl			RAX
+				WinStore		RDX
+				ADD				RDX, 64
+				ADD				R8, 8
+				DEC				R9
+				JNZ				@@sym
+				JMP				@@done
+@@words:		MOV				RAX, Q_PTR [ R8 ]
+				WinShlWord		RAX
+				WinStore		RDX
+				ADD				RDX, 64
+				ADD				R8, 8
+				DEC				R9
+				JNZ				@@words
+@@done:			MOV				RDX, Q_PTR [ RSP ] [ 10 * 8 ]
+				WinStore		RDX
+				MOV				RAX, Q_PTR [ RSP ] [ 9 * 8 ]
+				POP				RBP
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+	ENDIF
+@@badbits:		XOR				EAX, EAX
+				RET
+				Stack_End		shl_stream_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			shl_stream_match_n	-	roll a 512 bit window over a stream of symbols, selecting the windows matching a masked pattern
+;			Prototype:		u64 shl_stream_match_n( u64* indices, u64* window, u64* symbols, u64 n, u64 bits, u64* mask, u64* pattern );
+;			indices		-	Address of room for n QWORDS (in RCX), receives each i, ascending, for which ( window AND mask ) equals
+;							pattern after symbol i is inserted
+;			window		-	Address of 64 byte aligned 512 bit window (in RDX), the start, receives the last
+;			symbols		-	Address of n u64 symbols (in R8), the low 'bits' of each
+;			n			-	Number of symbols (in R9)
+;			bits		-	Bits of a symbol, 1 to 64 (on stack)
+;			mask		-	Address of 64 byte aligned 512 bit mask (on stack)
+;			pattern		-	Address of 64 byte aligned 512 bit pattern (on stack)
+;			returns		-	number of indices written, 0 if bits is not 1 to 64
+;			Note:	as shl_stream_n, windows not written: every index is stored, and the output advanced on the match
+
+				Stack_Entry		shl_stream_match_n, ui512
+				CheckAlign		RDX								; (IN/OUT) window
+
+				MOV				RAX, Q_PTR [ RSP ] [ 5 * 8 ]	; bits (fifth parameter, above return address and home space)
+				LEA				R10, [ RAX - 1 ]
+				CMP				R10, 63
+				JA				@@badbits
+				MOV				R10, Q_PTR [ RSP ] [ 6 * 8 ]	; mask
+				MOV				R11, Q_PTR [ RSP ] [ 7 * 8 ]	; pattern
+				CheckAlign		R10								; (IN) mask
+				CheckAlign		R11								; (IN) pattern
+	IF __UseZ
+				VMOVDQA64		ZMM26, ZM_PTR [ R10 ]			; mask and pattern held for the pass
+				VMOVDQA64		ZMM25, ZM_PTR [ R11 ]
+				VMOVDQA64		ZMM24, ZM_PTR [ RDX ]
+				MOV				R10D, 64
+				SUB				R10, RAX
+				VPBROADCASTQ	ZMM28, R10						; 64 - bits
+				XOR				R10D, R10D						; count of matches
+				XOR				R11D, R11D						; symbol index
+				TEST			R9, R9
+				JZ				@@done
+@@sym:			ShlInsZ			ZMM24, Q_PTR [ R8 ], ZMM28
+				Match512		ZMM24, ZMM26, ZMM25
+				MOV				Q_PTR [ RCX ] [ R10 * 8 ], R11	; store index, kept only if it matched
+				ADC				R10, 0
+				ADD				R8, 8
+				INC				R11
+				CMP				R11, R9
+				JB				@@sym
+@@done:			VMOVDQA64		ZM_PTR [ RDX ], ZMM24
+				MOV				RAX, R10
+				RET
+	ELSE
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				PUSH			RBP
+				SUB				RSP, 128						; mask, then pattern
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOV				RBX, Q_PTR [ R10 ] [ idx * 8 ]
+				MOV				Q_PTR [ RSP ] [ idx * 8 ], RBX
+				MOV				RBX, Q_PTR [ R11 ] [ idx * 8 ]
+				MOV				Q_PTR [ RSP ] [ 64 + idx * 8 ], RBX
+				ENDM
+				MOV				Q_PTR [ RSP ] [ 128 + 9 * 8 ], RCX	; start of indices (home space)
+				MOV				Q_PTR [ RSP ] [ 128 + 10 * 8 ], RDX	; window
+				MOV				Q_PTR [ RSP ] [ 128 + 12 * 8 ], R9	; n
+				WinLoad			RDX
+				MOV				RDX, RCX
+				MOV				RCX, RAX
+				XOR				R9D, R9D						; symbol index
+				CMP				R9, Q_PTR [ RSP ] [ 128 + 12 * 8 ]
+				JAE				@@done
+				CMP				ECX, 64
+				JE				@@words
+@@sym:			MOV				RAX, Q_PTR [ R8 ]
+				WinShl			RAX
+				WinMatch		RSP
+				MOV				Q_PTR [ RDX ], R9				; store index, kept only if it matched
+				LEA				RAX, [ RDX + 8 ]
+				CMOVZ			RDX, RAX
+				ADD				R8, 8
+				INC				R9
+				CMP				R9, Q_PTR [ RSP ] [ 128 + 12 * 8 ]
+				JB				@@sym
+				JMP				@@done
+@@words:		MOV				RAX, Q_PTR [ R8 ]
+				WinShlWord		RAX
+				WinMatch		RSP
+				MOV				Q_PTR [ RDX ], R9
+				LEA				RAX, [ RDX + 8 ]
+				CMOVZ			RDX, RAX
+				ADD				R8, 8
+				INC				R9
+				CMP				R9, Q_PTR [ RSP ] [ 128 + 12 * 8 ]
+				JB				@@words
+@@done:			MOV				RAX, RDX
+				SUB				RAX, Q_PTR [ RSP ] [ 128 + 9 * 8 ]
+				SHR				RAX, 3
+				MOV				RDX, Q_PTR [ RSP ] [ 128 + 10 * 8 ]
+				WinStore		RDX
+				ADD				RSP, 128
+				POP				RBP
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RET
+	ENDIF
+@@badbits:		XOR				EAX, EAX
+				RET
+				Stack_End		shl_stream_match_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			rand_seed_u	-	seed the random state
+;			Prototype:		void rand_seed_u( u64* state, u64 seed );
+;			state		-	Address of 64 byte aligned RandStateQ (32) QWORDS (in RCX), receives successive SplitMix64 outputs of seed
+;			seed		-	Any value; the same seed, the same values after (in RDX)
+;			returns		-	nothing (0)
+
+				Leaf_Entry		rand_seed_u, ui512
+				CheckAlign		RCX								; (OUT) state
+
+				MOV				R9D, RandStateQ
+@@:				ADD				RDX, Q_PTR SplitMix
+				MOV				RAX, RDX
+				MOV				R8, RAX
+				SHR				R8, 30
+				XOR				RAX, R8
+				IMUL			RAX, Q_PTR SplitMix [ 8 ]
+				MOV				R8, RAX
+				SHR				R8, 27
+				XOR				RAX, R8
+				IMUL			RAX, Q_PTR SplitMix [ 16 ]
+				MOV				R8, RAX
+				SHR				R8, 31
+				XOR				RAX, R8
+				MOV				Q_PTR [ RCX ], RAX
+				ADD				RCX, 8
+				DEC				R9D
+				JNZ				@B
+				RET
+				Leaf_End		rand_seed_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			rand_u		-	next 512 bit random value
+;			Prototype:		void rand_u( u64* destination, u64* state );
+;			destination	-	Address of 64 byte aligned 512 bits, receives the value (in RCX)
+;			state		-	Address of 64 byte aligned state, from rand_seed_u (in RDX), advanced
+;			returns		-	nothing (0)
+;			Note:	word i is the output of generator i, xoshiro256** with its state in word i of each of the four state values
+
+				Leaf_Entry		rand_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN/OUT) state
+
+				MOV				R8D, 1
+				RandFill
+				RetV
+				Leaf_End		rand_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			rand_fill_n	-	n 512 bit random values
+;			Prototype:		void rand_fill_n( u64* destination, u64* state, u64 n );
+;			destination	-	Address of 64 byte aligned n 512 bit values, receives the next n values, as n calls of rand_u (in RCX)
+;			state		-	Address of 64 byte aligned state, from rand_seed_u (in RDX), advanced
+;			n			-	Number of values (in R8)
+;			returns		-	nothing (0)
+;			Note:	state held in registers for the fill (Z: all eight generators; otherwise the generators of a lane in turn);
+;					Z fills of RandStream values or more with non-temporal stores
+
+				Leaf_Entry		rand_fill_n, ui512
+				CheckAlign		RCX								; (OUT) destination
+				CheckAlign		RDX								; (IN/OUT) state
+
+				RandFill
+				RetV
+				Leaf_End		rand_fill_n, ui512
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			shr256_u	-	shift supplied source 256bit (4 QWORDS) right, put in destination
+;			Prototype:		void shr256_u( u64* destination, u64* source, u16 bits );
+;			destination	-	Address of 32 byte aligned array of 4 64-bit words (QWORDS) 256 bits (in RCX)
+;			source		-	Address of 32 byte aligned array of 4 64-bit words (QWORDS) 256 bits (in RDX), may be the destination
+;			bits		-	Number of bits to shift. Will fill with zeros, truncate those shifted out; 256 or more zeroes (in R8W)
+;			returns		-	nothing (0)
+;			Note:	Z and Y in one YMM register; X and Q from a stack copy with SHRD
+
+				Leaf_Entry		shr256_u, ui512
+				CheckAlign32	RCX								; (OUT) destination
+				CheckAlign32	RDX								; (IN) source
+
+				MOVZX			R8D, R8W
+				CMP				R8D, 256						; shift 256 or more bits: zero
+				JB				@F
+				Zero256			RCX
+				RetV
+@@:				TEST			R8D, R8D						; none: copy
+				JNZ				@F
+				Copy256			RCX, RDX
+				RetV
+@@:				MOV				R9, RCX
+				Shift256		0
+				RetV
+				Leaf_End		shr256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			shl256_u	-	shift supplied source 256bit (4 QWORDS) left, put in destination
+;			Prototype:		void shl256_u( u64* destination, u64* source, u16 bits );
+;			destination	-	Address of 32 byte aligned array of 4 64-bit words (QWORDS) 256 bits (in RCX)
+;			source		-	Address of 32 byte aligned array of 4 64-bit words (QWORDS) 256 bits (in RDX), may be the destination
+;			bits		-	Number of bits to shift. Will fill with zeros, truncate those shifted out; 256 or more zeroes (in R8W)
+;			returns		-	nothing (0)
+;			Note:	Z and Y in one YMM register; X and Q from a stack copy with SHLD
+
+				Leaf_Entry		shl256_u, ui512
+				CheckAlign32	RCX								; (OUT) destination
+				CheckAlign32	RDX								; (IN) source
+
+				MOVZX			R8D, R8W
+				CMP				R8D, 256						; shift 256 or more bits: zero
+				JB				@F
+				Zero256			RCX
+				RetV
+@@:				TEST			R8D, R8D						; none: copy
+				JNZ				@F
+				Copy256			RCX, RDX
+				RetV
+@@:				MOV				R9, RCX
+				Shift256		1
+				RetV
+				Leaf_End		shl256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			and256_u	-	AND each of 4 QWORDS of two 256 bit operands, put in destination
+;			Prototype:		void and256_u( u64* destination, u64* lh_op, u64* rh_op );
+;			destination	-	Address of 32 byte aligned 256 bits (in RCX)
+;			lh_op		-	Address of 32 byte aligned 256 bits (in RDX)
+;			rh_op		-	Address of 32 byte aligned 256 bits (in R8)
+;			returns		-	nothing (0)
+
+				Leaf_Entry		and256_u, ui512
+				CheckAlign32	RCX								; (OUT) destination
+				CheckAlign32	RDX								; (IN) lh_op
+				CheckAlign32	R8								; (IN) rh_op
+
+				Bit256			RCX, RDX, R8, VPANDQ, VPAND, PAND, AND
+				RetV
+				Leaf_End		and256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			or256_u		-	OR each of 4 QWORDS of two 256 bit operands, put in destination
+;			Prototype:		void or256_u( u64* destination, u64* lh_op, u64* rh_op );
+;			destination	-	Address of 32 byte aligned 256 bits (in RCX)
+;			lh_op		-	Address of 32 byte aligned 256 bits (in RDX)
+;			rh_op		-	Address of 32 byte aligned 256 bits (in R8)
+;			returns		-	nothing (0)
+
+				Leaf_Entry		or256_u, ui512
+				CheckAlign32	RCX								; (OUT) destination
+				CheckAlign32	RDX								; (IN) lh_op
+				CheckAlign32	R8								; (IN) rh_op
+
+				Bit256			RCX, RDX, R8, VPORQ, VPOR, POR, OR
+				RetV
+				Leaf_End		or256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			xor256_u	-	XOR each of 4 QWORDS of two 256 bit operands, put in destination
+;			Prototype:		void xor256_u( u64* destination, u64* lh_op, u64* rh_op );
+;			destination	-	Address of 32 byte aligned 256 bits (in RCX)
+;			lh_op		-	Address of 32 byte aligned 256 bits (in RDX)
+;			rh_op		-	Address of 32 byte aligned 256 bits (in R8)
+;			returns		-	nothing (0)
+
+				Leaf_Entry		xor256_u, ui512
+				CheckAlign32	RCX								; (OUT) destination
+				CheckAlign32	RDX								; (IN) lh_op
+				CheckAlign32	R8								; (IN) rh_op
+
+				Bit256			RCX, RDX, R8, VPXORQ, VPXOR, PXOR, XOR
+				RetV
+				Leaf_End		xor256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			not256_u	-	NOT each of 4 QWORDS of a 256 bit operand, put in destination
+;			Prototype:		void not256_u( u64* destination, u64* source );
+;			destination	-	Address of 32 byte aligned 256 bits (in RCX)
+;			source		-	Address of 32 byte aligned 256 bits (in RDX)
+;			returns		-	nothing (0)
+
+				Leaf_Entry		not256_u, ui512
+				CheckAlign32	RCX								; (OUT) destination
+				CheckAlign32	RDX								; (IN) source
+
+	IF __UseZ
+				VMOVDQA64		YMM31, YM_PTR [ RDX ]
+				VPTERNLOGQ		YMM31, YMM31, YMM31, 55h		; not
+				VMOVDQA64		YM_PTR [ RCX ], YMM31
+	ELSEIF __UseY
+				VPCMPEQQ		YMM4, YMM4, YMM4				; all ones
+				VPXOR			YMM4, YMM4, YM_PTR [ RDX ]
+				VMOVDQA			YM_PTR [ RCX ], YMM4
+	ELSEIF __UseX
+				PCMPEQQ			XMM4, XMM4
+				MOVDQA			XMM3, XMM4
+				PXOR			XMM4, XM_PTR [ RDX ]
+				MOVDQA			XM_PTR [ RCX ], XMM4
+				PXOR			XMM3, XM_PTR [ RDX ] [ 16 ]
+				MOVDQA			XM_PTR [ RCX ] [ 16 ], XMM3
+	ELSE
+				FOR				idx, < 0, 1, 2, 3 >
+				MOV				RAX, Q_PTR [ RDX ] [ idx * 8 ]
+				NOT				RAX
+				MOV				Q_PTR [ RCX ] [ idx * 8 ], RAX
+				ENDM
+	ENDIF
+				RetV
+				Leaf_End		not256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			msb256_u	-	find most significant bit in supplied source 256bit (4 QWORDS)
+;			Prototype:		s16 msb256_u( u64* source );
+;			source		-	Address of 32 byte aligned array of 4 64-bit words (QWORDS) 256 bits (in RCX)
+;			returns		-	-1 if no most significant bit, bit number otherwise, bits numbered 0 to 255 inclusive (as msb_u)
+
+				Leaf_Entry		msb256_u, ui512
+				CheckAlign32	RCX								; (IN) source to scan
+
+				NonZero256		RCX								; bit i set for a non-zero word i
+				TZCNT			EDX, EAX						; first (most significant) non-zero word
+				JNC				@F
+				LEA				EAX, [ retcode_neg_one ]		; all four words zero
+				RetV
+@@:				LZCNT			RAX, Q_PTR [ RCX ] [ RDX * 8 ]
+				NEG				EDX
+				LEA				EDX, [ RDX + 3 ]
+				SHL				EDX, 6							; (3 - word) * 64
+				LEA				EDX, [ RDX + 63 ]
+				SUB				EDX, EAX
+				MOV				EAX, EDX
+				RetV
+				Leaf_End		msb256_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			lsb256_u	-	find least significant bit in supplied source 256bit (4 QWORDS)
+;			Prototype:		s16 lsb256_u( u64* source );
+;			source		-	Address of 32 byte aligned array of 4 64-bit words (QWORDS) 256 bits (in RCX)
+;			returns		-	-1 if no least significant bit, bit number otherwise, bits numbered 0 to 255 inclusive (as lsb_u)
+
+				Leaf_Entry		lsb256_u, ui512
+				CheckAlign32	RCX								; (IN) source to scan
+
+				NonZero256		RCX								; bit i set for a non-zero word i
+				LZCNT			EDX, EAX						; last (least significant) non-zero word, as 31 - word
+				JNC				@F
+				LEA				EAX, [ retcode_neg_one ]		; all four words zero
+				RetV
+@@:				NEG				EDX
+				LEA				EDX, [ RDX + 31 ]
+				TZCNT			RAX, Q_PTR [ RCX ] [ RDX * 8 ]
+				NEG				EDX
+				LEA				EDX, [ RDX + 3 ]
+				SHL				EDX, 6							; (3 - word) * 64
+				ADD				EAX, EDX
+				RetV
+				Leaf_End		lsb256_u, ui512
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			options_u	-	report the options this module was assembled with (compile_time_options.inc)
+;			Prototype:		u32 options_u( void );
+;			returns		-	'Z', 'Y', 'X' or 'Q' in bits 0 to 7: the path used; bit 8 set for __UseBMI2, bit 9 for __CheckAlign, bit 10 for __Instrument,
+;							bit 11 for __SysV
+;			Note:	so benchmark and test results can be labelled with the build they ran against
+
+				Leaf_Entry		options_u, ui512
+	IF __UseZ
+				MOV				EAX, 'Z'
+	ELSEIF __UseY
+				MOV				EAX, 'Y'
+	ELSEIF __UseX
+				MOV				EAX, 'X'
+	ELSE
+				MOV				EAX, 'Q'
+	ENDIF
+	IF __UseBMI2
+				OR				EAX, 100h
+	ENDIF
+	IF __CheckAlign
+				OR				EAX, 200h
+	ENDIF
+	IF __Instrument
+				OR				EAX, 400h
+	ENDIF
+	IF __SysV
+				OR				EAX, 800h
+	ENDIF
+				RET
+				Leaf_End		options_u, ui512
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			set_vector_policy_u	-	choose the registers the single value procs use (Z)
+;			Prototype:		u32 set_vector_policy_u( u32 policy );
+;			policy		-	VectorWide (0, the default): ZMM in every proc. VectorLight (1): shr_u, shl_u, and_u, or_u, xor_u, not_u,
+;							msb_u and lsb_u in GPRs or 256 bit halves, for calls made now and then among other code; the _n procs
+;							keep ZMM (in ECX)
+;			returns		-	the previous policy; a policy other than 0 or 1 is not taken
+;			Note:	for the process, all threads. Assembled for Y, X or Q, the policy is kept but changes nothing
+
+				Leaf_Entry		set_vector_policy_u, ui512
+				MOV				EAX, D_PTR VectorPolicy
+				CMP				ECX, VectorLight
+				JA				@F
+				MOV				D_PTR VectorPolicy, ECX
+@@:				RET
+				Leaf_End		set_vector_policy_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			pipe_run_n	-	run a list of ops over arrays of 512bit records, a tile of records at a time
+;			Prototype:		u64 pipe_run_n( pipe_slot_u* slots, pipe_op_u* ops, u64 nops, u64 first, u64 n );
+;			slots		-	Address of the slots the ops name, 16 bytes each: base (QWORD), stride (DWORD), tile (DWORD) (in RCX).
+;							An operand of record i is at base + i * stride (64: an array of records; 0: a constant; 2: the
+;							s16 results of PipePopcnt, PipeMsb, PipeLsb); with tile non-zero, at base + ( i mod PipeTile ) * stride,
+;							a buffer of PipeTile records for an intermediate result. Records 64 byte aligned
+;			ops			-	Address of nops ops, 8 bytes each: op, d, a, b, c (BYTEs, slot numbers), imm (BYTE), bits (WORD) (in RDX)
+;			nops		-	Number of ops (in R8)
+;			first		-	Index of the first record (in R9)
+;			n			-	Number of records (on stack)
+;			returns		-	the total of the counts of the PipePopcnt ops
+;			Note:	each op over the PipeTile records of a tile, then the next op, so the tile buffers stay in L1 and each array is
+;					read (or written) once: a chain of ops costs one pass over memory, not one per op. d may be a, b or c.
+;					For several threads: give each its own records (first, n) and tile buffers.
+
+				Stack_Entry		pipe_run_n, ui512
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RBP
+				PUSH			RSI
+				PUSH			RDI
+				PUSH			R12
+				PUSH			R13
+				PUSH			R14
+				PUSH			R15
+				SUB				RSP, PipeFrame
+				MOV				RBX, RCX						; slots
+				MOV				Q_PTR [ RSP ] [ PipeOpsBegin ], RDX
+				LEA				RAX, [ RDX + R8 * 8 ]
+				MOV				Q_PTR [ RSP ] [ PipeOpsEnd ], RAX
+				MOV				R12, R9							; the tile's first record
+				MOV				RAX, Q_PTR [ RSP ] [ PipeFrame + 13 * 8 ]	; n (fifth parameter, above frame, saved regs, return, home)
+				ADD				RAX, R9
+				MOV				Q_PTR [ RSP ] [ PipeEnd ], RAX
+				XOR				R14D, R14D						; total of the counts
+
+@@tile:			MOV				R15, Q_PTR [ RSP ] [ PipeEnd ]
+				SUB				R15, R12						; records left
+				JBE				@@done
+				MOV				EAX, PipeTile
+				CMP				R15, RAX
+				CMOVA			R15, RAX						; records in this tile
+				MOV				RSI, Q_PTR [ RSP ] [ PipeOpsBegin ]
+@@op:			CMP				RSI, Q_PTR [ RSP ] [ PipeOpsEnd ]
+				JAE				@@nexttile
+				MOVZX			EAX, B_PTR [ RSI ]
+				CMP				EAX, PipeOps
+				JAE				@@opdone						; not an op: skipped
+				PipeSlot		RCX, 1, PipeSD
+				PipeSlot		RDX, 2, PipeSA
+				PipeSlot		R8, 3, PipeSB
+				PipeSlot		R9, 4, PipeSC
+				MOV				RBP, R15
+				LEA				R10, @@jtbl
+				JMP				Q_PTR [ R10 ] [ RAX * 8 ]
+@@opdone:		ADD				RSI, 8
+				JMP				@@op
+@@nexttile:		ADD				R12, R15
+				JMP				@@tile
+
+@@done:			MOV				RAX, R14
+				ADD				RSP, PipeFrame
+				POP				R15
+				POP				R14
+				POP				R13
+				POP				R12
+				POP				RDI
+				POP				RSI
+				POP				RBP
+				POP				RBX
+				RetV
+
+				ALIGN			8
+@@jtbl:
+				QWORD			@@shr, @@shl, @@and, @@or, @@xor, @@not, @@tern, @@popcnt, @@msb, @@lsb
+
+@@shr:			PipeShift		0
+				JMP				@@opdone
+@@shl:			PipeShift		1
+				JMP				@@opdone
+@@and:			PipeLogic		VPANDQ, AND
+				JMP				@@opdone
+@@or:			PipeLogic		VPORQ, OR
+				JMP				@@opdone
+@@xor:			PipeLogic		VPXORQ, XOR
+				JMP				@@opdone
+@@not:
+	IF __UseZ
+				VMOVDQA64		ZMM31, ZM_PTR [ RDX ]
+				VPANDNQ			ZMM31, ZMM31, qOnes
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM31
+	ELSE
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOV				RAX, Q_PTR [ RDX ] [ idx * 8 ]
+				NOT				RAX
+				MOV				Q_PTR [ RCX ] [ idx * 8 ], RAX
+				ENDM
+	ENDIF
+				PipeNext
+				DEC				RBP
+				JNZ				@@not
+				JMP				@@opdone
+
+; ternary: f( a, b, c ) is bit ( a * 4 + b * 2 + c ) of imm. For each a, b: its function of c, L XOR ( c AND X ), L and X all
+; zeroes or all ones; then b chooses between two of those, and a between the results
+@@tern:			MOVZX			EAX, B_PTR [ RSI ] [ 5 ]
+				FOR				ab, < 0, 1, 2, 3 >
+				MOV				R10D, EAX
+				SHR				R10D, ab * 2
+				AND				R10D, 1
+				NEG				R10								; f( a, b, 0 ): zeroes or ones
+				MOV				R11D, EAX
+				SHR				R11D, ab * 2 + 1
+				AND				R11D, 1
+				NEG				R11								; f( a, b, 1 )
+				XOR				R11, R10
+				MOV				Q_PTR [ RSP ] [ PipeL + ab * 8 ], R10
+				MOV				Q_PTR [ RSP ] [ PipeX + ab * 8 ], R11
+				ENDM
+	IF __UseZ
+				VPBROADCASTQ	ZMM16, Q_PTR [ RSP ] [ PipeX + 0 * 8 ]	; X, L of each a, b held for the op
+				VPBROADCASTQ	ZMM17, Q_PTR [ RSP ] [ PipeX + 1 * 8 ]
+				VPBROADCASTQ	ZMM18, Q_PTR [ RSP ] [ PipeX + 2 * 8 ]
+				VPBROADCASTQ	ZMM19, Q_PTR [ RSP ] [ PipeX + 3 * 8 ]
+				VPBROADCASTQ	ZMM20, Q_PTR [ RSP ] [ PipeL + 0 * 8 ]
+				VPBROADCASTQ	ZMM21, Q_PTR [ RSP ] [ PipeL + 1 * 8 ]
+				VPBROADCASTQ	ZMM22, Q_PTR [ RSP ] [ PipeL + 2 * 8 ]
+				VPBROADCASTQ	ZMM23, Q_PTR [ RSP ] [ PipeL + 3 * 8 ]
+@@trec:			VMOVDQA64		ZMM31, ZM_PTR [ R9 ]			; c
+				VMOVDQA64		ZMM30, ZMM16
+				VPTERNLOGQ		ZMM30, ZMM31, ZMM20, 6Ah		; ( X AND c ) XOR L: a 0, b 0
+				VMOVDQA64		ZMM29, ZMM17
+				VPTERNLOGQ		ZMM29, ZMM31, ZMM21, 6Ah		; a 0, b 1
+				VMOVDQA64		ZMM28, ZM_PTR [ R8 ]			; b
+				VPTERNLOGQ		ZMM28, ZMM29, ZMM30, 0CAh		; b ? b 1 : b 0
+				VMOVDQA64		ZMM30, ZMM18
+				VPTERNLOGQ		ZMM30, ZMM31, ZMM22, 6Ah		; a 1, b 0
+				VMOVDQA64		ZMM29, ZMM19
+				VPTERNLOGQ		ZMM29, ZMM31, ZMM23, 6Ah		; a 1, b 1
+				VMOVDQA64		ZMM27, ZM_PTR [ R8 ]
+				VPTERNLOGQ		ZMM27, ZMM29, ZMM30, 0CAh
+				VMOVDQA64		ZMM26, ZM_PTR [ RDX ]			; a
+				VPTERNLOGQ		ZMM26, ZMM27, ZMM28, 0CAh		; a ? a 1 : a 0
+				VMOVDQA64		ZM_PTR [ RCX ], ZMM26
+	ELSE
+@@trec:
+				FOR				idx, < 0, 1, 2, 3, 4, 5, 6, 7 >
+				MOV				R10, Q_PTR [ R9 ] [ idx * 8 ]	; c
+				MOV				RAX, R10
+				AND				RAX, Q_PTR [ RSP ] [ PipeX + 0 * 8 ]
+				XOR				RAX, Q_PTR [ RSP ] [ PipeL + 0 * 8 ]	; a 0, b 0
+				MOV				RDI, R10
+				AND				RDI, Q_PTR [ RSP ] [ PipeX + 1 * 8 ]
+				XOR				RDI, Q_PTR [ RSP ] [ PipeL + 1 * 8 ]	; a 0, b 1
+				XOR				RDI, RAX
+				AND				RDI, Q_PTR [ R8 ] [ idx * 8 ]
+				XOR				RAX, RDI						; a 0: b ? b 1 : b 0
+				MOV				RDI, R10
+				AND				RDI, Q_PTR [ RSP ] [ PipeX + 2 * 8 ]
+				XOR				RDI, Q_PTR [ RSP ] [ PipeL + 2 * 8 ]	; a 1, b 0
+				AND				R10, Q_PTR [ RSP ] [ PipeX + 3 * 8 ]
+				XOR				R10, Q_PTR [ RSP ] [ PipeL + 3 * 8 ]	; a 1, b 1
+				XOR				R10, RDI
+				AND				R10, Q_PTR [ R8 ] [ idx * 8 ]
+				XOR				RDI, R10						; a 1
+				XOR				RDI, RAX
+				AND				RDI, Q_PTR [ RDX ] [ idx * 8 ]
+				XOR				RAX, RDI						; a ? a 1 : a 0
+				MOV				Q_PTR [ RCX ] [ idx * 8 ], RAX
+				ENDM
+	ENDIF
+				PipeNext
+				DEC				RBP
+				JNZ				@@trec
+				JMP				@@opdone
+
+@@popcnt:
+	IF __UseZ
+				VPOPCNTQ		ZMM31, ZM_PTR [ RDX ]
+				HSum31			R10
+	ELSE
+				POPCNT			R10, Q_PTR [ RDX ] [ 0 * 8 ]
+				FOR				idx, < 1, 2, 3, 4, 5, 6, 7 >
+				POPCNT			R11, Q_PTR [ RDX ] [ idx * 8 ]
+				ADD				R10, R11
+				ENDM
+	ENDIF
+				MOV				W_PTR [ RCX ], R10W
+				ADD				R14, R10
+				PipeNext
+				DEC				RBP
+				JNZ				@@popcnt
+				JMP				@@opdone
+
+; msb, lsb: as msb_u, lsb_u; the first (last) non-zero word, then the bit in it
+@@msb:			MOV				R10D, -1
+				XOR				R11D, R11D
+@@mword:		LZCNT			RAX, Q_PTR [ RDX ] [ R11 * 8 ]
+				JNC				@@mfound
+				INC				R11D
+				CMP				R11D, 8
+				JB				@@mword
+				JMP				@@mstore
+@@mfound:		MOV				R10D, 7
+				SUB				R10D, R11D
+				SHL				R10D, 6
+				ADD				R10D, 63
+				SUB				R10D, EAX
+@@mstore:		MOV				W_PTR [ RCX ], R10W
+				PipeNext
+				DEC				RBP
+				JNZ				@@msb
+				JMP				@@opdone
+
+@@lsb:			MOV				R10D, -1
+				MOV				R11D, 7
+@@lword:		TZCNT			RAX, Q_PTR [ RDX ] [ R11 * 8 ]
+				JNC				@@lfound
+				DEC				R11D
+				JNS				@@lword
+				JMP				@@lstore
+@@lfound:		MOV				R10D, 7
+				SUB				R10D, R11D
+				SHL				R10D, 6
+				ADD				R10D, EAX
+@@lstore:		MOV				W_PTR [ RCX ], R10W
+				PipeNext
+				DEC				RBP
+				JNZ				@@lsb
+				JMP				@@opdone
+				Stack_End		pipe_run_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			to_hex_u	-	write a 512 bit value as 128 hex digits
+;			Prototype:		void to_hex_u( char* text, u64* source );
+;			text		-	Address of room for 128 characters, any alignment; no terminator written (in RCX)
+;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	nothing (0)
+;			Note:	lower case, word 0 first, each word most significant digit first: the value as printed. HexOut: Z, Y and X
+;					look the digits up by nibble (PSHUFB, VPERMI2B placing the nibbles on Z); Q, SWAR in GPRs
+
+				Leaf_Entry		to_hex_u, ui512
+				CheckAlign		RDX								; (IN) source
+				HexOut			RCX, RDX
+				RetV
+				Leaf_End		to_hex_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			from_hex_u	-	read a 512 bit value from 128 hex digits
+;			Prototype:		s16 from_hex_u( u64* destination, char* text );
+;			destination	-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			text		-	Address of 128 hex digits, either case, any alignment, as to_hex_u writes them (in RDX)
+;			returns		-	-1 if all are hex digits; otherwise the index of the first that is not (destination then incomplete)
+;			Note:	HexIn: Z, Y and X check and convert 128, 32 or 16 characters at a time; Q, one at a time
+
+				Leaf_Entry		from_hex_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				HexIn			RCX, RDX, @@bad
+				MOV				EAX, retcode_neg_one
+@@bad:			RetV
+				Leaf_End		from_hex_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			to_bin_u	-	write a 512 bit value as 512 binary digits
+;			Prototype:		void to_bin_u( char* text, u64* source );
+;			text		-	Address of room for 512 characters, any alignment; no terminator written (in RCX)
+;			source		-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	nothing (0)
+;			Note:	character i is '1' if bit 511 - i is set (bits numbered as msb_u, lsb_u), so bit 511 first
+
+				Leaf_Entry		to_bin_u, ui512
+				CheckAlign		RDX								; (IN) source
+				BinOut			RCX, RDX
+				RetV
+				Leaf_End		to_bin_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			from_bin_u	-	read a 512 bit value from 512 binary digits
+;			Prototype:		s16 from_bin_u( u64* destination, char* text );
+;			destination	-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			text		-	Address of 512 characters '0' or '1', any alignment, as to_bin_u writes them (in RDX)
+;			returns		-	-1 if all are binary digits; otherwise the index of the first that is not (destination then incomplete)
+
+				Leaf_Entry		from_bin_u, ui512
+				CheckAlign		RCX								; (OUT) destination
+				BinIn			RCX, RDX, @@bad
+				MOV				EAX, retcode_neg_one
+@@bad:			RetV
+				Leaf_End		from_bin_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			to_hex_n	-	write n 512 bit values as hex text
+;			Prototype:		void to_hex_n( char* text, u64* sources, u64 n, u64 stride );
+;			text		-	Address of room for the text of n values, stride characters apart (in RCX)
+;			sources		-	Address of 64 byte aligned array of n 512 bit values (in RDX)
+;			n			-	Number of values (in R8)
+;			stride		-	Characters from one value's text to the next, 128 or more (in R9)
+;			returns		-	nothing (0)
+;			Note:	as to_hex_u for each value. Characters between one value's digits and the next (a separator, a line end) are
+;					left as they are, so a buffer can be set up once and filled batch after batch, nothing allocated
+
+				Leaf_Entry		to_hex_n, ui512
+				PUSH			RSI								; non-volatile, need the regs, so save the values
+				PUSH			RDI
+				MOV				RSI, R8							; values left
+				MOV				RDI, R9							; stride
+				TEST			RSI, RSI
+				JZ				@@done
+@@next:			CheckAlign		RDX								; (IN) source
+				HexOut			RCX, RDX
+				ADD				RCX, RDI
+				ADD				RDX, 64
+				DEC				RSI
+				JNZ				@@next
+@@done:			POP				RDI
+				POP				RSI
+				RetV
+				Leaf_End		to_hex_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			from_hex_n	-	read n 512 bit values from hex text
+;			Prototype:		u64 from_hex_n( u64* destinations, char* text, u64 n, u64 stride );
+;			destinations -	Address of 64 byte aligned array of room for n 512 bit values (in RCX)
+;			text		-	Address of the text of n values, 128 hex digits each, stride characters apart (in RDX)
+;			n			-	Number of values (in R8)
+;			stride		-	Characters from one value's text to the next, 128 or more (in R9)
+;			returns		-	number of values read: n, or the index of the first whose text has a character not a hex digit
+
+				Leaf_Entry		from_hex_n, ui512
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				RBX, R8							; n
+				MOV				RDI, R9							; stride
+				XOR				ESI, ESI						; values read
+@@next:			CMP				RSI, RBX
+				JAE				@@done
+				CheckAlign		RCX								; (OUT) destination
+				HexIn			RCX, RDX, @@done
+				ADD				RCX, 64
+				ADD				RDX, RDI
+				INC				RSI
+				JMP				@@next
+@@done:			MOV				RAX, RSI
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Leaf_End		from_hex_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			to_bin_n	-	write n 512 bit values as binary text
+;			Prototype:		void to_bin_n( char* text, u64* sources, u64 n, u64 stride );
+;			text		-	Address of room for the text of n values, stride characters apart (in RCX)
+;			sources		-	Address of 64 byte aligned array of n 512 bit values (in RDX)
+;			n			-	Number of values (in R8)
+;			stride		-	Characters from one value's text to the next, 512 or more (in R9)
+;			returns		-	nothing (0)
+;			Note:	as to_bin_u for each value; characters between one value's digits and the next left as they are
+
+				Leaf_Entry		to_bin_n, ui512
+				PUSH			RSI								; non-volatile, need the regs, so save the values
+				PUSH			RDI
+				MOV				RSI, R8							; values left
+				MOV				RDI, R9							; stride
+				TEST			RSI, RSI
+				JZ				@@done
+@@next:			CheckAlign		RDX								; (IN) source
+				BinOut			RCX, RDX
+				ADD				RCX, RDI
+				ADD				RDX, 64
+				DEC				RSI
+				JNZ				@@next
+@@done:			POP				RDI
+				POP				RSI
+				RetV
+				Leaf_End		to_bin_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			from_bin_n	-	read n 512 bit values from binary text
+;			Prototype:		u64 from_bin_n( u64* destinations, char* text, u64 n, u64 stride );
+;			destinations -	Address of 64 byte aligned array of room for n 512 bit values (in RCX)
+;			text		-	Address of the text of n values, 512 binary digits each, stride characters apart (in RDX)
+;			n			-	Number of values (in R8)
+;			stride		-	Characters from one value's text to the next, 512 or more (in R9)
+;			returns		-	number of values read: n, or the index of the first whose text has a character not '0' or '1'
+
+				Leaf_Entry		from_bin_n, ui512
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				RBX, R8							; n
+				MOV				RDI, R9							; stride
+				XOR				ESI, ESI						; values read
+@@next:			CMP				RSI, RBX
+				JAE				@@done
+				CheckAlign		RCX								; (OUT) destination
+				BinIn			RCX, RDX, @@done
+				ADD				RCX, 64
+				ADD				RDX, RDI
+				INC				RSI
+				JMP				@@next
+@@done:			MOV				RAX, RSI
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Leaf_End		from_bin_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			is_zero_u	-	test whether a is zero
+;			Prototype:		s16 is_zero_u( u64* a );
+;			a			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			returns		-	1 if a is zero, 0 if not
+;			Note:	msb_u( a ) == -1 without the scan for the index: Pred512, all words at once, to a flag
+
+				Leaf_Entry		is_zero_u, ui512
+				CheckAlign		RCX								; (IN) a
+				Pred512			PredZero, RCX, RCX
+				SETC			AL
+				MOVZX			EAX, AL
+				RetV
+				Leaf_End		is_zero_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			eq_u		-	test whether a equals b
+;			Prototype:		s16 eq_u( u64* a, u64* b );
+;			a			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			b			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	1 if a equals b, 0 if not
+;			Note:	compare_u for equality alone, without the index of the first differing word
+
+				Leaf_Entry		eq_u, ui512
+				CheckAlign		RCX								; (IN) a
+				CheckAlign		RDX								; (IN) b
+				Pred512			PredEq, RCX, RDX
+				SETC			AL
+				MOVZX			EAX, AL
+				RetV
+				Leaf_End		eq_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			subset_u	-	test whether every bit set in a is set in b
+;			Prototype:		s16 subset_u( u64* a, u64* b );
+;			a			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			b			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	1 if a is a subset of b, 0 if not
+;			Note:	a AND NOT b is 0
+
+				Leaf_Entry		subset_u, ui512
+				CheckAlign		RCX								; (IN) a
+				CheckAlign		RDX								; (IN) b
+				Pred512			PredSubset, RCX, RDX
+				SETC			AL
+				MOVZX			EAX, AL
+				RetV
+				Leaf_End		subset_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			intersects_u	-	test whether a and b have a set bit in common
+;			Prototype:		s16 intersects_u( u64* a, u64* b );
+;			a			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RCX)
+;			b			-	Address of 64 byte aligned array of 8 64-bit words (QWORDS) 512 bits (in RDX)
+;			returns		-	1 if a and b intersect, 0 if not
+;			Note:	a AND b is not 0
+
+				Leaf_Entry		intersects_u, ui512
+				CheckAlign		RCX								; (IN) a
+				CheckAlign		RDX								; (IN) b
+				Pred512			PredIntersects, RCX, RDX
+				SETC			AL
+				MOVZX			EAX, AL
+				RetV
+				Leaf_End		intersects_u, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			is_zero_n	-	test which of an array of 512bit records are zero, a bit for each
+;			Prototype:		u64 is_zero_n( u64* bits, u64* a, u64 n );
+;			bits		-	Address of (n + 63) / 64 QWORDS, bit i mod 64 of QWORD i / 64 set if record i is zero (in RCX)
+;			a			-	Address of 64 byte aligned array of n 512 bit records (in RDX)
+;			n			-	Number of records (in R8)
+;			returns		-	number of records that are zero
+;			Note:	as is_zero_u for each record; the result rotated into the top of the QWORD of results, as match_bits_n
+
+				Leaf_Entry		is_zero_n, ui512
+				CheckAlign		RDX								; (IN) a
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				R10, RCX						; bits
+				MOV				R9, R8							; n
+				MOV				R8, RDX							; b, not read
+				XOR				ECX, ECX
+				PredBits		PredZero
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Leaf_End		is_zero_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			eq_n		-	test which of an array of 512bit records equal their b, a bit for each
+;			Prototype:		u64 eq_n( u64* bits, u64* a, u64* b, u64 n, u64 b_stride );
+;			bits		-	Address of (n + 63) / 64 QWORDS, bit i mod 64 of QWORD i / 64 set if a[ i ] equals b (in RCX)
+;			a			-	Address of 64 byte aligned array of n 512 bit records (in RDX)
+;			b			-	Address of 64 byte aligned 512 bit values, one for each record or one for all (in R8)
+;			n			-	Number of records (in R9)
+;			b_stride	-	Bytes from one b to the next: 64, an array of n, or 0, the one value tested with every record (on stack)
+;			returns		-	number of records for which it holds
+;			Note:	as eq_u for each record; the result rotated into the top of the QWORD of results, as match_bits_n
+
+				Stack_Entry		eq_n, ui512
+				CheckAlign		RDX								; (IN) a
+				CheckAlign		R8								; (IN) b
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				R10, RCX						; bits
+				MOV				RCX, Q_PTR [ RSP ] [ 8 * 8 ]	; b_stride (fifth parameter)
+				PredBits		PredEq
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		eq_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			subset_n	-	test which of an array of 512bit records subsets of their b, a bit for each
+;			Prototype:		u64 subset_n( u64* bits, u64* a, u64* b, u64 n, u64 b_stride );
+;			bits		-	Address of (n + 63) / 64 QWORDS, bit i mod 64 of QWORD i / 64 set if a[ i ] AND NOT b is 0 (in RCX)
+;			a			-	Address of 64 byte aligned array of n 512 bit records (in RDX)
+;			b			-	Address of 64 byte aligned 512 bit values, one for each record or one for all (in R8)
+;			n			-	Number of records (in R9)
+;			b_stride	-	Bytes from one b to the next: 64, an array of n, or 0, the one value tested with every record (on stack)
+;			returns		-	number of records for which it holds
+;			Note:	as subset_u for each record; the result rotated into the top of the QWORD of results, as match_bits_n
+
+				Stack_Entry		subset_n, ui512
+				CheckAlign		RDX								; (IN) a
+				CheckAlign		R8								; (IN) b
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				R10, RCX						; bits
+				MOV				RCX, Q_PTR [ RSP ] [ 8 * 8 ]	; b_stride (fifth parameter)
+				PredBits		PredSubset
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		subset_n, ui512
+
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			intersects_n	-	test which of an array of 512bit records share a set bit with their b, a bit for each
+;			Prototype:		u64 intersects_n( u64* bits, u64* a, u64* b, u64 n, u64 b_stride );
+;			bits		-	Address of (n + 63) / 64 QWORDS, bit i mod 64 of QWORD i / 64 set if a[ i ] AND b is not 0 (in RCX)
+;			a			-	Address of 64 byte aligned array of n 512 bit records (in RDX)
+;			b			-	Address of 64 byte aligned 512 bit values, one for each record or one for all (in R8)
+;			n			-	Number of records (in R9)
+;			b_stride	-	Bytes from one b to the next: 64, an array of n, or 0, the one value tested with every record (on stack)
+;			returns		-	number of records for which it holds
+;			Note:	as intersects_u for each record; the result rotated into the top of the QWORD of results, as match_bits_n
+
+				Stack_Entry		intersects_n, ui512
+				CheckAlign		RDX								; (IN) a
+				CheckAlign		R8								; (IN) b
+				PUSH			RBX								; non-volatile, need the regs, so save the values
+				PUSH			RSI
+				PUSH			RDI
+				MOV				R10, RCX						; bits
+				MOV				RCX, Q_PTR [ RSP ] [ 8 * 8 ]	; b_stride (fifth parameter)
+				PredBits		PredIntersects
+				POP				RDI
+				POP				RSI
+				POP				RBX
+				RetV
+				Stack_End		intersects_n, ui512
+
+ui512T			SEGMENT			'RODATA' ALIGN (8)
+				QWORD			0, 0							; end of instrument_table_u
+ui512T			ENDS
+
 END
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+
+#ifndef perfcounters_h
+#define perfcounters_h
+
+//		perfcounters.h
+//
+//		File:			perfcounters.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		Hardware performance counters for ui512bBench, from perf_event_open (Linux): cycles, instructions, branch misses,
+//		L1D read misses, and with ports, the uops dispatched to each execution port. The port events (A1h) differ by core, so they
+//		are only opened where CPUID names a core whose unit masks are listed here (Intel Haswell to Comet Lake, Ice Lake to Rocket
+//		Lake, Sapphire and Emerald Rapids); elsewhere, AMD included, ports_note() says they were left out.
+//		Each counter is opened alone (not as a group), so any the host or container refuses are left out and the rest still count;
+//		if the kernel multiplexes them, counts are scaled by time enabled / time running. Elsewhere (Windows), none are available.
+
+#include <string>
+#include <vector>
+
+#include "CommonTypeDefs.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cpuid.h>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+class perf_counters
+{
+public:
+	struct counter
+	{
+		std::string name;
+		int fd;
+		u64 value;														// last start to stop, scaled
+	};
+
+	perf_counters() = default;
+	~perf_counters() { close(); }
+	perf_counters(const perf_counters&) = delete;
+	perf_counters& operator=(const perf_counters&) = delete;
+
+	// open those available; returns how many. why() says why there are none
+	size_t open(bool ports)
+	{
+		close();
+#ifdef __linux__
+		add("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		add("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		add("branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+		add("l1d_misses", PERF_TYPE_HW_CACHE,
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+		if (ports)
+		{
+			const char* const* names = port_names();
+			if (names != nullptr)
+			{
+				for (int p = 0; p < 8; p++)
+					if (names[p] != nullptr)
+						add(std::string("uops_port_") + names[p], PERF_TYPE_RAW, 0xA1 | (u64(1) << (8 + p)));
+			}
+			else
+				port_reason = "per port uops not counted: event A1h unit masks not known for this CPU";
+		};
+		if (counters.empty())
+			reason = "perf_event_open refused (" + std::string(strerror(last_errno))
+				+ "): not permitted here (perf_event_paranoid, container seccomp) or no PMU";
+#else
+		(void)ports;
+		reason = "hardware counters are read with perf_event_open, on Linux only";
+#endif
+		return counters.size();
+	};
+
+	void start()
+	{
+#ifdef __linux__
+		for (counter& c : counters)
+		{
+			ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+		};
+#endif
+	};
+
+	void stop()
+	{
+#ifdef __linux__
+		for (counter& c : counters)
+			ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+		for (counter& c : counters)
+		{
+			u64 v[3]{};													// value, time enabled, time running
+			c.value = 0;
+			if (read(c.fd, v, sizeof(v)) == ssize_t(sizeof(v)) && v[2] != 0)
+				c.value = (v[2] < v[1]) ? u64(double(v[0]) * double(v[1]) / double(v[2])) : v[0];
+		};
+#endif
+	};
+
+	void close()
+	{
+#ifdef __linux__
+		for (counter& c : counters)
+			::close(c.fd);
+#endif
+		counters.clear();
+		port_reason.clear();
+	};
+
+	const std::vector<counter>& list() const { return counters; };
+	const std::string& why() const { return reason; };
+	const std::string& ports_note() const { return port_reason; };		// why --ports counted nothing, else empty
+
+	// value of the named counter, -1 if not open
+	double get(const char* name) const
+	{
+		for (const counter& c : counters)
+			if (c.name == name)
+				return double(c.value);
+		return -1;
+	};
+
+private:
+#ifdef __linux__
+	// The port of each unit mask bit of event A1h (UOPS_DISPATCHED.PORT_*, on Haswell and Broadwell UOPS_EXECUTED_PORT.PORT_*),
+	// by CPUID family 6 model; nullptr for a core not listed (another vendor, family, or an untried model, hybrid cores
+	// included). Ice Lake and later count some ports in pairs, and have no port for bit 3.
+	static const char* const* port_names()
+	{
+		static const char* const haswell[8]{ "0", "1", "2", "3", "4", "5", "6", "7" };
+		static const char* const icelake[8]{ "0", "1", "2_3", nullptr, "4_9", "5", "6", "7_8" };
+		static const char* const goldencove[8]{ "0", "1", "2_3_10", nullptr, "4_9", "5_11", "6", "7_8" };
+		u32 a = 0, b = 0, c = 0, d = 0;
+		if (__get_cpuid(0, &a, &b, &c, &d) == 0 || b != 0x756E6547 || d != 0x49656E69 || c != 0x6C65746E)	// "GenuineIntel"
+			return nullptr;
+		__get_cpuid(1, &a, &b, &c, &d);
+		const u32 family = (a >> 8) & 0xF;
+		const u32 model = ((a >> 4) & 0xF) | ((a >> 12) & 0xF0);
+		if (family != 6)
+			return nullptr;
+		switch (model)
+		{
+		case 0x3C: case 0x3F: case 0x45: case 0x46:					// Haswell
+		case 0x3D: case 0x47: case 0x4F: case 0x56:					// Broadwell
+		case 0x4E: case 0x5E: case 0x55:							// Skylake, Skylake-SP / Cascade Lake / Cooper Lake
+		case 0x8E: case 0x9E: case 0xA5: case 0xA6:					// Kaby, Coffee, Whiskey, Comet Lake
+			return haswell;
+		case 0x7D: case 0x7E: case 0x6A: case 0x6C:					// Ice Lake, Ice Lake-SP
+		case 0x8C: case 0x8D: case 0xA7:							// Tiger Lake, Rocket Lake
+			return icelake;
+		case 0x8F: case 0xCF:										// Sapphire Rapids, Emerald Rapids
+			return goldencove;
+		default:
+			return nullptr;
+		};
+	};
+
+	void add(const std::string& name, u32 type, u64 config)
+	{
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		const int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));	// this thread, any CPU
+		if (fd < 0)
+		{
+			last_errno = errno;
+			return;
+		};
+		counters.push_back(counter{ name, fd, 0 });
+	};
+
+	int last_errno = 0;
+#endif
+
+	std::vector<counter> counters;
+	std::string reason;
+	std::string port_reason;
+};
+
+#endif//		perfcounters_h
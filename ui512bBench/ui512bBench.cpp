@@ -0,0 +1,752 @@
+//
+//		File:			ui512bBench.cpp
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//			Notes:
+//				Microbenchmarks of the ui512b procs, replacing the *_timing methods of ui512bTests (which ran a loop and logged its count).
+//
+//				For each proc, and inputs swept where they change the work (fixed or random shift counts; dense or sparse values
+//				for the bit scans), it reports:
+//					latency		-	each call depends on the one before (its result is the next input, or picks the next input)
+//					throughput	-	calls on independent inputs, cycling through 16 of them
+//				in ns and in TSC cycles per call (and per item for the procs over arrays): the median and the best of 'reps' runs,
+//				each about 'ms' milliseconds, after a calibration run. The thread is pinned to one CPU, at high priority.
+//
+//				The ISA path (Z, Y, X, Q) is fixed when ui512b.asm is assembled (compile_time_options.inc), and reported by options_u:
+//				to compare paths, assemble each, run, and keep each JSON file (named by path unless --out is given).
+//
+//				With --counters (--ports adds uops per execution port), one more run of each is counted by the hardware counters
+//				(perfcounters.h) and reported per call: cycles, instructions, branch misses, L1D misses, uops per port, and IPC.
+//				Where counters cannot be opened (Windows, a container without perf_event_open, a VM with no PMU) the bench
+//				says why once and reports timings only.
+//
+//				The vector policy section (set_vector_policy_u) runs scalar work with a few calls now and then, wide (ZMM) and light
+//				(GPR, 256 bit): where AVX-512 lowers the core clock, the scalar work slows too when wide; with counters, ghz shows it.
+//
+//			Usage:		ui512bBench [--cpu n] [--ms n] [--reps n] [--filter text] [--out file.json] [--counters] [--ports]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <intrin.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+#include "perfcounters.h"
+#include "ui512arena.h"
+#include "ui512b.h"
+#include "ui512bitmap.h"
+#include "ui512file.h"
+#include "ui512pipe.h"
+#include "uiN.h"
+
+using namespace std;
+
+namespace
+{
+	struct result
+	{
+		string proc;
+		string input;
+		string mode;					// latency, throughput
+		u64 items;						// items (records, keys, values) per call
+		double ns;						// median per call
+		double ns_best;
+		double cycles;					// median per call, TSC cycles
+		double cycles_best;
+		vector<pair<string, double>> counters;	// per call (ipc: instructions / cycles); empty without counters
+	};
+
+	struct bench
+	{
+		vector<result> results;
+		string filter;
+		double target_ns = 20e6;
+		int reps = 7;
+		perf_counters* pmc = nullptr;	// open counters, or none
+
+		// time f(i) for i from 0, calibrating the count to about target_ns a run
+		template<class F>
+		void run(const char* proc, const char* input, const char* mode, u64 items, F&& f)
+		{
+			if (!filter.empty() && string(proc).find(filter) == string::npos)
+				return;
+			u64 n = 1;
+			for (;;)
+			{
+				const double t = timed(n, f).first;
+				if (t >= target_ns / 10 || n >= (1ull << 32))
+				{
+					n = max<u64>(1, u64(double(n) * target_ns / max(t, 1.0)));
+					break;
+				};
+				n *= 2;
+			};
+			vector<double> ns, cyc;
+			for (int r = 0; r < reps; r++)
+			{
+				const pair<double, double> t = timed(n, f);
+				ns.push_back(t.first / double(n));
+				cyc.push_back(t.second / double(n));
+			};
+			sort(ns.begin(), ns.end());
+			sort(cyc.begin(), cyc.end());
+			results.push_back(result{ proc, input, mode, items, ns[ns.size() / 2], ns[0], cyc[cyc.size() / 2], cyc[0], {} });
+			result& x = results.back();
+			if (pmc != nullptr)
+				x.counters = counted(n, f);
+			printf("%-22s %-14s %-10s %12.2f ns %12.1f cyc", proc, input, mode, x.ns, x.cycles);
+			if (items > 1)
+				printf("   %8.3f ns/item", x.ns / double(items));
+			for (const pair<string, double>& c : x.counters)
+				if (c.first == "ipc" || c.first == "ghz" || c.first == "branch_misses" || c.first == "l1d_misses")
+					printf("   %s %.3f", c.first.c_str(), c.second);
+			printf("\n");
+		};
+
+		// one more run of n, counted: each counter per call, then IPC, and the core clock (cycles per ns) it ran at
+		template<class F>
+		vector<pair<string, double>> counted(u64 n, F& f)
+		{
+			const auto t0 = chrono::steady_clock::now();
+			pmc->start();
+			for (u64 i = 0; i < n; i++)
+				f(i);
+			pmc->stop();
+			const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+			vector<pair<string, double>> per;
+			for (const perf_counters::counter& c : pmc->list())
+				per.emplace_back(c.name, double(c.value) / double(n));
+			const double cycles = pmc->get("cycles");
+			const double instructions = pmc->get("instructions");
+			if (cycles > 0 && instructions >= 0)
+				per.emplace_back("ipc", instructions / cycles);
+			if (cycles > 0 && ns > 0)
+				per.emplace_back("ghz", cycles / ns);
+			return per;
+		};
+
+		template<class F>
+		static pair<double, double> timed(u64 n, F& f)
+		{
+			const auto t0 = chrono::steady_clock::now();
+			const u64 c0 = __rdtsc();
+			for (u64 i = 0; i < n; i++)
+				f(i);
+			const u64 c1 = __rdtsc();
+			const auto t1 = chrono::steady_clock::now();
+			return { chrono::duration<double, nano>(t1 - t0).count(), double(c1 - c0) };
+		};
+	};
+
+	volatile u64 sink = 0;								// results are summed here, so no call is left out
+
+	u64 RandomU64(u64* seed)							// as ui512bTests
+	{
+		const u64 m = 18446744073709551557ull;
+		const u64 a = 68719476721ull;
+		const u64 c = 268435399ull;
+		*seed = (*seed == 0ull) ? (a * 4294967291ull + c) % m : (a * *seed + c) % m;
+		return *seed;
+	};
+
+	void Fill(u64* p, u64 qwords, u64* seed)
+	{
+		for (u64 i = 0; i < qwords; i++)
+			p[i] = RandomU64(seed);
+	};
+
+	bool KeyLess(const u64* a, const u64* b)
+	{
+		for (int j = 0; j < 8; j++)
+			if (a[j] != b[j])
+				return a[j] < b[j];
+		return false;
+	};
+
+	// n distinct keys, ascending
+	void SortedKeys(u64* keys, u64 n, u64* seed)
+	{
+		vector<u64> work(n * 8);
+		Fill(work.data(), n * 8, seed);
+		vector<u64> order(n);
+		for (u64 i = 0; i < n; i++) order[i] = i;
+		sort(order.begin(), order.end(), [&work](u64 a, u64 b) { return KeyLess(&work[a * 8], &work[b * 8]); });
+		for (u64 i = 0; i < n; i++)
+			memcpy(&keys[i * 8], &work[order[i] * 8], 64);
+	};
+
+	// scalar work between sporadic calls: a dependent chain of multiply, shift, xor
+	u64 Scalar(u64 x, int steps)
+	{
+		for (int s = 0; s < steps; s++)
+		{
+			x = x * 6364136223846793005ull + 1442695040888963407ull;
+			x ^= x >> 29;
+		};
+		return x;
+	};
+
+	// SSE (scalar double) code, as after a call: slowed if a proc leaves the upper halves of YMM registers dirty
+	double Sse(double x)
+	{
+		for (int s = 0; s < 16; s++)
+			x = x * 0.9999999 + 1e-7;
+		return x;
+	};
+
+	string json_escape(const string& s)
+	{
+		string r;
+		for (char c : s)
+		{
+			if (c == '"' || c == '\\') r += '\\';
+			r += c;
+		};
+		return r;
+	};
+
+	string counters_note = "not requested (--counters)";
+
+	void write_json(const bench& b, const char* path, u32 options, int cpu, double tsc_ghz)
+	{
+		FILE* f = nullptr;
+#ifdef _WIN32
+		if (fopen_s(&f, path, "w") != 0)
+			f = nullptr;
+#else
+		f = fopen(path, "w");
+#endif
+		if (f == nullptr)
+		{
+			printf("cannot write %s\n", path);
+			return;
+		};
+		const long long when = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+		fprintf(f, "{\n  \"suite\": \"ui512bBench\",\n  \"isa\": \"%c\",\n  \"bmi2\": %s,\n  \"check_align\": %s,\n",
+			OPTIONS_ISA(options), (options & OPTIONS_BMI2) ? "true" : "false", (options & OPTIONS_CHECKALIGN) ? "true" : "false");
+		fprintf(f, "  \"unix_time\": %lld,\n  \"cpu\": %d,\n  \"tsc_ghz\": %.4f,\n  \"reps\": %d,\n",
+			when, cpu, tsc_ghz, b.reps);
+		if (b.pmc != nullptr)
+			fprintf(f, "  \"counters\": true,\n");
+		else
+			fprintf(f, "  \"counters\": false,\n  \"counters_note\": \"%s\",\n", json_escape(counters_note).c_str());
+		fprintf(f, "  \"results\": [\n");
+		for (size_t i = 0; i < b.results.size(); i++)
+		{
+			const result& r = b.results[i];
+			fprintf(f, "    { \"proc\": \"%s\", \"input\": \"%s\", \"mode\": \"%s\", \"items\": %llu, "
+				"\"ns\": %.3f, \"ns_best\": %.3f, \"cycles\": %.2f, \"cycles_best\": %.2f, \"ns_per_item\": %.4f",
+				json_escape(r.proc).c_str(), json_escape(r.input).c_str(), r.mode.c_str(), (unsigned long long)r.items,
+				r.ns, r.ns_best, r.cycles, r.cycles_best, r.ns / double(r.items));
+			if (!r.counters.empty())
+			{
+				fprintf(f, ", \"counters\": {");
+				for (size_t c = 0; c < r.counters.size(); c++)
+					fprintf(f, "%s \"%s\": %.4f", (c == 0) ? "" : ",", r.counters[c].first.c_str(), r.counters[c].second);
+				fprintf(f, " }");
+			};
+			fprintf(f, " }%s\n", (i + 1 < b.results.size()) ? "," : "");
+		};
+		fprintf(f, "  ]\n}\n");
+		fclose(f);
+	};
+
+	// this thread on one CPU, at high priority (on Linux, if permitted)
+	void PinThread(int cpu)
+	{
+#ifdef _WIN32
+		SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#else
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		sched_setaffinity(0, sizeof(set), &set);
+		setpriority(PRIO_PROCESS, 0, -10);								// 0: the calling thread
+#endif
+	};
+
+	double TscGHz()
+	{
+		const auto t0 = chrono::steady_clock::now();
+		const u64 c0 = __rdtsc();
+		while (chrono::steady_clock::now() - t0 < chrono::milliseconds(100)) {};
+		const u64 c1 = __rdtsc();
+		return double(c1 - c0) / chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+	};
+
+	const u64 K = 16;									// independent inputs for throughput
+	const char* LAT = "latency";
+	const char* TPUT = "throughput";
+}
+
+int main(int argc, char** argv)
+{
+	bench b;
+	int cpu = 1;
+	string out;
+	bool counters = false;
+	bool ports = false;
+	for (int a = 1; a < argc; a++)
+	{
+		const string arg = argv[a];
+		const char* next = (a + 1 < argc) ? argv[a + 1] : "";
+		if (arg == "--cpu") { cpu = atoi(next); a++; }
+		else if (arg == "--ms") { b.target_ns = atof(next) * 1e6; a++; }
+		else if (arg == "--reps") { b.reps = max(1, atoi(next)); a++; }
+		else if (arg == "--filter") { b.filter = next; a++; }
+		else if (arg == "--out") { out = next; a++; }
+		else if (arg == "--counters") counters = true;
+		else if (arg == "--ports") counters = ports = true;
+		else
+		{
+			printf("usage: ui512bBench [--cpu n] [--ms n] [--reps n] [--filter text] [--out file.json] [--counters] [--ports]\n");
+			return 1;
+		};
+	};
+
+	PinThread(cpu);
+	const u32 options = options_u();
+	const double ghz = TscGHz();
+	if (out.empty())
+		out = string("ui512bBench_") + OPTIONS_ISA(options) + ".json";
+	printf("ui512bBench: path %c%s, cpu %d, TSC %.3f GHz\n", OPTIONS_ISA(options), (options & OPTIONS_BMI2) ? " BMI2" : "", cpu, ghz);
+	perf_counters pmc;
+	if (counters)
+	{
+		if (pmc.open(ports) != 0)
+		{
+			b.pmc = &pmc;
+			printf("counters:");
+			for (const perf_counters::counter& c : pmc.list())
+				printf(" %s", c.name.c_str());
+			printf("\n");
+			if (!pmc.ports_note().empty())
+				printf("%s\n", pmc.ports_note().c_str());
+		}
+		else
+		{
+			counters_note = pmc.why();
+			printf("counters unavailable, timings only: %s\n", counters_note.c_str());
+		};
+	};
+
+	u64 seed = 0;
+	alignas (64) static u64 in[K * 8]{};				// dense: random
+	alignas (64) static u64 sparse[K * 8]{};			// one bit set in each
+	alignas (64) static u64 in2[K * 8]{};
+	alignas (64) static u64 dst[K * 8]{};
+	alignas (64) static u64 dst2[K * 8]{};
+	alignas (64) u64 v[8]{};
+	alignas (64) u64 w[8]{};
+	u16 shifts[256]{};
+	Fill(in, K * 8, &seed);
+	Fill(in2, K * 8, &seed);
+	for (u64 i = 0; i < K; i++)
+	{
+		const u64 bit = RandomU64(&seed) % 512;
+		sparse[i * 8 + 7 - bit / 64] = 1ull << (bit % 64);
+	};
+	for (int i = 0; i < 256; i++)
+		shifts[i] = u16(RandomU64(&seed) % 512);
+	memcpy(v, in, 64);
+	s64 r = 0;
+	u64 acc = 0;
+	double d = 1.0;
+
+	// shifts: fixed or random counts
+	for (const bool random : { false, true })
+	{
+		const char* input = random ? "random bits" : "100 bits";
+		auto bits = [&](u64 i) { return random ? shifts[i & 255] : u16(100); };
+		b.run("shr_u", input, LAT, 1, [&](u64 i) { shr_u(v, v, bits(i)); v[0] |= 1; });
+		b.run("shr_u", input, TPUT, 1, [&](u64 i) { shr_u(&dst[(i % K) * 8], &in[(i % K) * 8], bits(i)); });
+		b.run("shl_u", input, LAT, 1, [&](u64 i) { shl_u(v, v, bits(i)); v[7] |= 1; });
+		b.run("shl_u", input, TPUT, 1, [&](u64 i) { shl_u(&dst[(i % K) * 8], &in[(i % K) * 8], bits(i)); });
+		b.run("shl_insert_u", input, LAT, 1, [&](u64 i) { shl_insert_u(v, v, u16(bits(i) % 65), i); });
+		b.run("shl_insert_u", input, TPUT, 1, [&](u64 i) { shl_insert_u(&dst[(i % K) * 8], &in[(i % K) * 8], u16(bits(i) % 65), i); });
+		b.run("shr_insert_u", input, TPUT, 1, [&](u64 i) { shr_insert_u(&dst[(i % K) * 8], &in[(i % K) * 8], u16(bits(i) % 65), i); });
+	};
+
+	// shifts: every count, 0 to 511 in turn (in place for latency); and by the words moved, 0 to 7 (plus 37 bits)
+	b.run("shr_u", "0 to 511", LAT, 1, [&](u64 i) { shr_u(v, v, u16(i & 511)); v[0] |= 1; });
+	b.run("shr_u", "0 to 511", TPUT, 1, [&](u64 i) { shr_u(&dst[(i % K) * 8], &in[(i % K) * 8], u16(i & 511)); });
+	b.run("shl_u", "0 to 511", LAT, 1, [&](u64 i) { shl_u(v, v, u16(i & 511)); v[7] |= 1; });
+	b.run("shl_u", "0 to 511", TPUT, 1, [&](u64 i) { shl_u(&dst[(i % K) * 8], &in[(i % K) * 8], u16(i & 511)); });
+	for (u16 words = 0; words < 8; words++)
+	{
+		const string input = to_string(words) + " words";
+		const u16 bits = u16(words * 64 + 37);
+		b.run("shr_u", input.c_str(), TPUT, 1, [&](u64 i) { shr_u(&dst[(i % K) * 8], &in[(i % K) * 8], bits); });
+		b.run("shl_u", input.c_str(), TPUT, 1, [&](u64 i) { shl_u(&dst[(i % K) * 8], &in[(i % K) * 8], bits); });
+	};
+
+	// bitwise
+	b.run("and_u", "random", LAT, 1, [&](u64 i) { and_u(v, v, &in[(i % K) * 8]); v[3] = ~v[3]; });
+	b.run("and_u", "random", TPUT, 1, [&](u64 i) { and_u(&dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8]); });
+	b.run("or_u", "random", LAT, 1, [&](u64 i) { or_u(v, v, &in[(i % K) * 8]); v[3] = ~v[3]; });
+	b.run("or_u", "random", TPUT, 1, [&](u64 i) { or_u(&dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8]); });
+	b.run("xor_u", "random", LAT, 1, [&](u64 i) { xor_u(v, v, &in[(i % K) * 8]); });
+	b.run("xor_u", "random", TPUT, 1, [&](u64 i) { xor_u(&dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8]); });
+	b.run("not_u", "random", LAT, 1, [&](u64 i) { not_u(v, v); });
+	b.run("not_u", "random", TPUT, 1, [&](u64 i) { not_u(&dst[(i % K) * 8], &in[(i % K) * 8]); });
+
+	// bit scans and counts: dense or sparse values; latency through the next input chosen by the result
+	for (const bool sp : { false, true })
+	{
+		const char* input = sp ? "sparse" : "dense";
+		u64* src = sp ? sparse : in;
+		b.run("msb_u", input, LAT, 1, [&](u64 i) { r = msb_u(&src[((i + r) % K) * 8]); });
+		b.run("msb_u", input, TPUT, 1, [&](u64 i) { acc += msb_u(&src[(i % K) * 8]); });
+		b.run("lsb_u", input, LAT, 1, [&](u64 i) { r = lsb_u(&src[((i + r) % K) * 8]); });
+		b.run("lsb_u", input, TPUT, 1, [&](u64 i) { acc += lsb_u(&src[(i % K) * 8]); });
+		b.run("popcnt_u", input, LAT, 1, [&](u64 i) { r = popcnt_u(&src[((i + r) % K) * 8]); });
+		b.run("popcnt_u", input, TPUT, 1, [&](u64 i) { acc += popcnt_u(&src[(i % K) * 8]); });
+		b.run("rank_u", input, TPUT, 1, [&](u64 i) { acc += rank_u(&src[(i % K) * 8], shifts[i & 255]); });
+		b.run("select_u", input, LAT, 1, [&](u64 i) { r = select_u(&src[((i + r) % K) * 8], u16(i & 127)); });
+		b.run("select_u", input, TPUT, 1, [&](u64 i) { acc += select_u(&src[(i % K) * 8], u16(i & 127)); });
+		b.run("lcp_u", input, TPUT, 1, [&](u64 i) { acc += lcp_u(&src[(i % K) * 8], &in2[(i % K) * 8]); });
+		b.run("tanimoto_u", input, TPUT, 1, [&](u64 i) { acc += tanimoto_u(&src[(i % K) * 8], &in2[(i % K) * 8]); });
+		b.run("hash_u", input, LAT, 1, [&](u64 i) { r = s64(hash_u(&src[((i + r) % K) * 8])); });
+		b.run("hash_u", input, TPUT, 1, [&](u64 i) { acc += hash_u(&src[(i % K) * 8]); });
+	};
+
+	// arrays of records
+	{
+		const u64 n = 4096;
+		alignas (64) static u64 recs[n * 8]{};
+		alignas (64) static u64 counts[n + 1]{};
+		alignas (64) static u64 hints[n / 8 + 2]{};
+		alignas (64) static u16 pops[n]{};
+		alignas (64) static u64 idx[n]{};
+		alignas (64) u64 mask[8]{ 0, 0, 0xff, 0, 0, 0, 0, 0xf0 };
+		alignas (64) u64 pattern[8]{ 0, 0, 0x11, 0, 0, 0, 0, 0x80 };
+		alignas (64) static u64 masks[4 * 8]{};
+		alignas (64) static u64 patterns[4 * 8]{};
+		alignas (64) static u64 top[16]{};
+		Fill(recs, n * 8, &seed);
+		popcnt_n(pops, recs, n);
+		for (int p = 0; p < 4; p++)
+		{
+			masks[p * 8 + p] = 0xff;
+			patterns[p * 8 + p] = u64(p);
+		};
+		const u64 total = rsindex_n(counts, hints, recs, n);		// the streams, last, write over the records
+		b.run("rsindex_n", "random", TPUT, n, [&](u64 i) { acc += rsindex_n(counts, hints, recs, n); });
+		b.run("rank_n", "random", TPUT, 1, [&](u64 i) { acc += rank_n(counts, recs, (i * 0x9E3779B97F4A7C15ull) % (n * 512)); });
+		b.run("select_n", "random", TPUT, 1, [&](u64 i) { acc += select_n(counts, hints, recs, n, (i * 0x9E3779B97F4A7C15ull) % total); });
+		b.run("match_n", "random", TPUT, n, [&](u64 i) { acc += match_n(recs, n, mask, pattern, idx); });
+		b.run("match_bits_n", "random", TPUT, n, [&](u64 i) { acc += match_bits_n(recs, n, mask, pattern, idx); });
+		b.run("match_any_n", "4 patterns", TPUT, n, [&](u64 i) { acc += match_any_n(recs, n, masks, patterns, 4, idx); });
+		b.run("popcnt_n", "random", TPUT, n, [&](u64 i) { acc += popcnt_n(pops, recs, n); });
+		b.run("tanimoto_topk_n", "k 16", TPUT, n, [&](u64 i) { acc += tanimoto_topk_n(top, 16, &in[(i % K) * 8], recs, pops, n); });
+		b.run("shl_stream_n", "8 bits", TPUT, n / 8, [&](u64 i) { acc += shl_stream_n(recs, v, idx, n / 8, 8); });
+		b.run("shl_stream_match_n", "8 bits", TPUT, n, [&](u64 i) { acc += shl_stream_match_n(counts, v, idx, n, 8, mask, pattern); });
+	}
+
+	// Bloom filter
+	{
+		const u64 nblocks = 1024;
+		const u64 n = 4096;
+		alignas (64) static u64 filter[nblocks * 8]{};
+		alignas (64) static u64 hashes[n]{};
+		alignas (64) static u64 bits[n / 64]{};
+		Fill(hashes, n, &seed);
+		bloom_add_n(filter, nblocks, hashes, n, 8);
+		b.run("bloom_pattern_u", "k 8", TPUT, 1, [&](u64 i) { bloom_pattern_u(&dst[(i % K) * 8], i * 0x9E3779B97F4A7C15ull, 8); });
+		b.run("bloom_add_u", "k 8", TPUT, 1, [&](u64 i) { bloom_add_u(filter, nblocks, i * 0x9E3779B97F4A7C15ull, 8); });
+		b.run("bloom_test_u", "k 8", TPUT, 1, [&](u64 i) { acc += bloom_test_u(filter, nblocks, i * 0x9E3779B97F4A7C15ull, 8); });
+		b.run("bloom_add_n", "k 8", TPUT, n, [&](u64 i) { bloom_add_n(filter, nblocks, hashes, n, 8); });
+		b.run("bloom_test_n", "k 8", TPUT, n, [&](u64 i) { bloom_test_n(filter, nblocks, hashes, n, 8, bits); });
+	}
+
+	// crit-bit tree, radix sort, hash set
+	{
+		const u64 n = 4000;
+		alignas (64) static u64 keys[n * 8]{};
+		alignas (64) static u64 nodes[n * CRITBIT_LINE_QWORDS]{};
+		u64 first = 0;
+		SortedKeys(keys, n, &seed);
+		critbit_build_n(nodes, keys, n);
+		b.run("critbit_build_n", "random", TPUT, n, [&](u64 i) { acc += critbit_build_n(nodes, keys, n); });
+		b.run("critbit_find_n", "random", LAT, 1, [&](u64 i) { r = s64(critbit_find_n(nodes, keys, &keys[((i + r) % n) * 8])); });
+		b.run("critbit_find_n", "random", TPUT, 1, [&](u64 i) { acc += critbit_find_n(nodes, keys, &keys[(i * 2654435761ull % n) * 8]); });
+		b.run("critbit_lower_n", "random", TPUT, 1, [&](u64 i) { acc += critbit_lower_n(nodes, keys, &in[(i % K) * 8]); });
+		b.run("critbit_lcp_n", "random", TPUT, 1, [&](u64 i) { acc += critbit_lcp_n(nodes, &in[(i % K) * 8]); });
+		b.run("critbit_prefix_n", "12 bits", TPUT, 1, [&](u64 i) { acc += critbit_prefix_n(nodes, keys, &in[(i % K) * 8], 12, &first); });
+	}
+	{
+		const u64 n = 100000;
+		alignas (64) static u64 orig[n * 8]{};
+		alignas (64) static u64 keys[n * 8]{};
+		alignas (64) static u64 values[n]{};
+		alignas (64) static u64 index[n]{};
+		alignas (64) static u64 work[RADIX_WORK_QWORDS]{};
+		alignas (64) static u64 temp[n * 9]{};
+		Fill(orig, n * 8, &seed);
+		b.run("radix_sort_n", "random, copied in", TPUT, n, [&](u64 i) { memcpy(keys, orig, sizeof(keys)); acc += radix_sort_n(keys, n, temp, work); });
+		b.run("radix_sort_kv_n", "random, copied in", TPUT, n,
+			[&](u64 i) { memcpy(keys, orig, sizeof(keys)); acc += radix_sort_kv_n(keys, values, n, temp, work); });
+		b.run("radix_index_n", "random", TPUT, n, [&](u64 i) { acc += radix_index_n(index, orig, n, temp, work); });
+
+		const u64 cap = 1ull << 17;
+		alignas (64) static u8 tags[cap]{};
+		alignas (64) static u64 slots[cap * 8]{};
+		hset_insert_n(tags, slots, cap, orig, n, index);
+		b.run("hset_insert_n", "100000 new", TPUT, n, [&](u64 i) { memset(tags, 0, cap); acc += hset_insert_n(tags, slots, cap, orig, n, index); });
+		b.run("hset_find_n", "100000 found", TPUT, n, [&](u64 i) { acc += hset_find_n(tags, slots, cap, orig, n, index); });
+		b.run("hset_find_u", "found", LAT, 1, [&](u64 i) { r = s64(hset_find_u(tags, slots, cap, &orig[((i + r) % n) * 8])); });
+		b.run("hset_find_u", "found", TPUT, 1, [&](u64 i) { acc += hset_find_u(tags, slots, cap, &orig[(i * 2654435761ull % n) * 8]); });
+		b.run("hset_insert_u", "present", TPUT, 1, [&](u64 i) { acc += hset_insert_u(tags, slots, cap, &orig[(i * 2654435761ull % n) * 8]); });
+	}
+
+	// carry-less products, GF(2) matrices
+	{
+		alignas (64) u64 poly[8]{ 0, 0, 0, 0, 0, 0, 0, 0x425 };
+		alignas (64) u64 mu[8]{};
+		clmod_mu_u(mu, poly);
+		b.run("clmul_u", "random", LAT, 1, [&](u64 i) { clmul_u(w, v, v, &in[(i % K) * 8]); v[0] ^= w[7]; });
+		b.run("clmul_u", "random", TPUT, 1, [&](u64 i) { clmul_u(&dst2[(i % K) * 8], &dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8]); });
+		b.run("clmod_u", "random", TPUT, 1, [&](u64 i) { clmod_u(&dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8], poly, mu); });
+		b.run("clmod_mu_u", "random", TPUT, 1, [&](u64 i) { clmod_mu_u(mu, &in[(i % K) * 8]); });
+
+		alignas (64) static u64 m[512 * 8]{};
+		alignas (64) static u64 c[512 * 8]{};
+		alignas (64) static u64 work[BITMAT_WORK_QWORDS]{};
+		Fill(m, 512 * 8, &seed);
+		b.run("bitmat_transpose_n", "random", TPUT, 512, [&](u64 i) { bitmat_transpose_n(c, m); });
+		b.run("bitmat_vec_u", "random", LAT, 1, [&](u64 i) { bitmat_vec_u(v, v, m); v[7] |= 1; });
+		b.run("bitmat_mul_n", "512 rows", TPUT, 512, [&](u64 i) { bitmat_mul_n(c, m, 512, m, work); });
+	}
+
+	// packing
+	for (const u64 k : { 3ull, 12ull, 64ull })
+	{
+		const u64 n = 4096;
+		alignas (64) static u64 values[n]{};
+		alignas (64) static u64 blocks[n * 8]{};
+		alignas (64) static u64 out[n]{};
+		for (u64 i = 0; i < n; i++)
+			values[i] = RandomU64(&seed) & (k == 64 ? ~0ull : (1ull << k) - 1);
+		const string input = "k " + to_string(k);
+		b.run("pack_u", input.c_str(), TPUT, n, [&](u64 i) { acc += pack_u(blocks, values, n, k); });
+		b.run("unpack_u", input.c_str(), TPUT, n, [&](u64 i) { acc += unpack_u(out, blocks, n, k); });
+		b.run("unpack_filter_u", input.c_str(), TPUT, n, [&](u64 i) { acc += unpack_filter_u(out, blocks, n, k, 0, values[0]); });
+	}
+
+	// random values
+	{
+		const u64 n = 4096;
+		alignas (64) u64 state[RAND_STATE_QWORDS]{};
+		alignas (64) static u64 values[n * 8]{};
+		rand_seed_u(state, 1);
+		b.run("rand_u", "-", LAT, 1, [&](u64 i) { rand_u(v, state); });
+		b.run("rand_fill_n", "4096 values", TPUT, n, [&](u64 i) { rand_fill_n(values, state, n); });
+	}
+
+	// widths
+	{
+		ui<256> a256{}, r256{};
+		ui<1024> a1024{}, r1024{};
+		ui<2048> a2048{}, r2048{};
+		Fill(a256.w, 4, &seed);
+		Fill(a1024.w, 16, &seed);
+		Fill(a2048.w, 32, &seed);
+		b.run("shr256_u", "random bits", LAT, 1, [&](u64 i) { shr_u(r256, r256, u16(shifts[i & 255] % 256)); r256.w[0] |= 1; });
+		b.run("shr256_u", "random bits", TPUT, 1, [&](u64 i) { shr_u(r256, a256, u16(shifts[i & 255] % 256)); });
+		b.run("shl256_u", "random bits", TPUT, 1, [&](u64 i) { shl_u(r256, a256, u16(shifts[i & 255] % 256)); });
+		b.run("xor256_u", "random", TPUT, 1, [&](u64 i) { xor_u(r256, a256, r256); });
+		b.run("msb256_u", "random", TPUT, 1, [&](u64 i) { acc += msb_u(a256); });
+		b.run("ui<1024> shr_u", "random bits", TPUT, 1, [&](u64 i) { shr_u(r1024, a1024, u16(shifts[i & 255] * 2)); });
+		b.run("ui<2048> shr_u", "random bits", TPUT, 1, [&](u64 i) { shr_u(r2048, a2048, u16(shifts[i & 255] * 4)); });
+		b.run("ui<2048> msb_u", "random", TPUT, 1, [&](u64 i) { acc += msb_u(a2048); });
+	}
+
+	// vector policy (Z path): scalar work with sporadic single calls, and SSE (double) code after a call; policy restored after
+	{
+		const u32 policy = set_vector_policy_u(VECTOR_WIDE);
+		b.run("policy_scalar", "512 steps", TPUT, 1, [&](u64 i) { acc = Scalar(acc + i, 512); });
+		for (const u32 p : { VECTOR_WIDE, VECTOR_LIGHT })
+		{
+			set_vector_policy_u(p);
+			const char* input = (p == VECTOR_WIDE) ? "wide" : "light";
+			b.run("policy_sporadic", input, TPUT, 1, [&](u64 i)
+				{
+					acc = Scalar(acc + i, 512);
+					shr_u(&dst[(i % K) * 8], &in[(i % K) * 8], shifts[i & 255]);
+					and_u(&dst2[(i % K) * 8], &dst[(i % K) * 8], &in2[(i % K) * 8]);
+					acc += msb_u(&dst2[(i % K) * 8]);
+				});
+			b.run("policy_shr_u", input, TPUT, 1, [&](u64 i) { shr_u(&dst[(i % K) * 8], &in[(i % K) * 8], shifts[i & 255]); });
+			b.run("policy_and_u", input, TPUT, 1, [&](u64 i) { and_u(&dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8]); });
+			b.run("policy_msb_u", input, TPUT, 1, [&](u64 i) { acc += msb_u(&in[(i % K) * 8]); });
+			b.run("policy_sse", input, LAT, 1, [&](u64 i)
+				{
+					and_u(&dst[(i % K) * 8], &in[(i % K) * 8], &in2[(i % K) * 8]);
+					d = Sse(d + double(i & 1));
+				});
+		};
+		b.run("policy_sse", "no call", LAT, 1, [&](u64 i) { d = Sse(d + double(i & 1)); });
+		set_vector_policy_u(policy);
+	}
+
+	// pipeline: ( ( x >> 3 ) AND mask ) XOR y, counted; four passes of single value procs (then popcnt_n) over memory, or one
+	// pipe_run_n pass, a tile at a time
+	{
+		const u64 nmax = 1ull << 18;									// 16 MB of records, past the caches
+		alignas (64) static u64 x[nmax * 8]{};
+		alignas (64) static u64 y[nmax * 8]{};
+		alignas (64) static u64 tmp[nmax * 8]{};
+		alignas (64) static s16 pops[nmax]{};
+		alignas (64) u64 mask[8]{ 0, 0, 0xff, 0, 0, 0, 0, 0xf0 };
+		Fill(x, nmax * 8, &seed);
+		Fill(y, nmax * 8, &seed);
+		for (const u64 n : { 4096ull, nmax })
+		{
+			const string input = to_string(n) + " records";
+			b.run("pipe 4 passes", input.c_str(), TPUT, n, [&](u64 i)
+				{
+					for (u64 k = 0; k < n; k++) shr_u(&tmp[k * 8], &x[k * 8], 3);
+					for (u64 k = 0; k < n; k++) and_u(&tmp[k * 8], &tmp[k * 8], mask);
+					for (u64 k = 0; k < n; k++) xor_u(&tmp[k * 8], &tmp[k * 8], &y[k * 8]);
+					acc += popcnt_n(reinterpret_cast<u16*>(pops), tmp, n);
+				});
+			ui512_pipe p;
+			const int sx = p.array(x), sy = p.array(y), sm = p.constant(mask), st = p.temp(), sp = p.counts(pops);
+			p.shr(st, sx, 3).and_(st, st, sm).xor_(st, st, sy).popcnt(sp, st);
+			b.run("pipe_run_n", input.c_str(), TPUT, n, [&](u64 i) { acc += p.run(n); });
+		};
+	}
+
+	// skewed bitmaps, 2^24 values: one 0.1% set, one all but 0.1%; and_u over dense blocks, then popcnt_n, or ui512_bitmap and_
+	// (arrays against runs, once optimized). The input gives the bytes each holds
+	{
+		const u64 nblocks = (1ull << 24) / 512;
+		alignas (64) static u64 sparse[nblocks * 8]{};
+		alignas (64) static u64 full[nblocks * 8]{};
+		alignas (64) static u64 both[nblocks * 8]{};
+		alignas (64) static u16 counts[nblocks]{};
+		memset(full, 0xff, sizeof(full));
+		for (u64 k = 0; k < nblocks * 512 / 1000; k++)
+		{
+			const u64 s = RandomU64(&seed) % (nblocks * 512);
+			const u64 f = RandomU64(&seed) % (nblocks * 512);
+			sparse[(s / 512) * 8 + 7 - (s / 64) % 8] |= 1ull << (s % 64);
+			full[(f / 512) * 8 + 7 - (f / 64) % 8] &= ~(1ull << (f % 64));
+		};
+		ui512_bitmap hs = ui512_bitmap::from_dense(sparse, nblocks);
+		ui512_bitmap hf = ui512_bitmap::from_dense(full, nblocks);
+		hs.optimize();
+		hf.optimize();
+		const string dense_input = "skewed, " + to_string(2 * sizeof(sparse) / 1024) + " KB";
+		const string hybrid_input = "skewed, " + to_string((hs.bytes() + hf.bytes()) / 1024) + " KB";
+		b.run("bitmap dense and_u", dense_input.c_str(), TPUT, nblocks, [&](u64 i)
+			{
+				for (u64 k = 0; k < nblocks; k++) and_u(&both[k * 8], &sparse[k * 8], &full[k * 8]);
+				acc += popcnt_n(counts, both, nblocks);
+			});
+		b.run("bitmap ui512_bitmap and_", hybrid_input.c_str(), TPUT, nblocks, [&](u64 i)
+			{
+				acc += ui512_bitmap::and_(hs, hf).cardinality();
+			});
+	}
+
+	// text: hex and binary digits, one value, and 4096 lines of 128 digits and a line end (stride 129); against snprintf, a
+	// qword at a time
+	{
+		const u64 n = 4096;
+		alignas (64) static u64 values[n * 8]{};
+		alignas (64) static u64 back[n * 8]{};
+		static char lines[n * 129]{};
+		alignas (64) char text[520]{};
+		Fill(values, n * 8, &seed);
+		for (u64 k = 0; k < n; k++)
+			lines[k * 129 + 128] = '\n';
+		b.run("snprintf hex", "8 qwords", TPUT, 1, [&](u64 i)
+			{
+				const u64* x = &in[(i % K) * 8];
+				for (int j = 0; j < 8; j++)
+					snprintf(&text[j * 16], 17, "%016llx", (unsigned long long)x[j]);
+				acc += u8(text[i & 127]);
+			});
+		b.run("to_hex_u", "random", TPUT, 1, [&](u64 i) { to_hex_u(text, &in[(i % K) * 8]); acc += u8(text[i & 127]); });
+		to_hex_u(text, in);
+		b.run("from_hex_u", "random", TPUT, 1, [&](u64 i) { acc += u64(from_hex_u(&dst[(i % K) * 8], text)); });
+		b.run("to_bin_u", "random", TPUT, 1, [&](u64 i) { to_bin_u(text, &in[(i % K) * 8]); acc += u8(text[i & 511]); });
+		to_bin_u(text, in);
+		b.run("from_bin_u", "random", TPUT, 1, [&](u64 i) { acc += u64(from_bin_u(&dst[(i % K) * 8], text)); });
+		b.run("to_hex_n", "stride 129", TPUT, n, [&](u64 i) { to_hex_n(lines, values, n, 129); acc += u8(lines[i & 127]); });
+		b.run("from_hex_n", "stride 129", TPUT, n, [&](u64 i) { acc += from_hex_n(back, lines, n, 129); });
+	}
+
+	// predicates: a bool from a flag, against msb_u == -1 and memcmp (compare_u is in ui512a); the _n forms over 4096 records, b an array or one value
+	{
+		const u64 n = 4096;
+		alignas (64) static u64 recs[n * 8]{};
+		alignas (64) static u64 others[n * 8]{};
+		alignas (64) static u64 bits[n / 64]{};
+		Fill(others, n * 8, &seed);
+		for (u64 k = 0; k < n; k++)
+			for (int j = 0; j < 8; j++)
+				recs[k * 8 + j] = (k % 4 == 0) ? 0 : others[k * 8 + j] & ((k % 4 == 1) ? ~0ull : RandomU64(&seed));
+		b.run("msb_u == -1", "mixed", TPUT, 1, [&](u64 i) { acc += (msb_u(&recs[(i % n) * 8]) == -1); });
+		b.run("is_zero_u", "mixed", TPUT, 1, [&](u64 i) { acc += is_zero_u(&recs[(i % n) * 8]); });
+		b.run("memcmp == 0", "mixed", TPUT, 1, [&](u64 i) { acc += (memcmp(&recs[(i % n) * 8], &others[(i % n) * 8], 64) == 0); });
+		b.run("eq_u", "mixed", TPUT, 1, [&](u64 i) { acc += eq_u(&recs[(i % n) * 8], &others[(i % n) * 8]); });
+		b.run("subset_u", "mixed", TPUT, 1, [&](u64 i) { acc += subset_u(&recs[(i % n) * 8], &others[(i % n) * 8]); });
+		b.run("intersects_u", "mixed", TPUT, 1, [&](u64 i) { acc += intersects_u(&recs[(i % n) * 8], &others[(i % n) * 8]); });
+		b.run("is_zero_n", "4096 records", TPUT, n, [&](u64 i) { acc += is_zero_n(bits, recs, n); });
+		b.run("eq_n", "b array", TPUT, n, [&](u64 i) { acc += eq_n(bits, recs, others, n, 64); });
+		b.run("subset_n", "b array", TPUT, n, [&](u64 i) { acc += subset_n(bits, recs, others, n, 64); });
+		b.run("subset_n", "b one value", TPUT, n, [&](u64 i) { acc += subset_n(bits, recs, others, n, 0); });
+		b.run("intersects_n", "b one value", TPUT, n, [&](u64 i) { acc += intersects_n(bits, recs, others, n, 0); });
+	}
+
+	// storage
+	{
+		ui512_arena& arena = ui512_arena::local();
+		b.run("ui512_vector", "1000 push_back", TPUT, 1000, [&](u64 i)
+			{
+				ui512_vector vec(arena);
+				vec.reserve(1000);
+				for (int j = 0; j < 1000; j++)
+					vec.push_back(v);
+				arena.reset();
+			});
+
+		const u64 n = ScanWindow * 4;
+		const string path = (filesystem::temp_directory_path() / "ui512bBench.u512").string();
+		{
+			ui512_file f;
+			if (f.create(path.c_str(), n))
+				Fill(f.data(), n * 8, &seed);
+		};
+		b.run("ui512_scan_popcnt", "mapped file", TPUT, n, [&](u64 i)
+			{
+				ui512_file f;
+				f.open(path.c_str());
+				acc += ui512_scan_popcnt(f);
+			});
+		filesystem::remove(path);
+	}
+
+	sink = acc + u64(r) + v[0] + u64(d);
+	write_json(b, out.c_str(), options, cpu, ghz);
+	printf("%zu results to %s\n", b.results.size(), out.c_str());
+	return 0;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#ifndef CppUnitTest_h
+#define CppUnitTest_h
+
+//		CppUnitTest.h
+//
+//		File:			CppUnitTest.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		For the Linux build: the part of the Visual Studio C++ unit test framework ui512bTests.cpp uses, so the tests build
+//		unchanged with gcc or clang. TEST_CLASS and TEST_METHOD register each method, in the order written, for
+//		ui512bLinuxTests.cpp to run; an Assert that fails throws assert_failed, with the message; Logger::WriteMessage prints
+//		only when asked (-v).
+
+#include <cstdio>
+#include <cwchar>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Microsoft::VisualStudio::CppUnitTestFramework
+{
+	struct test_case
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	inline std::vector<test_case>& test_cases()
+	{
+		static std::vector<test_case> cases;
+		return cases;
+	};
+
+	inline bool& test_verbose()
+	{
+		static bool verbose = false;
+		return verbose;
+	};
+
+	template<class T>
+	struct test_class
+	{
+		using test_self = T;
+	};
+
+	struct assert_failed : std::runtime_error
+	{
+		using std::runtime_error::runtime_error;
+	};
+
+	inline std::string narrow(const wchar_t* message)
+	{
+		std::string s;
+		for (; message != nullptr && *message != 0; message++)
+			s += (*message < 128) ? char(*message) : '?';
+		return s;
+	};
+
+	class Logger
+	{
+	public:
+		static void WriteMessage(const char* message)
+		{
+			if (test_verbose())
+				fputs(message, stdout);
+		};
+		static void WriteMessage(const wchar_t* message)
+		{
+			if (test_verbose())
+				fputs(narrow(message).c_str(), stdout);
+		};
+	};
+
+	class Assert
+	{
+	public:
+		template<class E, class A>
+		static void AreEqual(const E& expected, const A& actual, const wchar_t* message = nullptr)
+		{
+			if (!(expected == actual))
+				fail("AreEqual: expected " + text(expected) + ", actual " + text(actual), message);
+		};
+		static void AreEqual(const char* expected, const char* actual, const wchar_t* message = nullptr)
+		{
+			if (std::string(expected) != std::string(actual))
+				fail("AreEqual: expected \"" + std::string(expected) + "\", actual \"" + std::string(actual) + "\"", message);
+		};
+		static void IsTrue(bool condition, const wchar_t* message = nullptr)
+		{
+			if (!condition)
+				fail("IsTrue", message);
+		};
+		static void IsFalse(bool condition, const wchar_t* message = nullptr)
+		{
+			if (condition)
+				fail("IsFalse", message);
+		};
+		static void Fail(const wchar_t* message = nullptr)
+		{
+			fail("Fail", message);
+		};
+
+	private:
+		template<class T>
+		static std::string text(const T& v)
+		{
+			std::ostringstream s;
+			if constexpr (std::is_arithmetic_v<T>)
+				s << +v;
+			else if constexpr (std::is_pointer_v<T>)
+				s << static_cast<const void*>(v);
+			else
+				s << "(value)";
+			return s.str();
+		};
+
+		[[noreturn]] static void fail(const std::string& what, const wchar_t* message)
+		{
+			throw assert_failed(message == nullptr ? what : what + ": " + narrow(message));
+		};
+	};
+}
+
+#define TEST_CLASS(name) \
+	class name : public Microsoft::VisualStudio::CppUnitTestFramework::test_class<name>
+
+#define TEST_METHOD(name) \
+	struct name##_registrar \
+	{ \
+		name##_registrar() \
+		{ \
+			Microsoft::VisualStudio::CppUnitTestFramework::test_cases().push_back({ #name, [] { test_self t; t.name(); } }); \
+		} \
+	}; \
+	inline static name##_registrar name##_registered; \
+	void name()
+
+#endif//		CppUnitTest_h
@@ -0,0 +1,25 @@
+#pragma once
+
+#ifndef intrin_h
+#define intrin_h
+
+//		intrin.h
+//
+//		File:			intrin.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		For the Linux build: MSVC's <intrin.h>, as used by ui512bTests and ui512bBench: the x86 intrinsics (__rdtsc, ...)
+//		and _umul128.
+
+#include <x86intrin.h>
+
+inline unsigned long long _umul128(unsigned long long a, unsigned long long b, unsigned long long* high)
+{
+	const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+	*high = static_cast<unsigned long long>(p >> 64);
+	return static_cast<unsigned long long>(p);
+};
+
+#endif//		intrin_h
@@ -0,0 +1,404 @@
+#!/usr/bin/env python3
+#
+#		ui512bLinux
+#
+#		File:			masm2gas.py
+#		Author:			John G.Lynch
+#		Legal:			Copyright @2024, per MIT License
+#		Date:			June 11, 2024
+#
+#		The GNU as route for the Linux build, where uasm is not to hand (make ASM=gas): expands the MASM source as ml64 would
+#		(EQU and = symbols, IF/ELSEIF/ELSE, MACRO with LOCAL, FOR, REPT, INCLUDE) and writes the result as GNU as intel syntax.
+#		Only the subset of MASM that ui512b.asm, its macros and reg_verify.asm use is handled; it is not a general assembler.
+#		Data is addressed RIP relative, and PUBLIC procs are exported under their own names with System V linkage, so the
+#		source is assembled with __SysV=1.
+#
+#			python3 masm2gas.py [-I dir] source.asm [NAME=value ...] > source.s
+#
+#		NAME=value overrides an EQU of the same name (compile_time_options.inc); INCLUDE files are looked for in dir (default:
+#		the directory of source.asm).
+
+import os
+import re
+import sys
+
+args = sys.argv[1:]
+incdir = None
+if len(args) > 1 and args[0] == '-I':
+	incdir = args[1]
+	args = args[2:]
+if not args:
+	sys.exit('usage: masm2gas.py [-I dir] source.asm [NAME=value ...]')
+src = args[0]
+overrides = {}
+for a in args[1:]:
+	k, v = a.split('=')
+	overrides[k] = v
+if incdir is None:
+	incdir = os.path.dirname(os.path.abspath(src))
+
+OPENERS = ('MACRO', 'FOR', 'IRP', 'REPT', 'WHILE', 'FORC', 'IRPC')
+
+def strip_comment(l):
+	out = []
+	q = None
+	depth = 0
+	for ch in l:
+		if q:
+			out.append(ch)
+			if ch == q:
+				q = None
+			continue
+		if ch in '\'"':
+			q = ch
+		elif ch == '<':
+			depth += 1
+		elif ch == '>':
+			depth = max(0, depth - 1)
+		elif ch == ';' and depth == 0:
+			break
+		out.append(ch)
+	return ''.join(out).rstrip()
+
+def split_args(s):
+	res, cur, d = [], '', 0
+	for ch in s:
+		if ch == '<':
+			d += 1
+			if d == 1:
+				continue
+		if ch == '>':
+			d -= 1
+			if d == 0:
+				continue
+		if ch == ',' and d == 0:
+			res.append(cur.strip()); cur = ''
+			continue
+		cur += ch
+	if cur.strip() or res:
+		res.append(cur.strip())
+	return res
+
+sym = {}
+macros = {}
+locctr = [0]
+
+def subst_syms(s, depth=0):
+	if depth > 10:
+		return s
+	def rep(m):
+		w = m.group(0)
+		if w in sym:
+			return sym[w]
+		return w
+	n = re.sub(r'[A-Za-z_@?$][\w@?$]*', rep, s)
+	if n != s:
+		return subst_syms(n, depth + 1)
+	return n
+
+def masm_num(s):
+	return re.sub(r'\b([0-9][0-9a-fA-F]*)[hH]\b', lambda m: '0x' + m.group(1), s)
+
+def evalcond(e):
+	e = subst_syms(e)
+	e = masm_num(e)
+	e = re.sub(r'\bEQ\b', '==', e); e = re.sub(r'\bNE\b', '!=', e)
+	e = re.sub(r'\bAND\b', ' and ', e); e = re.sub(r'\bOR\b', ' or ', e); e = re.sub(r'\bNOT\b', ' not ', e)
+	e = re.sub(r'\bGE\b', '>=', e); e = re.sub(r'\bLE\b', '<=', e); e = re.sub(r'\bGT\b', '>', e); e = re.sub(r'\bLT\b', '<', e)
+	try:
+		return bool(eval(e))
+	except Exception:
+		raise Exception('cannot evaluate condition: %r' % e)
+
+def read_file(fn):
+	with open(os.path.join(incdir, fn), encoding='utf-8', errors='replace') as f:
+		return [l.rstrip('\n').rstrip('\r') for l in f]
+
+def collect_block(lines, i):
+	# lines[i] is first body line; returns (body, index after ENDM)
+	body = []
+	depth = 1
+	while i < len(lines):
+		l = strip_comment(lines[i])
+		toks = l.split()
+		up = [t.upper() for t in toks[:2]]
+		if up and (up[0] in ('FOR', 'IRP', 'REPT', 'WHILE', 'FORC', 'IRPC') or (len(up) > 1 and up[1] == 'MACRO')):
+			depth += 1
+		if up and up[0] == 'ENDM':
+			depth -= 1
+			if depth == 0:
+				return body, i + 1
+		body.append(lines[i])
+		i += 1
+	raise Exception('unterminated block')
+
+def process(lines, out):
+	cond = []  # stack of [active, taken, parent_active]
+	def active():
+		return all(c[0] for c in cond)
+	i = 0
+	while i < len(lines):
+		raw = lines[i]
+		l = strip_comment(raw)
+		i += 1
+		s = l.strip()
+		if not s:
+			continue
+		toks = s.split(None, 1)
+		w0 = toks[0].upper()
+		rest = toks[1] if len(toks) > 1 else ''
+		if w0 in ('IF', 'IFDEF', 'IFNDEF', 'IFE', 'IFB', 'IFNB'):
+			if not active():
+				cond.append([False, True]); continue
+			if w0 == 'IF': v = evalcond(rest)
+			elif w0 == 'IFE': v = not evalcond(rest)
+			elif w0 in ('IFB', 'IFNB'): v = (rest.strip().strip('<>').strip() == '') == (w0 == 'IFB')
+			elif w0 == 'IFDEF': v = rest.strip() in sym
+			else: v = rest.strip() not in sym
+			cond.append([v, v]); continue
+		if w0 == 'ELSEIF':
+			c = cond[-1]
+			parent = all(x[0] for x in cond[:-1])
+			if c[1] or not parent:
+				c[0] = False
+			else:
+				v = evalcond(rest); c[0] = v; c[1] = v
+			continue
+		if w0 == 'ELSE':
+			c = cond[-1]
+			c[0] = not c[1]; c[1] = True
+			continue
+		if w0 == 'ENDIF':
+			cond.pop(); continue
+		if not active():
+			continue
+		toks2 = s.split(None, 2)
+		w1 = toks2[1].upper() if len(toks2) > 1 else ''
+		if w1 == 'MACRO':
+			name = toks2[0]
+			params = [p.split(':')[0].strip() for p in split_args(toks2[2])] if len(toks2) > 2 else []
+			body, i = collect_block(lines, i)
+			macros[name.upper()] = (params, body)
+			continue
+		if w0 in ('FOR', 'IRP'):
+			m = re.match(r'(\w+)\s*,\s*<(.*)>', rest)
+			var = m.group(1)
+			vals = [v.strip() for v in m.group(2).split(',')]
+			body, i = collect_block(lines, i)
+			for v in vals:
+				nb = [re.sub(r'&?\b%s\b&?' % re.escape(var), v, b) for b in body]
+				process(nb, out)
+			continue
+		if w0 == 'REPT':
+			n = int(eval(masm_num(subst_syms(rest))))
+			body, i = collect_block(lines, i)
+			for _ in range(n):
+				process(body, out)
+			continue
+		if w1 == 'EQU' or w1 == '=' or (len(toks2) > 1 and toks2[1] == '='):
+			name = toks2[0]
+			val = toks2[2].strip() if len(toks2) > 2 else ''
+			if val.startswith('<') and val.endswith('>'):
+				val = val[1:-1]
+			if name in overrides:
+				val = overrides[name]
+			sym[name] = val
+			continue
+		if w0 == 'INCLUDE':
+			process(read_file(rest.strip()), out)
+			continue
+		if w0 == 'LOCAL':
+			continue
+		# macro invocation (possibly with label prefix "lbl:")
+		lbl = ''
+		body_s = s
+		mm = re.match(r'^([\w@?$]+:)\s*(.*)$', s)
+		if mm and mm.group(2):
+			lbl, body_s = mm.group(1), mm.group(2)
+		t = body_s.split(None, 1)
+		if t and t[0].upper() in macros:
+			params, body = macros[t[0].upper()]
+			a = split_args(t[1]) if len(t) > 1 else []
+			a += [''] * (len(params) - len(a))
+			if lbl:
+				out.append(lbl)
+			# LOCAL handling
+			locs = {}
+			nb = []
+			for b in body:
+				bs = strip_comment(b).strip()
+				if re.match(r'LOCAL\s', bs, re.I):
+					for nm in bs[6:].split(','):
+						locctr[0] += 1
+						locs[nm.strip()] = 'Lloc%d' % locctr[0]
+					continue
+				nb.append(b)
+			res = []
+			for b in nb:
+				b = strip_comment(b)
+				for p, v in zip(params, a):
+					b = re.sub(r'&%s&|&%s\b|\b%s&|\b%s\b' % ((re.escape(p),) * 4), v.replace('\\', '\\\\'), b, flags=re.I)
+				for k, v in locs.items():
+					b = re.sub(r'\b%s\b' % re.escape(k), v, b)
+				res.append(b)
+			process(res, out)
+			continue
+		out.append(s)
+
+pre = []
+process([l.rstrip('\n') for l in open(src, encoding='utf-8', errors='replace')], pre)
+
+# ---- second pass: GNU as ----
+DATA_DIRS = {'QWORD': '.quad', 'DQ': '.quad', 'DD': '.long', 'DWORD': '.long', 'DB': '.byte', 'BYTE': '.byte', 'DW': '.short', 'WORD': '.short'}
+datasyms = set()
+codelabels = {}
+# find data symbols
+for s in pre:
+	t = s.split()
+	if len(t) >= 2 and (t[1].upper() in DATA_DIRS or t[1].upper() == 'LABEL'):
+		datasyms.add(t[0])
+
+out = ['.intel_syntax noprefix']
+publics = []
+opened = set()
+proc = None
+
+def expand_dup(vals):
+	m = re.match(r'^\s*(\w+)\s+DUP\s*\((.*)\)\s*$', vals, re.I)
+	if m and ',' in m.group(2):
+		return expand_dup(m.group(2)) * int(eval(masm_num(subst_syms(m.group(1)))))
+	res = []
+	for v in split_args(vals):
+		if len(v) >= 2 and v[0] in '\'"' and v[-1] == v[0]:
+			res += [str(ord(ch)) for ch in v[1:-1]]
+			continue
+		m = re.match(r'(.+?)\s+DUP\s*\((.*)\)', v, re.I)
+		if m:
+			n = int(eval(masm_num(subst_syms(m.group(1)))))
+			res += [m.group(2).strip()] * n
+		else:
+			res.append(v)
+	return res
+
+def conv_operands(ops, isjump=False):
+	ops = subst_syms(ops)
+	ops = re.sub(r'FS:\[\s*0\s*\]', 'QWORD PTR fs:[0]', ops, flags=re.I)
+	if isjump and ops.strip() in procs:
+		return ops.strip()
+	ops = masm_num(ops)
+	ops = re.sub(r'\]\s*\[', ' + ', ops)
+	ops = re.sub(r'\bSHL\b', '<<', ops); ops = re.sub(r'\bSHR\b', '>>', ops)
+	ops = re.sub(r'\s+\{', '{', ops)
+	# labels
+	def lab(m):
+		w = m.group(0)
+		if w == '@F': return '1f'
+		if w == '@B': return '1b'
+		if w.startswith('@@') or (proc and (proc + ':' + w) in codelabels):
+			return 'L_%s_%s' % (proc, w.replace('@', '_'))
+		return w
+	ops = re.sub(r'@@\w+|@F|@B|[A-Za-z_]\w*', lab, ops)
+	# data symbol refs -> rip-relative
+	np = []
+	for p in split_top(ops):
+		pp = p.strip()
+		m = re.match(r'^((?:\w+\s+PTR\s+)?)([A-Za-z_]\w*)$', pp, re.I)
+		if m and not isjump and (m.group(2) in datasyms or m.group(2).startswith('L_')):
+			pp = '%s[rip + %s]' % (m.group(1), m.group(2))
+		np.append(pp)
+	ops = ', '.join(np)
+	return ops
+
+def split_top(s):
+	res, cur, d = [], '', 0
+	for ch in s:
+		if ch in '[{(': d += 1
+		if ch in ']})': d -= 1
+		if ch == ',' and d == 0:
+			res.append(cur); cur = ''
+			continue
+		cur += ch
+	res.append(cur)
+	return res
+
+# prepass: collect code labels per proc
+p = None
+procs = set()
+for s in pre:
+	t = s.split()
+	if len(t) >= 2 and t[1].upper() == 'PROC':
+		procs.add(t[0])
+for s in pre:
+	t = s.split()
+	if len(t) >= 2 and t[1].upper() == 'PROC':
+		p = t[0]
+	m = re.match(r'^([A-Za-z_@][\w@]*):', s)
+	if m and p and m.group(1) != '@@':
+		codelabels[p + ':' + m.group(1)] = 1
+
+for s in pre:
+	t = s.split(None, 1)
+	w0 = t[0].upper()
+	rest = t[1] if len(t) > 1 else ''
+	t3 = s.split()
+	w1 = t3[1].upper() if len(t3) > 1 else ''
+	if w0 == 'EXTERNDEF' and (':QWORD' in rest.upper().replace(' ', '') or rest.split(':')[0].strip() in procs):
+		out.append('.globl %s' % rest.split(':')[0].strip()); continue
+	if w0 in ('OPTION', 'EXTERNDEF', '.LIST', 'END', '.ENDPROLOG', '.NOLIST', '.ALLOCSTACK') or w1 in ('TYPEDEF', 'RECORD', 'ENDS', 'ENDP'):
+		continue
+	if w1 == 'SEGMENT':
+		if "'CODE'" in s.upper():
+			out.append('.text')
+		else:
+			nm = t3[0]
+			out.append('.section .data.%s,"aw"' % nm if "'DATA'" in s.upper() else '.section .rodata.%s,"a"' % nm)
+			if nm not in opened:
+				opened.add(nm)
+				ma = re.search(r'ALIGN\s*\(\s*(\d+)\s*\)', s, re.I)
+				out.append('.balign %s' % (ma.group(1) if ma else '16'))
+		continue
+	if w1 == 'LABEL':
+		out.append('.globl %s' % t3[0]); out.append('%s:' % t3[0]); continue
+	if w0 == 'PUBLIC':
+		publics.append(rest.strip()); continue
+	if w1 == 'PROC':
+		proc = t3[0]
+		out.append('%s:' % proc)
+		continue
+	if w0 == 'ALIGN':
+		out.append('.balign %s' % rest); continue
+	# labels
+	m = re.match(r'^([A-Za-z_@][\w@]*):\s*(.*)$', s)
+	if m:
+		name = m.group(1)
+		if name == '@@':
+			out.append('1:')
+		elif proc and (proc + ':' + name) in codelabels:
+			out.append('L_%s_%s:' % (proc, name.replace('@', '_')))
+		else:
+			out.append('%s:' % name)
+		s = m.group(2)
+		if not s: continue
+		t = s.split(None, 1); w0 = t[0].upper(); rest = t[1] if len(t) > 1 else ''
+		t3 = s.split(); w1 = t3[1].upper() if len(t3) > 1 else ''
+	# data
+	if w0 in DATA_DIRS:
+		vals = expand_dup(rest)
+		out.append('%s %s' % (DATA_DIRS[w0], ', '.join(conv_operands(v, True) for v in vals)))
+		continue
+	if w1 in DATA_DIRS:
+		out.append('%s:' % t3[0])
+		vals = expand_dup(s.split(None, 2)[2])
+		out.append('%s %s' % (DATA_DIRS[w1], ', '.join(masm_num(subst_syms(v)) for v in vals)))
+		continue
+	# instruction
+	ins = w0
+	out.append('%s %s' % (ins.lower(), conv_operands(rest, ins.startswith('J') or ins in ('CALL','LOOP'))))
+
+# exports
+out.append('.text')
+for pname in publics:
+	if pname in datasyms:
+		continue
+	out.append('.globl %s' % pname)
+print('\n'.join(out))
@@ -0,0 +1,21 @@
+;
+;			reg_verify
+;
+;--------------------------------------------------------------------------------------------------------------------------------------------------------------
+;			File:			reg_verify.asm
+;			Author:			John G. Lynch
+;			Legal:			Copyright @2024, per MIT License included
+;			Date:			June 11, 2024
+;
+;			For the Linux test runner: reg_verify (VerifyRegs, ui512aMacros.inc; with __SysV, as redefined in ui512bMacros.inc).
+;			On Windows the tests link it with ui512a.
+
+				INCLUDE			legalnotes.inc
+				INCLUDE			compile_time_options.inc
+				INCLUDE			ui512aMacros.inc
+				INCLUDE			ui512bMacros.inc
+				OPTION			casemap:none
+
+				VerifyRegs
+
+				END
@@ -0,0 +1,51 @@
+//		ui512bLinuxTests
+//
+//		File:			ui512bLinuxTests.cpp
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//			Notes:
+//				Runs the unit tests of ui512bTests.cpp, unchanged, against the System V build of ui512b (ui512bLinux/Makefile):
+//				CppUnitTest.h here stands in for the Visual Studio framework, registering each TEST_METHOD, and this runs them
+//				in order, each on a new instance of the test class, reporting PASS or FAIL (with the Assert message) for each.
+//
+//			Usage:		ui512bLinuxTests [-v] [text]
+//							-v		print the Logger messages of the tests
+//							text	run only the tests with text in the name
+
+#include "../ui512bTests/ui512bTests.cpp"
+
+int main(int argc, char** argv)
+{
+	using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+	string filter;
+	for (int a = 1; a < argc; a++)
+		if (string(argv[a]) == "-v")
+			test_verbose() = true;
+		else
+			filter = argv[a];
+
+	int run = 0;
+	int failed = 0;
+	for (const test_case& t : test_cases())
+	{
+		if (!filter.empty() && string(t.name).find(filter) == string::npos)
+			continue;
+		run++;
+		try
+		{
+			t.run();
+			printf("PASS  %s\n", t.name);
+		}
+		catch (const exception& e)
+		{
+			failed++;
+			printf("FAIL  %s: %s\n", t.name, e.what());
+		};
+		fflush(stdout);
+	};
+	printf("%d tests run, %d failed\n", run, failed);
+	return failed == 0 ? 0 : 1;
+}
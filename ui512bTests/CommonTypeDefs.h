@@ -10,17 +10,27 @@
 //		Date:			May 13, 2024
 //
 
+#include <cstring>					// memset, memcmp (regs)
+
 // Apologies to purists, but I want simpler, clearer, shorter variable
 // declarations (no "unsigned long long", etc.) 
 // Type aliases:
 
+#ifdef _MSC_VER
 typedef unsigned _int64 u64;
+#else
+typedef unsigned long long u64;		// gcc, clang (the Linux build)
+#endif
 typedef unsigned int u32;
 typedef unsigned long u32l;
 typedef unsigned short u16;
 typedef char u8;
 
+#ifdef _MSC_VER
 typedef _int64 s64;
+#else
+typedef long long s64;
+#endif
 typedef int s32;
 typedef short s16;
 
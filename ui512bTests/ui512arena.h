@@ -0,0 +1,296 @@
+#pragma once
+
+#ifndef ui512arena_h
+#define ui512arena_h
+
+//		ui512arena.h
+//
+//		File:			ui512arena.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		Storage for 512 bit values that is 64 byte aligned by construction, for the procs of ui512a / ui512b:
+//
+//			ui512_arena		-	hands out 64 byte slots (one cache line each, so no two values share a line) from large chunks,
+//								large pages where the process may use them (the "Lock pages in memory" right, enabled in the
+//								process token on the first attempt; on Linux, reserved huge pages, MAP_HUGETLB), else 4K pages.
+//								No per value free: reset frees all at once, keeping the chunks; release returns them.
+//								ui512_arena::local() is an arena for the calling thread, so threads do not contend. It is
+//								released when the thread ends: nothing in it may outlive the thread, or be used by another.
+//			ui512_vector	-	growable array of 512 bit values in an arena, given when made (and it must outlive the vector;
+//								one thread at a time grows it); move only, so values are not copied by accident.
+//								Growing takes a new block from the arena; the old block is freed by the arena's reset.
+
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "advapi32.lib")								// AdjustTokenPrivileges
+#endif
+#else
+#include <sys/mman.h>
+#endif
+
+#include "CommonTypeDefs.h"
+
+class ui512_arena
+{
+public:
+	static constexpr size_t slot_bytes = 64;							// one 512 bit value, one cache line
+	static constexpr size_t chunk_default = 2 * 1024 * 1024;			// the usual large page
+
+	explicit ui512_arena(size_t chunk_bytes = chunk_default) : chunk_bytes(chunk_bytes) {}
+	~ui512_arena() { release(); }
+
+	ui512_arena(const ui512_arena&) = delete;
+	ui512_arena& operator=(const ui512_arena&) = delete;
+
+	// n consecutive 512 bit slots (8 QWORDS each), 64 byte aligned; not initialized (zero the first time a chunk is used)
+	u64* alloc(size_t n = 1)
+	{
+		const size_t bytes = (n == 0 ? 1 : n) * slot_bytes;
+		while (current < chunks.size())
+		{
+			if (offset + bytes <= chunks[current].bytes)
+			{
+				u8* p = chunks[current].base + offset;
+				offset += bytes;
+				used_bytes += bytes;
+				return reinterpret_cast<u64*>(p);
+			};
+			current++;													// the rest of this chunk unused until reset
+			offset = 0;
+		};
+		chunks.push_back(os_alloc(bytes > chunk_bytes ? bytes : chunk_bytes));
+		current = chunks.size() - 1;
+		offset = bytes;
+		used_bytes += bytes;
+		return reinterpret_cast<u64*>(chunks[current].base);
+	};
+
+	// n slots, zeroed
+	u64* alloc_zero(size_t n = 1)
+	{
+		u64* p = alloc(n);
+		std::memset(p, 0, (n == 0 ? 1 : n) * slot_bytes);
+		return p;
+	};
+
+	// free every slot at once; the chunks are kept, and handed out again from the first
+	void reset()
+	{
+		current = 0;
+		offset = 0;
+		used_bytes = 0;
+	};
+
+	// free every slot, and return the chunks to the system
+	void release()
+	{
+		for (const chunk& c : chunks)
+			os_free(c);
+		chunks.clear();
+		reset();
+	};
+
+	size_t used() const { return used_bytes; };							// bytes handed out since the last reset
+	size_t reserved() const												// bytes held in chunks
+	{
+		size_t b = 0;
+		for (const chunk& c : chunks) b += c.bytes;
+		return b;
+	};
+	bool large_pages() const											// any chunk on large pages?
+	{
+		for (const chunk& c : chunks) if (c.large) return true;
+		return false;
+	};
+
+	// the arena of the calling thread; released as the thread ends, so what it holds is for this thread, and not after
+	static ui512_arena& local()
+	{
+		thread_local ui512_arena arena;
+		return arena;
+	};
+
+private:
+	struct chunk
+	{
+		u8* base;
+		size_t bytes;
+		bool large;
+	};
+
+#ifdef _WIN32
+	// MEM_LARGE_PAGES needs SeLockMemoryPrivilege enabled in the process token, not only held: enabled once, for the process;
+	// false if it does not hold the right
+	static bool lock_memory_enabled()
+	{
+		static const bool enabled = []
+			{
+				HANDLE token = nullptr;
+				if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+					return false;
+				TOKEN_PRIVILEGES tp{};
+				tp.PrivilegeCount = 1;
+				tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+				const bool ok = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid)
+					&& AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr)
+					&& GetLastError() == ERROR_SUCCESS;						// not ERROR_NOT_ALL_ASSIGNED: the right is held
+				CloseHandle(token);
+				return ok;
+			}();
+		return enabled;
+	};
+
+	chunk os_alloc(size_t bytes)
+	{
+		if (try_large && lock_memory_enabled())
+		{
+			const size_t page = GetLargePageMinimum();
+			if (page != 0)
+			{
+				const size_t b = (bytes + page - 1) / page * page;
+				void* p = VirtualAlloc(nullptr, b, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+				if (p != nullptr)
+					return chunk{ static_cast<u8*>(p), b, true };
+			};
+		};
+		try_large = false;												// not permitted (or none free): 4K pages from now on
+		void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);	// page aligned
+		if (p == nullptr)
+			throw std::bad_alloc();
+		return chunk{ static_cast<u8*>(p), bytes, false };
+	};
+
+	static void os_free(const chunk& c) { VirtualFree(c.base, 0, MEM_RELEASE); };
+#else
+	chunk os_alloc(size_t bytes)
+	{
+		if (try_large)
+		{
+			const size_t page = chunk_default;
+			const size_t b = (bytes + page - 1) / page * page;
+			void* p = mmap(nullptr, b, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (p != MAP_FAILED)
+				return chunk{ static_cast<u8*>(p), b, true };
+			try_large = false;											// none reserved (vm.nr_hugepages): 4K pages from now on
+		};
+		void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);	// page aligned
+		if (p == MAP_FAILED)
+			throw std::bad_alloc();
+		return chunk{ static_cast<u8*>(p), bytes, false };
+	};
+
+	static void os_free(const chunk& c) { munmap(c.base, c.bytes); };
+#endif
+
+	std::vector<chunk> chunks;
+	size_t current = 0;													// chunk handing out slots
+	size_t offset = 0;													// next free byte in it
+	size_t used_bytes = 0;
+	size_t chunk_bytes;
+	bool try_large = true;
+};
+
+class ui512_vector
+{
+public:
+	// the arena holds the values: it must outlive the vector (ui512_arena::local(): the vector stays on its thread)
+	explicit ui512_vector(ui512_arena& arena) : arena(&arena) {}
+	ui512_vector(size_t n, ui512_arena& arena) : arena(&arena)			// n zero values
+	{
+		resize(n);
+	};
+
+	ui512_vector(const ui512_vector&) = delete;
+	ui512_vector& operator=(const ui512_vector&) = delete;
+
+	ui512_vector(ui512_vector&& other) noexcept
+		: arena(other.arena), values(other.values), count(other.count), cap(other.cap)
+	{
+		other.values = nullptr;
+		other.count = other.cap = 0;
+	};
+	ui512_vector& operator=(ui512_vector&& other) noexcept
+	{
+		std::swap(arena, other.arena);
+		std::swap(values, other.values);
+		std::swap(count, other.count);
+		std::swap(cap, other.cap);
+		return *this;
+	};
+
+	// value i: address of its 8 QWORDS, 64 byte aligned
+	u64* operator[](size_t i) { return values + i * 8; };
+	const u64* operator[](size_t i) const { return values + i * 8; };
+	u64* data() { return values; };
+	const u64* data() const { return values; };
+
+	size_t size() const { return count; };
+	size_t capacity() const { return cap; };
+	bool empty() const { return count == 0; };
+	ui512_arena& get_arena() const { return *arena; };
+
+	void reserve(size_t n)
+	{
+		if (n <= cap)
+			return;
+		u64* grown = arena->alloc(n);
+		if (count != 0)
+			std::memcpy(grown, values, count * 64);
+		values = grown;
+		cap = n;
+	};
+
+	// size n; values added are zero
+	void resize(size_t n)
+	{
+		reserve(n);
+		if (n > count)
+			std::memset(values + count * 8, 0, (n - count) * 64);
+		count = n;
+	};
+
+	void clear() { count = 0; };
+
+	// append a copy of the 8 QWORDS at value; returns its address here
+	u64* push_back(const u64* value)
+	{
+		if (count == cap)
+			reserve(cap < 8 ? 8 : cap * 2);								// the old block (value may be in it) stays until reset
+		u64* slot = values + count * 8;
+		std::memcpy(slot, value, 64);
+		count++;
+		return slot;
+	};
+
+	// append a zero value; returns its address, to be filled in place (e.g. as a ui512b destination)
+	u64* emplace_back()
+	{
+		if (count == cap)
+			reserve(cap < 8 ? 8 : cap * 2);
+		u64* slot = values + count * 8;
+		std::memset(slot, 0, 64);
+		count++;
+		return slot;
+	};
+
+	void pop_back() { count--; };
+
+private:
+	ui512_arena* arena;
+	u64* values = nullptr;
+	size_t count = 0;
+	size_t cap = 0;
+};
+
+#endif//		ui512arena_h
@@ -58,6 +58,500 @@ extern "C"
 	// find least significant bit in supplied source 512bit (8 QWORDS)
 	// returns: -1 if no least significant bit, bit number otherwise, bits numbered 0 to 511 inclusive
 	// EXTERNDEF	lsb_u : PROC
+
+	s16 popcnt_u(const u64*);
+	// count the set bits in supplied source 512bit (8 QWORDS)
+	// returns: number of set bits, 0 to 512 inclusive
+	// EXTERNDEF	popcnt_u : PROC
+
+	s16 rank_u(const u64*, const u16);
+	// s16 rank_u ( u64* source, u16 bit );
+	// count the set bits below the supplied bit number (numbered as msb_u, lsb_u) in source 512bit (8 QWORDS)
+	// returns: number of set bits numbered 0 to bit-1; a bit of 512 or more counts all bits
+	// EXTERNDEF	rank_u : PROC
+
+	s16 select_u(const u64*, const u16);
+	// s16 select_u ( u64* source, u16 k );
+	// find the k-th (zero based, counting up from bit 0) set bit in supplied source 512bit (8 QWORDS)
+	// returns: -1 if fewer than k+1 bits are set, bit number otherwise, bits numbered 0 to 511 inclusive
+	// EXTERNDEF	select_u : PROC
+
+	// Rank / select index over an array of 512 bit blocks. Bits in the array are numbered block * 512 + bit within block.
+	// counts: nblocks + 1 QWORDS, set bits before each block, then the total
+	// hints: (nblocks / 8) + 2 QWORDS, block index of every (1 << RS_HINT_SHIFT)th set bit, then the last block index
+#define RS_HINT_SHIFT 12
+
+	u64 rsindex_n(const u64*, const u64*, const u64*, const u64);
+	// u64 rsindex_n ( u64* counts, u64* hints, u64* blocks, u64 nblocks );
+	// build rank / select index over an array of 512bit blocks in one pass
+	// returns: total number of set bits in the blocks
+	// EXTERNDEF	rsindex_n : PROC
+
+	u64 rank_n(const u64*, const u64*, const u64);
+	// u64 rank_n ( u64* counts, u64* blocks, u64 i );
+	// count the set bits below bit 'i' (0 to nblocks * 512 inclusive) in an indexed array of 512bit blocks
+	// EXTERNDEF	rank_n : PROC
+
+	u64 select_n(const u64*, const u64*, const u64*, const u64, const u64);
+	// u64 select_n ( u64* counts, u64* hints, u64* blocks, u64 nblocks, u64 k );
+	// find the k-th (zero based) set bit in an indexed array of 512bit blocks
+	// returns: bit number, or u64_Max if fewer than k+1 bits are set
+	// EXTERNDEF	select_n : PROC
+
+	// Blocked Bloom filter over an array of 512 bit blocks: each hash selects one block (by its high bits), and sets / tests k bits in it.
+	// k must be the same for adds and tests of a filter.
+
+	void bloom_pattern_u(const u64*, const u64, const u16);
+	// void bloom_pattern_u ( u64* destination, u64 hash, u16 k );
+	// build the k bit Bloom filter pattern for a hash (the bits that bloom_add_u sets in its block); 1 to k bits set
+	// EXTERNDEF	bloom_pattern_u : PROC
+
+	void bloom_add_u(const u64*, const u64, const u64, const u16);
+	// void bloom_add_u ( u64* filter, u64 nblocks, u64 hash, u16 k );
+	// add a hash to a blocked Bloom filter of nblocks 512bit blocks
+	// EXTERNDEF	bloom_add_u : PROC
+
+	s16 bloom_test_u(const u64*, const u64, const u64, const u16);
+	// s16 bloom_test_u ( u64* filter, u64 nblocks, u64 hash, u16 k );
+	// test a hash against a blocked Bloom filter of nblocks 512bit blocks
+	// returns: 1 if the hash may have been added, 0 if it definitely was not
+	// EXTERNDEF	bloom_test_u : PROC
+
+	void bloom_add_n(const u64*, const u64, const u64*, const u64, const u16);
+	// void bloom_add_n ( u64* filter, u64 nblocks, u64* hashes, u64 n, u16 k );
+	// add n hashes to a blocked Bloom filter, prefetching blocks ahead
+	// EXTERNDEF	bloom_add_n : PROC
+
+	void bloom_test_n(const u64*, const u64, const u64*, const u64, const u16, const u64*);
+	// void bloom_test_n ( u64* filter, u64 nblocks, u64* hashes, u64 n, u16 k, u64* results );
+	// test n hashes against a blocked Bloom filter, prefetching blocks ahead
+	// results: (n + 63) / 64 QWORDS, bit i % 64 of QWORD i / 64 set if hash i may have been added
+	// EXTERNDEF	bloom_test_n : PROC
+
+	// Masked pattern match over an array of 512 bit records: record i matches if ( record AND mask ) equals pattern.
+
+	u64 match_n(const u64*, const u64, const u64*, const u64*, const u64*);
+	// u64 match_n ( u64* records, u64 n, u64* mask, u64* pattern, u64* out_indices );
+	// out_indices: room for n QWORDS, receives the index of each matching record, ascending
+	// returns: number of matching records
+	// EXTERNDEF	match_n : PROC
+
+	u64 match_bits_n(const u64*, const u64, const u64*, const u64*, const u64*);
+	// u64 match_bits_n ( u64* records, u64 n, u64* mask, u64* pattern, u64* bitmap );
+	// bitmap: (n + 63) / 64 QWORDS, bit i % 64 of QWORD i / 64 set if record i matches
+	// returns: number of matching records
+	// EXTERNDEF	match_bits_n : PROC
+
+	u64 match_any_n(const u64*, const u64, const u64*, const u64*, const u64, const u64*);
+	// u64 match_any_n ( u64* records, u64 n, u64* masks, u64* patterns, u64 npat, u64* out_indices );
+	// as match_n, selecting records for which ( record AND masks[j] ) equals patterns[j] for any j of npat
+	// returns: number of matching records
+	// EXTERNDEF	match_any_n : PROC
+
+	u64 popcnt_n(const u16*, const u64*, const u64);
+	// u64 popcnt_n ( u16* counts, u64* records, u64 n );
+	// count the set bits of each of an array of 512bit records
+	// returns: total number of set bits
+	// EXTERNDEF	popcnt_n : PROC
+
+	// Tanimoto (Jaccard) similarity, popcount( a AND b ) / popcount( a OR b ), as fixed point: TANIMOTO_ONE is identical
+#define TANIMOTO_SHIFT 31
+#define TANIMOTO_ONE (1u << TANIMOTO_SHIFT)
+
+	u32 tanimoto_u(const u64*, const u64*);
+	// u32 tanimoto_u ( u64* a, u64* b );
+	// Tanimoto similarity of two 512bit values, both counts taken in one pass; two zero values score zero
+	// EXTERNDEF	tanimoto_u : PROC
+
+	u64 tanimoto_topk_n(const u64*, const u64, const u64*, const u64*, const u16*, const u64);
+	// u64 tanimoto_topk_n ( u64* results, u64 k, u64* query, u64* records, u16* counts, u64 n );
+	// find the k records most similar (Tanimoto) to a query; counts from popcnt_n over the records; n less than 2^32 - 1
+	// results: k QWORDS, best first (equal scores by index): score (as tanimoto_u) in the high 32 bits, record index in the low 32
+	// returns: number of results, the lesser of k and n
+	// For several threads: give each a slice of the records and its own results, add the slice start to the indices, then merge.
+	// EXTERNDEF	tanimoto_topk_n : PROC
+
+	s16 lcp_u(const u64*, const u64*);
+	// s16 lcp_u ( u64* a, u64* b );
+	// count the leading (most significant) bits two 512bit values have in common
+	// returns: 0 to 512 inclusive, 512 if equal (511 - lcp_u is the msb_u of a xor b, the crit bit)
+	// EXTERNDEF	lcp_u : PROC
+
+	// Crit-bit tree over a sorted array of distinct 512 bit keys, ordered as compare_u. Each 64 byte line holds a three level
+	// subtree: seven crit bit positions, eight child references (line, or key index), and the range of keys below it.
+	// Queries need a tree of at least one key. Range iteration is over the key array, from critbit_lower_n of the range start.
+#define CRITBIT_LINE_QWORDS 8
+
+	u64 critbit_build_n(const u64*, const u64*, const u64);
+	// u64 critbit_build_n ( u64* nodes, u64* keys, u64 n );
+	// build a crit-bit tree over n (less than 2^31) keys, ascending, no duplicates
+	// nodes: 64 byte aligned room for n lines (one if n is 1)
+	// returns: number of lines used
+	// EXTERNDEF	critbit_build_n : PROC
+
+	u64 critbit_lcp_n(const u64*, const u64*);
+	// u64 critbit_lcp_n ( u64* nodes, u64* query );
+	// returns: index of a key with the longest prefix in common with the query (lcp_u gives its length)
+	// EXTERNDEF	critbit_lcp_n : PROC
+
+	u64 critbit_find_n(const u64*, const u64*, const u64*);
+	// u64 critbit_find_n ( u64* nodes, u64* keys, u64* query );
+	// returns: index of the key equal to the query, u64_Max if none
+	// EXTERNDEF	critbit_find_n : PROC
+
+	u64 critbit_lower_n(const u64*, const u64*, const u64*);
+	// u64 critbit_lower_n ( u64* nodes, u64* keys, u64* query );
+	// returns: index of the first key not less than the query, n if none
+	// EXTERNDEF	critbit_lower_n : PROC
+
+	u64 critbit_prefix_n(const u64*, const u64*, const u64*, const u16, const u64*);
+	// u64 critbit_prefix_n ( u64* nodes, u64* keys, u64* query, u16 plen, u64* first );
+	// find the keys sharing the first plen (0 to 512) bits with the query
+	// returns: number of such keys, their indices running from *first (not set if none)
+	// EXTERNDEF	critbit_prefix_n : PROC
+
+	// Radix sort of 512 bit keys, ascending (as compare_u) and stable. Keys are put in order as (word, index) pairs a word at a time,
+	// most significant first, each word by LSD radix sort on 11 bit digits, only for runs of keys equal in the words before; words
+	// and digits that are the same in every key (found by 'OR' / 'AND' reductions) are skipped. Then the keys are gathered in order.
+	// work: RADIX_WORK_QWORDS, 64 byte aligned
+#define RADIX_WORK_QWORDS 6160
+
+	u64 radix_sort_n(const u64*, const u64, const u64*, const u64*);
+	// u64 radix_sort_n ( u64* keys, u64 n, u64* temp, u64* work );
+	// sort n (less than 2^32) keys in place; temp: 64 byte aligned room for n keys and n QWORDS (9 * n QWORDS)
+	// returns: number of words sorted on (0 if all keys are equal, 1 for distinct random keys)
+	// EXTERNDEF	radix_sort_n : PROC
+
+	u64 radix_sort_kv_n(const u64*, const u64*, const u64, const u64*, const u64*);
+	// u64 radix_sort_kv_n ( u64* keys, u64* values, u64 n, u64* temp, u64* work );
+	// as radix_sort_n, each of n QWORD values moving with its key
+	// EXTERNDEF	radix_sort_kv_n : PROC
+
+	u64 radix_index_n(const u64*, const u64*, const u64, const u64*, const u64*);
+	// u64 radix_index_n ( u64* index, u64* keys, u64 n, u64* temp, u64* work );
+	// as radix_sort_n, leaving the keys in place: index (n QWORDS) receives the key indices in key order; temp: 4 * n QWORDS
+	// EXTERNDEF	radix_index_n : PROC
+
+	u64 hash_u(const u64*);
+	// u64 hash_u ( u64* key );
+	// multiply-fold hash of a 512 bit key: lane i, ( w[i] ^ s[i] ) low half times high half, plus w[i ^ 1]; lane pairs XOR fold
+	// constants, multiplied to 128 bits, halves XORd and summed; then avalanched. The same value on every path.
+	// EXTERNDEF	hash_u : PROC
+
+	// Open addressing hash set of 512 bit keys: 'capacity' (a power of two, 64 or more) 64 byte slots, and a tag byte for each,
+	// zero for an empty slot (zero the tags to start), both 64 byte aligned. Slots are in groups of 64, the tags of a group one
+	// line compared at once; the hash selects the first group probed and the seven bit tag. A map keeps its values in an array
+	// indexed by slot. No removal.
+#define HSET_NEW ( 1ull << 63 )
+
+	u64 hset_find_u(const u8*, const u64*, const u64, const u64*);
+	// u64 hset_find_u ( u8* tags, u64* slots, u64 capacity, u64* key );
+	// returns: slot index of the key, u64_Max if not in the set
+	// EXTERNDEF	hset_find_u : PROC
+
+	u64 hset_insert_u(const u8*, const u64*, const u64, const u64*);
+	// u64 hset_insert_u ( u8* tags, u64* slots, u64 capacity, u64* key );
+	// returns: slot index of the key, HSET_NEW set if added by this call; u64_Max if not in the set and the set is full
+	// EXTERNDEF	hset_insert_u : PROC
+
+	u64 hset_find_n(const u8*, const u64*, const u64, const u64*, const u64, const u64*);
+	// u64 hset_find_n ( u8* tags, u64* slots, u64 capacity, u64* keys, u64 n, u64* results );
+	// results[i]: as hset_find_u for keys[i]; probes prefetched ahead. returns: number found
+	// EXTERNDEF	hset_find_n : PROC
+
+	u64 hset_insert_n(const u8*, const u64*, const u64, const u64*, const u64, const u64*);
+	// u64 hset_insert_n ( u8* tags, u64* slots, u64 capacity, u64* keys, u64 n, u64* results );
+	// results[i]: as hset_insert_u for keys[i], in order; probes prefetched ahead. returns: number added
+	// EXTERNDEF	hset_insert_n : PROC
+
+	void clmul_u(const u64*, const u64*, const u64*, const u64*);
+	// void clmul_u ( u64* dest_hi, u64* dest_lo, u64* a, u64* b );
+	// carry-less (GF(2) polynomial, bit i the coefficient of x^i) product: bits 1023 to 512 to dest_hi, 511 to 0 to dest_lo
+	// EXTERNDEF	clmul_u : PROC
+
+	void clmod_mu_u(const u64*, const u64*);
+	// void clmod_mu_u ( u64* mu, u64* poly );
+	// Barrett constant for the modulus x^512 + poly: bits 511 to 0 of x^1024 / ( x^512 + poly ). Once per modulus (512 steps)
+	// EXTERNDEF	clmod_mu_u : PROC
+
+	void clmod_u(const u64*, const u64*, const u64*, const u64*, const u64*);
+	// void clmod_u ( u64* destination, u64* hi, u64* lo, u64* poly, u64* mu );
+	// ( hi * x^512 + lo ) mod ( x^512 + poly ), mu from clmod_mu_u; two carry-less products
+	// EXTERNDEF	clmod_u : PROC
+
+	// 512 x 512 bit matrices over GF(2): 512 rows of 512 bits (8 u64 each, 64 byte aligned), bit j of row i is element ( i, j )
+#define BITMAT_WORK_QWORDS 16384
+
+	void bitmat_transpose_n(const u64*, const u64*);
+	// void bitmat_transpose_n ( u64* destination, u64* source );
+	// bit j of row i of source to bit i of row j of destination; destination may be the source
+	// EXTERNDEF	bitmat_transpose_n : PROC
+
+	void bitmat_vec_u(const u64*, const u64*, const u64*);
+	// void bitmat_vec_u ( u64* destination, u64* vector, u64* matrix );
+	// vector times matrix: XOR of the rows i of matrix for the bits i set in vector; destination may be the vector
+	// EXTERNDEF	bitmat_vec_u : PROC
+
+	void bitmat_mul_n(const u64*, const u64*, const u64, const u64*, const u64*);
+	// void bitmat_mul_n ( u64* c, u64* a, u64 n, u64* b, u64* work );
+	// c = a times b, a and c n rows (each row of a by bitmat_vec_u); Four Russians, work BITMAT_WORK_QWORDS aligned
+	// EXTERNDEF	bitmat_mul_n : PROC
+
+	// bit packing: fields of k bits (1 to 64), PACK_PER_BLOCK(k) to a 64 byte block, none crossing blocks; value i at bit
+	// ( i mod per ) * k of block i / per (bit 0 the least significant of word 7), unused high bits zero
+#define PACK_PER_BLOCK(k) ( 512 / (k) )
+
+	u64 pack_u(const u64*, const u64*, const u64, const u64);
+	// u64 pack_u ( u64* dest_blocks, u64* values, u64 n, u64 k );
+	// values truncated to k bits. returns: blocks written, 0 if k is not 1 to 64
+	// EXTERNDEF	pack_u : PROC
+
+	u64 unpack_u(const u64*, const u64*, const u64, const u64);
+	// u64 unpack_u ( u64* values, u64* blocks, u64 n, u64 k );
+	// returns: n, 0 if k is not 1 to 64
+	// EXTERNDEF	unpack_u : PROC
+
+	u64 unpack_filter_u(const u64*, const u64*, const u64, const u64, const u64, const u64);
+	// u64 unpack_filter_u ( u64* indices, u64* blocks, u64 n, u64 k, u64 lo, u64 hi );
+	// indices (room for n) of the values with lo <= value <= hi, in order. returns: number written, 0 if k is not 1 to 64 or lo > hi
+	// EXTERNDEF	unpack_filter_u : PROC
+
+	void shl_insert_u(const u64*, const u64*, const u16, const u64);
+	// void shl_insert_u ( u64* destination, u64* source, u16 bits, u64 newbits );
+	// ( source << bits ) with the low bits of newbits in the bits vacated; bits 0 to 64, more taken as 64
+	// EXTERNDEF	shl_insert_u : PROC
+
+	void shr_insert_u(const u64*, const u64*, const u16, const u64);
+	// void shr_insert_u ( u64* destination, u64* source, u16 bits, u64 newbits );
+	// ( source >> bits ) with the low bits of newbits in the high bits vacated; bits 0 to 64, more taken as 64
+	// EXTERNDEF	shr_insert_u : PROC
+
+	u64 shl_stream_n(const u64*, const u64*, const u64*, const u64, const u64);
+	// u64 shl_stream_n ( u64* windows, u64* window, u64* symbols, u64 n, u64 bits );
+	// rolling window: windows[i] is window after shl_insert_u of symbols 0 to i; window receives the last.
+	// returns: n, 0 if bits is not 1 to 64
+	// EXTERNDEF	shl_stream_n : PROC
+
+	u64 shl_stream_match_n(const u64*, const u64*, const u64*, const u64, const u64, const u64*, const u64*);
+	// u64 shl_stream_match_n ( u64* indices, u64* window, u64* symbols, u64 n, u64 bits, u64* mask, u64* pattern );
+	// as shl_stream_n, the indices i (room for n) of the windows with ( window AND mask ) equal to pattern.
+	// returns: number of indices, 0 if bits is not 1 to 64
+	// EXTERNDEF	shl_stream_match_n : PROC
+
+	// random: eight xoshiro256** generators, generator i giving word i of each value; state RAND_STATE_QWORDS, 64 byte aligned
+#define RAND_STATE_QWORDS 32
+	// fills of RAND_STREAM values or more are written past the cache (non-temporal stores)
+#define RAND_STREAM 16384
+
+	void rand_seed_u(const u64*, const u64);
+	// void rand_seed_u ( u64* state, u64 seed );
+	// state from successive SplitMix64 outputs of seed: the same seed, the same values after
+	// EXTERNDEF	rand_seed_u : PROC
+
+	void rand_u(const u64*, const u64*);
+	// void rand_u ( u64* destination, u64* state );
+	// EXTERNDEF	rand_u : PROC
+
+	void rand_fill_n(const u64*, const u64*, const u64);
+	// void rand_fill_n ( u64* destination, u64* state, u64 n );
+	// n values, as n calls of rand_u; state held in registers
+	// EXTERNDEF	rand_fill_n : PROC
+
+	// 256 bit forms (4 QWORDS, 32 byte aligned) of shr_u, shl_u, and_u, or_u, xor_u, not_u, msb_u, lsb_u; for ui<256> (uiN.h)
+	void shr256_u(const u64*, const u64*, const u16);
+	// void shr256_u ( u64* destination, u64* source, u16 bits );
+	// EXTERNDEF	shr256_u : PROC
+
+	void shl256_u(const u64*, const u64*, const u16);
+	// void shl256_u ( u64* destination, u64* source, u16 bits );
+	// EXTERNDEF	shl256_u : PROC
+
+	void and256_u(const u64*, const u64*, const u64*);
+	// void and256_u ( u64* destination, u64* lh_op, u64* rh_op );
+	// EXTERNDEF	and256_u : PROC
+
+	void or256_u(const u64*, const u64*, const u64*);
+	// void or256_u ( u64* destination, u64* lh_op, u64* rh_op );
+	// EXTERNDEF	or256_u : PROC
+
+	void xor256_u(const u64*, const u64*, const u64*);
+	// void xor256_u ( u64* destination, u64* lh_op, u64* rh_op );
+	// EXTERNDEF	xor256_u : PROC
+
+	void not256_u(const u64*, const u64*);
+	// void not256_u ( u64* destination, u64* source );
+	// EXTERNDEF	not256_u : PROC
+
+	s16 msb256_u(const u64*);
+	// s16 msb256_u ( u64* source );
+	// returns: -1 if zero, bit number (0 to 255) otherwise
+	// EXTERNDEF	msb256_u : PROC
+
+	s16 lsb256_u(const u64*);
+	// s16 lsb256_u ( u64* source );
+	// returns: -1 if zero, bit number (0 to 255) otherwise
+	// EXTERNDEF	lsb256_u : PROC
+
+	u32 options_u();
+	// u32 options_u ( void );
+	// the options ui512b.asm was assembled with: 'Z', 'Y', 'X' or 'Q' (the path used) in bits 0 to 7, then the flags below
+#define OPTIONS_ISA(o) char( (o) & 0xFF )
+#define OPTIONS_BMI2 0x100u
+#define OPTIONS_CHECKALIGN 0x200u
+#define OPTIONS_INSTRUMENT 0x400u
+#define OPTIONS_SYSV 0x800u
+	// EXTERNDEF	options_u : PROC
+
+	// with __Instrument, each proc counts its calls and the cycles they took (read with ui512instrument.h)
+	// a proc's slots: InstrumentSlots, one for each of InstrumentThreads threads (given on a thread's first call), then one
+	// shared by any more; each calls, total cycles, then InstrumentBuckets counts: bucket b the calls taking 2^b to
+	// 2^(b+1) - 1 cycles, the last all longer
+	constexpr int InstrumentThreads = 64;
+	constexpr int InstrumentSlots = InstrumentThreads + 1;
+	constexpr int InstrumentBuckets = 30;
+	struct instrument_slot_u
+	{
+		u64 calls;
+		u64 cycles;
+		u64 buckets[InstrumentBuckets];
+	};
+	struct instrument_entry_u
+	{
+		const char* name;
+		instrument_slot_u* slots;
+	};
+	extern instrument_entry_u instrument_table_u[];
+	// instrument_entry_u instrument_table_u[ ]; an entry for each proc (none without __Instrument), then { 0, 0 }
+	// EXTERNDEF	instrument_table_u : QWORD
+	extern u64 instrument_threads_u[InstrumentThreads];
+	// u64 instrument_threads_u[ InstrumentThreads ]; the id of the thread given each slot number, 0 free
+	// EXTERNDEF	instrument_threads_u : QWORD
+
+	u32 set_vector_policy_u(const u32);
+	// u32 set_vector_policy_u ( u32 policy );
+	// VECTOR_WIDE (the default): ZMM in every proc; VECTOR_LIGHT: shr_u, shl_u, and_u, or_u, xor_u, not_u, msb_u, lsb_u in GPRs
+	// or 256 bit halves, so occasional calls do not lower the clock of the code around them; the _n procs keep ZMM (Z only)
+	// returns: the previous policy (a policy other than these is not taken)
+#define VECTOR_WIDE 0u
+#define VECTOR_LIGHT 1u
+	// EXTERNDEF	set_vector_policy_u : PROC
+
+	// pipeline: a list of ops over slots, run over whole arrays a tile of PIPE_TILE records at a time, each op over the tile
+	// before the next, so intermediates stay in L1 and a chain of ops is one pass over memory (ui512pipe.h builds the lists)
+#define PIPE_TILE 64
+	struct pipe_slot_u
+	{
+		const void* base;			// record 0 of an array, a constant, or a tile buffer (PIPE_TILE records)
+		u32 stride;					// bytes from one record's operand to the next: 64 records, 0 a constant, 2 s16 results
+		u32 tile;					// non-zero: a tile buffer, record i at base + ( i mod PIPE_TILE ) * stride
+	};
+	struct pipe_op_u
+	{
+		u8 op;						// PIPE_SHR ...
+		u8 d, a, b, c;				// slot numbers: d = op( a, b, c )
+		u8 imm;						// PIPE_TERN: the function of a, b, c, as VPTERNLOGQ
+		u16 bits;					// PIPE_SHR, PIPE_SHL
+	};
+#define PIPE_SHR 0u
+#define PIPE_SHL 1u
+#define PIPE_AND 2u
+#define PIPE_OR 3u
+#define PIPE_XOR 4u
+#define PIPE_NOT 5u
+#define PIPE_TERN 6u
+#define PIPE_POPCNT 7u
+#define PIPE_MSB 8u
+#define PIPE_LSB 9u
+
+	u64 pipe_run_n(const pipe_slot_u*, const pipe_op_u*, const u64, const u64, const u64);
+	// u64 pipe_run_n ( pipe_slot_u* slots, pipe_op_u* ops, u64 nops, u64 first, u64 n );
+	// the ops, in order, on records first to first + n - 1; d may be a, b or c; PIPE_POPCNT, PIPE_MSB, PIPE_LSB write s16 to d
+	// returns: the total of the PIPE_POPCNT counts
+	// For several threads: give each its own records (first, n) and its own tile buffers
+	// EXTERNDEF	pipe_run_n : PROC
+
+	// text: 128 hex digits (written lower case, read in either case) or 512 binary digits, most significant first (binary:
+	// character i the bit 511 - i, as msb_u / lsb_u number them); any alignment, no terminator
+	void to_hex_u(char*, const u64*);
+	// void to_hex_u ( char* text, u64* source );
+	// EXTERNDEF	to_hex_u : PROC
+
+	s16 from_hex_u(const u64*, const char*);
+	// s16 from_hex_u ( u64* destination, char* text );
+	// returns: -1 if all 128 are hex digits, otherwise the index of the first that is not (destination then incomplete)
+	// EXTERNDEF	from_hex_u : PROC
+
+	void to_bin_u(char*, const u64*);
+	// void to_bin_u ( char* text, u64* source );
+	// EXTERNDEF	to_bin_u : PROC
+
+	s16 from_bin_u(const u64*, const char*);
+	// s16 from_bin_u ( u64* destination, char* text );
+	// returns: -1 if all 512 are '0' or '1', otherwise the index of the first that is not (destination then incomplete)
+	// EXTERNDEF	from_bin_u : PROC
+
+	// n values, the text of each stride characters after the one before (stride 128, or 512, or more); the characters
+	// between left as they are, so a buffer with separators or line ends set once can be filled batch after batch
+	void to_hex_n(char*, const u64*, const u64, const u64);
+	// void to_hex_n ( char* text, u64* sources, u64 n, u64 stride );
+	// EXTERNDEF	to_hex_n : PROC
+
+	u64 from_hex_n(const u64*, const char*, const u64, const u64);
+	// u64 from_hex_n ( u64* destinations, char* text, u64 n, u64 stride );
+	// returns: the number of values read, n or the index of the first with a character not a hex digit
+	// EXTERNDEF	from_hex_n : PROC
+
+	void to_bin_n(char*, const u64*, const u64, const u64);
+	// void to_bin_n ( char* text, u64* sources, u64 n, u64 stride );
+	// EXTERNDEF	to_bin_n : PROC
+
+	u64 from_bin_n(const u64*, const char*, const u64, const u64);
+	// u64 from_bin_n ( u64* destinations, char* text, u64 n, u64 stride );
+	// returns: the number of values read, n or the index of the first with a character not '0' or '1'
+	// EXTERNDEF	from_bin_n : PROC
+
+	// predicates, a bool and no index (for that, msb_u / compare_u): all words at once, to a flag
+	s16 is_zero_u(const u64*);
+	// s16 is_zero_u ( u64* a );
+	// returns: 1 if a is zero, 0 if not
+	// EXTERNDEF	is_zero_u : PROC
+
+	s16 eq_u(const u64*, const u64*);
+	// s16 eq_u ( u64* a, u64* b );
+	// returns: 1 if a equals b, 0 if not
+	// EXTERNDEF	eq_u : PROC
+
+	s16 subset_u(const u64*, const u64*);
+	// s16 subset_u ( u64* a, u64* b );
+	// returns: 1 if a AND NOT b is zero (every bit of a set in b), 0 if not
+	// EXTERNDEF	subset_u : PROC
+
+	s16 intersects_u(const u64*, const u64*);
+	// s16 intersects_u ( u64* a, u64* b );
+	// returns: 1 if a AND b is not zero, 0 if not
+	// EXTERNDEF	intersects_u : PROC
+
+	// over n records: bits, (n + 63) / 64 QWORDS, bit i % 64 of QWORD i / 64 set if the predicate holds for record i;
+	// b_stride 64: b an array, b[ i ] with a[ i ]; 0: b one value, for every record
+	u64 is_zero_n(const u64*, const u64*, const u64);
+	// u64 is_zero_n ( u64* bits, u64* a, u64 n );
+	// returns: the number of records that are zero
+	// EXTERNDEF	is_zero_n : PROC
+
+	u64 eq_n(const u64*, const u64*, const u64*, const u64, const u64);
+	// u64 eq_n ( u64* bits, u64* a, u64* b, u64 n, u64 b_stride );
+	// returns: the number of records equal to their b
+	// EXTERNDEF	eq_n : PROC
+
+	u64 subset_n(const u64*, const u64*, const u64*, const u64, const u64);
+	// u64 subset_n ( u64* bits, u64* a, u64* b, u64 n, u64 b_stride );
+	// returns: the number of records a subset of their b
+	// EXTERNDEF	subset_n : PROC
+
+	u64 intersects_n(const u64*, const u64*, const u64*, const u64, const u64);
+	// u64 intersects_n ( u64* bits, u64* a, u64* b, u64 n, u64 b_stride );
+	// returns: the number of records with a bit in common with their b
+	// EXTERNDEF	intersects_n : PROC
 };
 
 #endif
\ No newline at end of file
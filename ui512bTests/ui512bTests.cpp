@@ -32,17 +32,29 @@
 //		This sub - project: ui512aTests, is a unit test project that invokes each of the routines in the ui512a assembly.
 //		It runs each assembler proc with pseudo - random values.
 //		It validates ( asserts ) expected and returned results.
-//		It also runs each repeatedly for comparative timings.
+//		Timings (latency and throughput, ns and cycles, to JSON) are in the ui512bBench project.
 //		It provides a means to invoke and debug.
 //		It illustrates calling the routines from C++.
 
 #include "pch.h"
 #include "CppUnitTest.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <format>
+#include <intrin.h>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include "ui512a.h"
+#include "ui512arena.h"
 #include "ui512b.h"
+#include "ui512bitmap.h"
+#include "ui512file.h"
+#include "ui512instrument.h"
+#include "ui512pipe.h"
+#include "uiN.h"
 
 using namespace std;
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -55,7 +67,6 @@ namespace ui512bTests
 
 		const s32 runcount = 2500;
 		const s32 regvercount = 5000;
-		const s32 timingcount = 100000000;
 
 		/// <summary>
 		/// Random number generator
@@ -157,6 +168,16 @@ namespace ui512bTests
 				Logger::WriteMessage(test_message.c_str());
 			};
 
+			shr_u(num1, pattern, 40000);										// the count is u16: above 32767 too
+			for (int j = 0; j < 8; j++)
+			{
+				Assert::AreEqual(0ull, num1[j]);
+			};
+			{
+				string test_message = "Shift right function testing. Edge case. Shift 40000, should be all zero. Tested true by assert\n";
+				Logger::WriteMessage(test_message.c_str());
+			};
+
 			shr_u(num1, pattern, 1);
 			for (int j = 0; j < 8; j++)
 			{
@@ -271,29 +292,6 @@ namespace ui512bTests
 			Logger::WriteMessage(test_message.c_str());
 		};
 
-		TEST_METHOD(ui512bits_01_shr_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			u16 shftcnt = 0;
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);;
-			};
-
-			shftcnt = RandomU64(&seed) % 512;
-
-			for (int i = 0; i < timingcount; i++)
-			{
-
-				shr_u(num2, num1, shftcnt);
-			};
-
-			string test_message = "Shift right function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 		TEST_METHOD(ui512bits_01_SHR_reg)
 		{
 			// shr_u function register verification.
@@ -356,6 +354,16 @@ namespace ui512bTests
 				Logger::WriteMessage(test_message.c_str());
 			};
 
+			shl_u(num1, pattern, 40000);										// the count is u16: above 32767 too
+			for (int j = 0; j < 8; j++)
+			{
+				Assert::AreEqual(0ull, num1[j]);
+			};
+			{
+				string test_message = "Shift left function testing. Edge case. Shift 40000, should be all zero. Tested true by assert\n";
+				Logger::WriteMessage(test_message.c_str());
+			};
+
 			shl_u(num1, pattern, 1);
 			for (int j = 0; j < 8; j++)
 			{
@@ -473,27 +481,6 @@ namespace ui512bTests
 			Logger::WriteMessage(test_message.c_str());
 		};
 
-		TEST_METHOD(ui512bits_02_shl_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			u16 shftcnt = 0;
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);;
-			};
-
-			shftcnt = RandomU64(&seed) % 512;
-			for (int i = 0; i < timingcount; i++)
-			{
-				shl_u(num2, num1, shftcnt);
-			};
-
-			string test_message = "Shift left function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 		TEST_METHOD(ui512bits_02_SHL_reg)
 		{
 			// shl_u function register verification.
@@ -551,27 +538,6 @@ namespace ui512bTests
 			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
 		};
 
-		TEST_METHOD(ui512bits_03_and_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 result[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);
-				num2[j] = RandomU64(&seed);
-			};
-
-			for (int i = 0; i < timingcount; i++)
-			{
-				and_u(result, num2, num1);
-			};
-
-			string test_message = "'AND' function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 		TEST_METHOD(ui512bits_03_AND_reg)
 		{
 			// and_u function register verification.
@@ -628,28 +594,6 @@ namespace ui512bTests
 			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
 		};
 
-		TEST_METHOD(ui512bits_04_or_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 result[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);
-				num2[j] = RandomU64(&seed);
-			};
-
-			for (int i = 0; i < timingcount; i++)
-			{
-				or_u(result, num2, num1);
-			};
-
-			string test_message = "'OR' function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 		TEST_METHOD(ui512bits_04_OR_reg)
 		{
 			// or_u function register verification.
@@ -704,28 +648,6 @@ namespace ui512bTests
 			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
 		};
 
-		TEST_METHOD(ui512bits_04_xor_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			alignas (64) u64 result[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);
-				num2[j] = RandomU64(&seed);
-			};
-
-			for (int i = 0; i < timingcount; i++)
-			{
-				xor_u(result, num2, num1);
-			};
-
-			string test_message = "'XOR' function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 		TEST_METHOD(ui512bits_04_XOR_reg)
 		{
 			// xor_u function register verification.
@@ -780,24 +702,6 @@ namespace ui512bTests
 			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
 		};
 
-		TEST_METHOD(ui512bits_05_not_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);
-			};
-
-			for (int i = 0; i < timingcount; i++)
-			{
-				not_u(num1, num1);
-			};
-
-			string test_message = "NOT function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 
 		TEST_METHOD(ui512bits_05_NOT_reg)
 		{
@@ -917,26 +821,6 @@ namespace ui512bTests
 			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
 		};
 
-		TEST_METHOD(ui512bits_06_msb_timing)
-		{
-			u64 seed = 0;
-			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			s16 bitloc = 0;
-
-			for (int j = 0; j < 8; j++)
-			{
-				num1[j] = RandomU64(&seed);
-			};
-
-			for (int i = 0; i < timingcount; i++)
-			{
-				bitloc = msb_u(num1);
-			};
-
-			string test_message = "MSB function timing. Ran " + to_string(timingcount) + " times.\n";
-			Logger::WriteMessage(test_message.c_str());
-		};
-
 		TEST_METHOD(ui512bits_06_msb_reg)
 		{
 			// msb_u function register verification.
@@ -1052,29 +936,134 @@ namespace ui512bTests
 			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
 		};
 
-		TEST_METHOD(ui512bits_07_lsb_timing)
+		TEST_METHOD(ui512bits_07_lsb_reg)
+		{
+			// lsb_u function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				s16 result = lsb_u(num1);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "lsb_u function register validation. Ran " + to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		/// <summary>
+		/// Test a bit of a 512 bit value, bits numbered as msb_u / lsb_u (0 is the low bit of word [7], 511 the high bit of word [0])
+		/// </summary>
+		bool BitSet(const u64* num, int bit)
+		{
+			return ((num[7 - bit / 64] >> (bit % 64)) & 1ull) != 0;
+		};
+
+		TEST_METHOD(ui512bits_08_popcnt)
 		{
 			u64 seed = 0;
 			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
-			s16 bitloc = 0;
+			alignas (64) u64 ones[8]{ u64_Max, u64_Max, u64_Max, u64_Max, u64_Max, u64_Max, u64_Max, u64_Max };
 
-			for (int j = 0; j < 8; j++)
+			Assert::AreEqual(s16(0), popcnt_u(num1));
+			Assert::AreEqual(s16(512), popcnt_u(ones));
+
+			for (int i = 0; i < runcount; i++)
 			{
-				num1[j] = RandomU64(&seed);
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = RandomU64(&seed) & RandomU64(&seed);	// sparser than a single random value
+				};
+
+				s16 expected = 0;
+				for (int b = 0; b < 512; b++)
+				{
+					expected += BitSet(num1, b) ? 1 : 0;
+				};
+
+				Assert::AreEqual(expected, popcnt_u(num1));
 			};
 
-			for (int j = 0; j < timingcount; j++)
+			string test_message = "Population count function testing. Ran tests " + to_string(runcount) + " times, each with pseudo random values.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_08_popcnt_reg)
+		{
+			// popcnt_u function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{};
+			for (int i = 0; i < regvercount; i++)
 			{
-				bitloc = lsb_u(num1);
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				s16 result = popcnt_u(num1);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
 			};
 
-			string test_message = "LSB function timing. Ran " + to_string(timingcount) + " times.\n";
+			string test_message = "popcnt_u function register validation. Ran " + to_string(regvercount) + " times.\n";
 			Logger::WriteMessage(test_message.c_str());
 		};
 
-		TEST_METHOD(ui512bits_07_lsb_reg)
+		TEST_METHOD(ui512bits_09_rank)
 		{
-			// lsb_u function register verification.
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+			int adjruncount = runcount / 64;
+
+			Assert::AreEqual(s16(0), rank_u(num1, 0));
+			Assert::AreEqual(s16(0), rank_u(num1, 512));
+
+			for (int i = 0; i < adjruncount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = (i & 1) ? RandomU64(&seed) : RandomU64(&seed) & RandomU64(&seed) & RandomU64(&seed);
+				};
+
+				s16 expected = 0;
+				for (int b = 0; b <= 512; b++)
+				{
+					Assert::AreEqual(expected, rank_u(num1, u16(b)));
+					if (b < 512)
+					{
+						expected += BitSet(num1, b) ? 1 : 0;
+					};
+				};
+
+				Assert::AreEqual(expected, rank_u(num1, 1000));		// past the end counts all bits
+				Assert::AreEqual(popcnt_u(num1), rank_u(num1, 512));
+			};
+
+			string test_message = "Rank function testing. Ran tests " + to_string(adjruncount) + " times, each with pseudo random values. Every bit location checked.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_09_rank_reg)
+		{
+			// rank_u function register verification.
 			//	Check register before call, verify non-volatile register remain unchanged after call.
 			regs r_before{};
 			regs r_after{};
@@ -1088,13 +1077,2817 @@ namespace ui512bTests
 				};
 				r_before.Clear();
 				reg_verify((u64*)&r_before);
-				s16 result = lsb_u(num1);
+				s16 result = rank_u(num1, u16(i % 513));
 				r_after.Clear();
 				reg_verify((u64*)&r_after);
 				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
 			};
 
-			string test_message = "lsb_u function register validation. Ran " + to_string(regvercount) + " times.\n";
+			string test_message = "rank_u function register validation. Ran " + to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_10_select)
+		{
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+			int adjruncount = runcount / 64;
+
+			Assert::AreEqual(s16(-1), select_u(num1, 0));
+
+			alignas (64) u64 choosebit[8]{ 0, 9, 0, 0, 0, 0x8000000000000000, 0xff, 0 };
+			Assert::AreEqual(lsb_u(choosebit), select_u(choosebit, 0));
+			Assert::AreEqual(s16(71), select_u(choosebit, 7));
+			Assert::AreEqual(s16(191), select_u(choosebit, 8));
+			Assert::AreEqual(msb_u(choosebit), select_u(choosebit, 10));
+			Assert::AreEqual(s16(-1), select_u(choosebit, 11));
+
+			for (int i = 0; i < adjruncount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = (i & 1) ? RandomU64(&seed) : RandomU64(&seed) & RandomU64(&seed) & RandomU64(&seed);
+				};
+
+				u16 k = 0;
+				for (int b = 0; b < 512; b++)
+				{
+					if (BitSet(num1, b))
+					{
+						Assert::AreEqual(s16(b), select_u(num1, k));
+						Assert::AreEqual(s16(k), rank_u(num1, u16(b)));
+						k++;
+					};
+				};
+
+				Assert::AreEqual(s16(-1), select_u(num1, k));
+				Assert::AreEqual(s16(-1), select_u(num1, 600));
+			};
+
+			string test_message = "Select function testing. Ran tests " + to_string(adjruncount) + " times, each with pseudo random values. Every set bit checked.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_10_select_reg)
+		{
+			// select_u function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				s16 result = select_u(num1, u16(i % 300));
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "select_u function register validation. Ran " + to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_11_rsindex)
+		{
+			u64 seed = 0;
+			const u64 nblocks = 200;
+			alignas (64) static u64 blocks[nblocks * 8]{};
+			static u64 counts[nblocks + 1]{};
+			static u64 hints[nblocks / 8 + 2]{};
+
+			// mix of empty, sparse, and dense blocks
+			for (u64 b = 0; b < nblocks; b++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					u64 r = RandomU64(&seed);
+					blocks[b * 8 + j] = (b % 5 == 0) ? 0 : (b % 3 == 0) ? r & RandomU64(&seed) & RandomU64(&seed) : r;
+				};
+			};
+
+			u64 total = rsindex_n(counts, hints, blocks, nblocks);
+			u64 expected = 0;
+			for (u64 b = 0; b < nblocks; b++)
+			{
+				Assert::AreEqual(expected, counts[b]);
+				expected += u64(popcnt_u(&blocks[b * 8]));
+			};
+			Assert::AreEqual(expected, total);
+			Assert::AreEqual(expected, counts[nblocks]);
+
+			// walk every bit: rank of each bit, and select of each set bit
+			u64 k = 0;
+			for (u64 i = 0; i < nblocks * 512; i++)
+			{
+				Assert::AreEqual(k, rank_n(counts, blocks, i));
+				if (BitSet(&blocks[(i / 512) * 8], int(i % 512)))
+				{
+					Assert::AreEqual(i, select_n(counts, hints, blocks, nblocks, k));
+					k++;
+				};
+			};
+			Assert::AreEqual(total, rank_n(counts, blocks, nblocks * 512));
+			Assert::AreEqual(u64_Max, select_n(counts, hints, blocks, nblocks, total));
+			Assert::AreEqual(u64_Max, select_n(counts, hints, blocks, nblocks, total + 5000));
+
+			string test_message = "Rank / select index testing. Indexed " + to_string(nblocks) + " blocks, " + to_string(total) + " set bits. Every bit location checked.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_12_bloom)
+		{
+			u64 seed = 0;
+			const u64 nblocks = 64;
+			const u16 k = 6;
+			const int nkeys = 4000;
+			alignas (64) static u64 filter[nblocks * 8]{};
+			alignas (64) u64 pattern[8]{};
+			alignas (64) u64 pattern2[8]{};
+			static u64 keys[nkeys]{};
+
+			// pattern: 1 to k bits, same each time for the same hash, none for k of zero
+			for (int i = 0; i < runcount / 100; i++)
+			{
+				u64 hash = RandomU64(&seed);
+				u16 kk = u16(i % 16);
+				bloom_pattern_u(pattern, hash, kk);
+				bloom_pattern_u(pattern2, hash, kk);
+				s16 bits = popcnt_u(pattern);
+				Assert::IsTrue(bits <= kk && (kk == 0 || bits >= 1));
+				for (int j = 0; j < 8; j++)
+				{
+					Assert::AreEqual(pattern[j], pattern2[j]);
+				};
+			};
+
+			// no false negatives: every added key tests present, and its pattern is in its block
+			for (int i = 0; i < nkeys; i++)
+			{
+				keys[i] = RandomU64(&seed);
+				bloom_add_u(filter, nblocks, keys[i], k);
+			};
+			for (int i = 0; i < nkeys; i++)
+			{
+				Assert::AreEqual(s16(1), bloom_test_u(filter, nblocks, keys[i], k));
+			};
+			u64 setbits = 0;
+			for (u64 b = 0; b < nblocks; b++)
+			{
+				setbits += u64(popcnt_u(&filter[b * 8]));
+			};
+			Assert::IsTrue(setbits > 0 && setbits <= nkeys * k);
+
+			// false positive rate for ~62 keys per block, 6 bits each: expect about 2.5%
+			int falsepos = 0;
+			const int probes = 100000;
+			for (int i = 0; i < probes; i++)
+			{
+				falsepos += bloom_test_u(filter, nblocks, RandomU64(&seed), k);
+			};
+			Assert::IsTrue(falsepos < probes / 10, L"False positive rate too high");
+
+			// empty filter has nothing
+			alignas (64) u64 empty[8]{};
+			Assert::AreEqual(s16(0), bloom_test_u(empty, 1, keys[0], k));
+
+			string test_message = "Bloom filter testing. Added " + to_string(nkeys) + " keys to " + to_string(nblocks) + " blocks, k = " + to_string(k)
+				+ ". False positives: " + to_string(falsepos) + " of " + to_string(probes) + " probes.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_12_bloom_reg)
+		{
+			// bloom_add_u, bloom_test_u, bloom_add_n, bloom_test_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const u64 nblocks = 16;
+			alignas (64) static u64 filter[nblocks * 8]{};
+			u64 hashes[100]{};
+			u64 results[2]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				for (int j = 0; j < 100; j++)
+				{
+					hashes[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				bloom_add_u(filter, nblocks, hashes[0], 7);
+				s16 result = bloom_test_u(filter, nblocks, hashes[1], 7);
+				bloom_add_n(filter, nblocks, hashes, 50, 7);
+				bloom_test_n(filter, nblocks, hashes, 100, 7, results);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "bloom_add_u, bloom_test_u, bloom_add_n, bloom_test_n function register validation. Ran " + to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_13_bloom_n)
+		{
+			u64 seed = 0;
+			const u64 nblocks = 37;
+			const int nkeys = 1000;
+			alignas (64) static u64 filter1[nblocks * 8]{};
+			alignas (64) static u64 filter2[nblocks * 8]{};
+			static u64 hashes[nkeys]{};
+			static u64 probes[nkeys]{};
+			static u64 results[(nkeys + 63) / 64]{};
+
+			for (int i = 0; i < nkeys; i++)
+			{
+				hashes[i] = RandomU64(&seed);
+				probes[i] = (i & 1) ? hashes[i] : RandomU64(&seed);		// half added, half (mostly) not
+			};
+
+			// batched add sets the same bits as one at a time
+			for (int i = 0; i < nkeys; i++)
+			{
+				bloom_add_u(filter1, nblocks, hashes[i], 5);
+			};
+			bloom_add_n(filter2, nblocks, hashes, nkeys, 5);
+			for (u64 j = 0; j < nblocks * 8; j++)
+			{
+				Assert::AreEqual(filter1[j], filter2[j]);
+			};
+
+			// batched test gives the same answers as one at a time, for every count up to a few QWORDS of results
+			for (int n = 0; n <= 200; n++)
+			{
+				for (int j = 0; j < (nkeys + 63) / 64; j++)
+				{
+					results[j] = u64_Max;
+				};
+				bloom_test_n(filter2, nblocks, probes, u64(n), 5, results);
+				for (int i = 0; i < n; i++)
+				{
+					bool expected = bloom_test_u(filter2, nblocks, probes[i], 5) == 1;
+					Assert::AreEqual(expected, ((results[i / 64] >> (i % 64)) & 1ull) != 0);
+				};
+				for (int j = (n + 63) / 64; j < (nkeys + 63) / 64; j++)
+				{
+					Assert::AreEqual(u64_Max, results[j]);		// nothing written past the last result QWORD
+				};
+			};
+
+			bloom_test_n(filter2, nblocks, probes, nkeys, 5, results);
+			for (int i = 1; i < nkeys; i += 2)
+			{
+				Assert::IsTrue(((results[i / 64] >> (i % 64)) & 1ull) != 0);		// added keys always present
+			};
+
+			string test_message = "Bloom filter batch add / test testing. " + to_string(nkeys) + " keys, compared with single key functions.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		/// <summary>
+		/// Reference for the match functions: ( record AND mask ) equals pattern
+		/// </summary>
+		bool MaskedEqual(const u64* rec, const u64* mask, const u64* pattern)
+		{
+			for (int j = 0; j < 8; j++)
+			{
+				if ((rec[j] & mask[j]) != pattern[j])
+				{
+					return false;
+				};
+			};
+			return true;
+		};
+
+		TEST_METHOD(ui512bits_14_match)
+		{
+			u64 seed = 0;
+			const u64 nrecs = 500;
+			alignas (64) static u64 records[nrecs * 8]{};
+			alignas (64) u64 mask[8]{};
+			alignas (64) u64 pattern[8]{};
+			static u64 indices[nrecs]{};
+			static u64 bitmap[(nrecs + 63) / 64]{};
+			int adjruncount = runcount / 25;
+
+			// records: few distinct values in the masked bits, so a fair share match
+			for (u64 r = 0; r < nrecs * 8; r++)
+			{
+				records[r] = RandomU64(&seed);
+			};
+			for (int i = 0; i < adjruncount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					mask[j] = (j == i % 8) ? 0x0300000000000011ull : (i & 1) ? 0 : 0x8000000000000000ull;
+				};
+				for (u64 r = 0; r < nrecs; r++)
+				{
+					records[r * 8 + (i % 8)] ^= RandomU64(&seed) & 0x0300000000000011ull;
+				};
+				u64 pick = RandomU64(&seed) % nrecs;
+				for (int j = 0; j < 8; j++)
+				{
+					pattern[j] = records[pick * 8 + j] & mask[j];
+				};
+				if (i % 10 == 9)
+				{
+					pattern[7] |= ~mask[7];		// bits outside the mask in the pattern: nothing matches
+				};
+
+				for (u64 n = (i == 0) ? 0 : nrecs - (i % 70); n <= nrecs; n++)
+				{
+					u64 count = match_n(records, n, mask, pattern, indices);
+					u64 bitcount = match_bits_n(records, n, mask, pattern, bitmap);
+					Assert::AreEqual(count, bitcount);
+					u64 k = 0;
+					for (u64 r = 0; r < n; r++)
+					{
+						bool expected = MaskedEqual(&records[r * 8], mask, pattern);
+						Assert::AreEqual(expected, ((bitmap[r / 64] >> (r % 64)) & 1ull) != 0);
+						if (expected)
+						{
+							Assert::AreEqual(r, indices[k]);
+							k++;
+						};
+					};
+					Assert::AreEqual(k, count);
+					Assert::IsTrue(i % 10 == 9 || n <= pick || count > 0);
+				};
+			};
+
+			string test_message = "Masked pattern match function testing. Ran tests " + to_string(adjruncount) + " times, each with " + to_string(nrecs) + " pseudo random records.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_14_match_reg)
+		{
+			// match_n, match_bits_n, match_any_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const u64 nrecs = 70;
+			alignas (64) static u64 records[nrecs * 8]{};
+			alignas (64) u64 masks[16]{};
+			alignas (64) u64 patterns[16]{};
+			static u64 indices[nrecs]{};
+			u64 bitmap[2]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				for (u64 r = 0; r < nrecs * 8; r++)
+				{
+					records[r] = RandomU64(&seed);
+				};
+				masks[i % 16] = RandomU64(&seed);
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				u64 count = match_n(records, nrecs, masks, patterns, indices);
+				count = match_bits_n(records, nrecs, masks, patterns, bitmap);
+				count = match_any_n(records, nrecs, masks, patterns, 2, indices);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "match_n, match_bits_n, match_any_n function register validation. Ran " + to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_15_match_any)
+		{
+			u64 seed = 0;
+			const u64 nrecs = 300;
+			const u64 maxpat = 5;
+			alignas (64) static u64 records[nrecs * 8]{};
+			alignas (64) static u64 masks[maxpat * 8]{};
+			alignas (64) static u64 patterns[maxpat * 8]{};
+			static u64 indices[nrecs]{};
+			static u64 single[nrecs]{};
+			int adjruncount = runcount / 25;
+
+			for (u64 r = 0; r < nrecs * 8; r++)
+			{
+				records[r] = RandomU64(&seed) & 0x0000000300000003ull;
+			};
+
+			for (int i = 0; i < adjruncount; i++)
+			{
+				// each pair: mask on one or two words, pattern from a random record
+				for (u64 p = 0; p < maxpat; p++)
+				{
+					u64 pick = RandomU64(&seed) % nrecs;
+					for (int j = 0; j < 8; j++)
+					{
+						masks[p * 8 + j] = (RandomU64(&seed) % 3 == 0) ? 0x0000000300000003ull : 0;
+						patterns[p * 8 + j] = records[pick * 8 + j] & masks[p * 8 + j];
+					};
+				};
+
+				for (u64 npat = 0; npat <= maxpat; npat++)
+				{
+					u64 count = match_any_n(records, nrecs, masks, patterns, npat, indices);
+					u64 k = 0;
+					for (u64 r = 0; r < nrecs; r++)
+					{
+						bool expected = false;
+						for (u64 p = 0; p < npat; p++)
+						{
+							expected = expected || MaskedEqual(&records[r * 8], &masks[p * 8], &patterns[p * 8]);
+						};
+						if (expected)
+						{
+							Assert::AreEqual(r, indices[k]);
+							k++;
+						};
+					};
+					Assert::AreEqual(k, count);
+
+					// one pattern is the same as match_n
+					if (npat == 1)
+					{
+						Assert::AreEqual(count, match_n(records, nrecs, masks, patterns, single));
+						for (u64 m = 0; m < count; m++)
+						{
+							Assert::AreEqual(indices[m], single[m]);
+						};
+					};
+				};
+			};
+
+			string test_message = "Masked pattern match, any of several patterns, function testing. Ran tests " + to_string(adjruncount) + " times, 0 to " + to_string(maxpat) + " patterns.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		/// <summary>
+		/// Reference Tanimoto score, as tanimoto_u: popcount( a AND b ) / popcount( a OR b ), 31 fraction bits
+		/// </summary>
+		u64 RefTanimoto(const u64* a, const u64* b)
+		{
+			u64 andcount = 0;
+			u64 orcount = 0;
+			for (int bit = 0; bit < 512; bit++)
+			{
+				andcount += (BitSet(a, bit) && BitSet(b, bit)) ? 1 : 0;
+				orcount += (BitSet(a, bit) || BitSet(b, bit)) ? 1 : 0;
+			};
+			return (andcount << TANIMOTO_SHIFT) / (orcount == 0 ? 1 : orcount);
+		};
+
+		TEST_METHOD(ui512bits_16_tanimoto)
+		{
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+
+			Assert::AreEqual(u32(0), tanimoto_u(num1, num2));
+			num1[3] = 0x10;
+			Assert::AreEqual(u32(0), tanimoto_u(num1, num2));
+			Assert::AreEqual(TANIMOTO_ONE, tanimoto_u(num1, num1));
+			num2[3] = 0x30;
+			Assert::AreEqual(TANIMOTO_ONE / 2, tanimoto_u(num1, num2));
+
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = RandomU64(&seed);
+					num2[j] = (i & 1) ? num1[j] ^ (RandomU64(&seed) & RandomU64(&seed) & RandomU64(&seed)) : RandomU64(&seed) & RandomU64(&seed);
+				};
+				Assert::AreEqual(RefTanimoto(num1, num2), u64(tanimoto_u(num1, num2)));
+				Assert::AreEqual(tanimoto_u(num2, num1), tanimoto_u(num1, num2));
+			};
+
+			string test_message = "Tanimoto similarity function testing. Ran tests " + to_string(runcount) + " times, each with pseudo random values.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_16_tanimoto_reg)
+		{
+			// popcnt_n, tanimoto_u, tanimoto_topk_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const u64 nrecs = 40;
+			alignas (64) static u64 records[nrecs * 8]{};
+			static u16 counts[nrecs]{};
+			u64 results[10]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				for (u64 r = 0; r < nrecs * 8; r++)
+				{
+					records[r] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				u64 total = popcnt_n(counts, records, nrecs);
+				u32 score = tanimoto_u(&records[0], &records[8]);
+				u64 found = tanimoto_topk_n(results, 10, &records[8], records, counts, nrecs);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "popcnt_n, tanimoto_u, tanimoto_topk_n function register validation. Ran " + to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_17_tanimoto_topk)
+		{
+			u64 seed = 0;
+			const u64 nrecs = 2000;
+			const u64 maxk = 40;
+			alignas (64) static u64 records[nrecs * 8]{};
+			alignas (64) u64 query[8]{};
+			static u16 counts[nrecs]{};
+			static u64 expected[nrecs]{};
+			u64 results[maxk]{};
+			int adjruncount = runcount / 250;
+
+			for (int i = 0; i < adjruncount; i++)
+			{
+				// records: some near the query, the rest random of varying density; a few duplicates (equal scores)
+				for (int j = 0; j < 8; j++)
+				{
+					query[j] = RandomU64(&seed) & RandomU64(&seed);
+				};
+				for (u64 r = 0; r < nrecs; r++)
+				{
+					for (int j = 0; j < 8; j++)
+					{
+						u64 noise = RandomU64(&seed) & RandomU64(&seed) & RandomU64(&seed);
+						records[r * 8 + j] = (r % 7 == 0) ? query[j] ^ noise : (r % 2 == 0) ? noise : RandomU64(&seed);
+					};
+					if (r % 97 == 50)
+					{
+						for (int j = 0; j < 8; j++)
+						{
+							records[r * 8 + j] = records[(r - 49) * 8 + j];
+						};
+					};
+				};
+
+				u64 total = popcnt_n(counts, records, nrecs);
+				u64 sum = 0;
+				for (u64 r = 0; r < nrecs; r++)
+				{
+					Assert::AreEqual(counts[r], u16(popcnt_u(&records[r * 8])));
+					sum += counts[r];
+				};
+				Assert::AreEqual(sum, total);
+
+				// expected: every record by score descending, then index ascending
+				for (u64 r = 0; r < nrecs; r++)
+				{
+					expected[r] = (u64(tanimoto_u(query, &records[r * 8])) << 32) | r;
+				};
+				sort(expected, expected + nrecs, [](u64 a, u64 b) { return (a >> 32) != (b >> 32) ? (a >> 32) > (b >> 32) : a < b; });
+
+				for (u64 k = 0; k <= maxk; k += (k < 3) ? 1 : 9)
+				{
+					u64 n = (i % 3 == 0) ? k / 2 : nrecs - u64(i);
+					u64 found = tanimoto_topk_n(results, k, query, records, counts, n);
+					Assert::AreEqual((k < n) ? k : n, found);
+					u64 m = 0;
+					for (u64 e = 0; e < nrecs && m < found; e++)
+					{
+						if ((expected[e] & 0xffffffff) < n)
+						{
+							Assert::AreEqual(expected[e], results[m]);
+							m++;
+						};
+					};
+				};
+			};
+
+			string test_message = "Tanimoto top-k search testing. Ran tests " + to_string(adjruncount) + " times, each over " + to_string(nrecs) + " pseudo random records.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		/// <summary>
+		/// Reference leading bits in common of two 512 bit values, as lcp_u
+		/// </summary>
+		int RefLcp(const u64* a, const u64* b)
+		{
+			int bit = 511;
+			while (bit >= 0 && BitSet(a, bit) == BitSet(b, bit))
+			{
+				bit--;
+			};
+			return 511 - bit;
+		};
+
+		/// <summary>
+		/// Ordering of 512 bit values (word 0 most significant), as compare_u
+		/// </summary>
+		static bool KeyLess(const u64* a, const u64* b)
+		{
+			for (int j = 0; j < 8; j++)
+			{
+				if (a[j] != b[j])
+				{
+					return a[j] < b[j];
+				};
+			};
+			return false;
+		};
+
+		/// <summary>
+		/// Fill keys with n distinct sorted 512 bit values: clusters sharing long prefixes, and random ones.
+		/// </summary>
+		void SortedKeys(u64* keys, u64 n, u64* seed)
+		{
+			u64 made = n + n / 4 + 8;		// extra, some share all 512 bits with the one before
+			vector<u64> work(made * 8);
+			for (u64 r = 0; r < made * 8; r += 8)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					work[r + j] = RandomU64(seed);
+				};
+				if (r > 0 && (r / 8) % 3 != 0)
+				{
+					int shared = int(RandomU64(seed) % 512);	// copy a prefix of the previous value
+					for (int bit = 511; bit > 511 - shared; bit--)
+					{
+						u64 m = 1ull << (bit % 64);
+						work[r + 7 - bit / 64] = (work[r + 7 - bit / 64] & ~m) | (work[r - 8 + 7 - bit / 64] & m);
+					};
+				};
+			};
+			vector<u64> order(made);
+			for (u64 i = 0; i < made; i++)
+			{
+				order[i] = i;
+			};
+			sort(order.begin(), order.end(), [&work](u64 a, u64 b) { return KeyLess(&work[a * 8], &work[b * 8]); });
+			u64 w = 0;
+			for (u64 i = 0; i < made && w < n; i++)
+			{
+				if (w == 0 || KeyLess(&keys[(w - 1) * 8], &work[order[i] * 8]))
+				{
+					for (int j = 0; j < 8; j++)
+					{
+						keys[w * 8 + j] = work[order[i] * 8 + j];
+					};
+					w++;
+				};
+			};
+			Assert::AreEqual(n, w, L"Too few distinct keys generated");
+		};
+
+		TEST_METHOD(ui512bits_18_lcp)
+		{
+			u64 seed = 0;
+			alignas (64) u64 num1[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+			alignas (64) u64 num2[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+			alignas (64) u64 diff[8]{ 0, 0, 0, 0, 0, 0, 0, 0 };
+
+			Assert::AreEqual(s16(512), lcp_u(num1, num2));
+			num2[7] = 1;
+			Assert::AreEqual(s16(511), lcp_u(num1, num2));
+			num2[0] = 0x8000000000000000ull;
+			Assert::AreEqual(s16(0), lcp_u(num1, num2));
+
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					num1[j] = RandomU64(&seed);
+					num2[j] = (j < i % 9) ? num1[j] : RandomU64(&seed);
+				};
+				if (i % 9 < 8)
+				{
+					num2[i % 9] = num1[i % 9] ^ (1ull << (RandomU64(&seed) % 64));
+				};
+				s16 lcp = lcp_u(num1, num2);
+				Assert::AreEqual(s16(RefLcp(num1, num2)), lcp);
+				xor_u(diff, num1, num2);
+				Assert::AreEqual(s16(511 - msb_u(diff)), lcp);
+				Assert::AreEqual(s16(512), lcp_u(num1, num1));
+			};
+
+			string test_message = "Longest common prefix function testing. Ran tests " + to_string(runcount) + " times, each with pseudo random values.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_19_critbit)
+		{
+			u64 seed = 0;
+			const u64 maxkeys = 4000;
+			alignas (64) static u64 keys[maxkeys * 8]{};
+			alignas (64) static u64 nodes[maxkeys * CRITBIT_LINE_QWORDS]{};
+			alignas (64) u64 query[8]{};
+			const u64 sizes[] = { 1, 2, 3, 7, 8, 9, 60, 500, maxkeys };
+
+			for (u64 n : sizes)
+			{
+				SortedKeys(keys, n, &seed);
+				u64 lines = critbit_build_n(nodes, keys, n);
+				Assert::IsTrue(lines >= 1 && lines <= ((n > 1) ? n - 1 : 1));
+
+				// every key found at its index, and is its own lower bound
+				for (u64 i = 0; i < n; i++)
+				{
+					Assert::AreEqual(i, critbit_find_n(nodes, keys, &keys[i * 8]));
+					Assert::AreEqual(i, critbit_lower_n(nodes, keys, &keys[i * 8]));
+					Assert::AreEqual(i, critbit_lcp_n(nodes, &keys[i * 8]));
+				};
+
+				// queries: near keys (a low or high bit changed) and random
+				for (int q = 0; q < 2000; q++)
+				{
+					u64 near = RandomU64(&seed) % n;
+					for (int j = 0; j < 8; j++)
+					{
+						query[j] = (q % 4 == 3) ? RandomU64(&seed) : keys[near * 8 + j];
+					};
+					if (q % 4 != 3)
+					{
+						int bit = int(RandomU64(&seed) % 512);
+						query[7 - bit / 64] ^= 1ull << (bit % 64);
+					};
+
+					u64 lower = 0;
+					int best = -1;
+					bool present = false;
+					for (u64 i = 0; i < n; i++)
+					{
+						if (KeyLess(&keys[i * 8], query))
+						{
+							lower = i + 1;
+						};
+						int l = RefLcp(&keys[i * 8], query);
+						best = (l > best) ? l : best;
+						present = present || l == 512;
+					};
+					Assert::AreEqual(lower, critbit_lower_n(nodes, keys, query));
+					Assert::AreEqual(present ? lower : u64_Max, critbit_find_n(nodes, keys, query));
+					Assert::AreEqual(s16(best), lcp_u(query, &keys[critbit_lcp_n(nodes, query) * 8]));
+
+					// prefix: keys sharing the first plen bits with the query, a run of the sorted keys
+					u16 plen = u16((q % 5 == 0) ? best : RandomU64(&seed) % 520);
+					u64 count = 0;
+					u64 first = u64_Max;
+					for (u64 i = 0; i < n; i++)
+					{
+						if (RefLcp(&keys[i * 8], query) >= ((plen > 512) ? 512 : plen))
+						{
+							first = (count == 0) ? i : first;
+							count++;
+						};
+					};
+					u64 gotfirst = u64_Max;
+					Assert::AreEqual(count, critbit_prefix_n(nodes, keys, query, plen, &gotfirst));
+					Assert::AreEqual(first, gotfirst);
+				};
+			};
+
+			string test_message = "Crit-bit tree testing. Built trees of 1 to " + to_string(maxkeys) + " keys, checked every key, and 2000 queries each.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_19_critbit_reg)
+		{
+			// lcp_u, critbit_build_n, critbit_lcp_n, critbit_find_n, critbit_lower_n, critbit_prefix_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const u64 nkeys = 50;
+			alignas (64) static u64 keys[nkeys * 8]{};
+			alignas (64) static u64 nodes[nkeys * CRITBIT_LINE_QWORDS]{};
+			alignas (64) u64 query[8]{};
+			u64 first = 0;
+			for (int i = 0; i < regvercount / 10; i++)
+			{
+				SortedKeys(keys, nkeys, &seed);
+				for (int j = 0; j < 8; j++)
+				{
+					query[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				s16 lcp = lcp_u(keys, query);
+				u64 result = critbit_build_n(nodes, keys, nkeys);
+				result = critbit_lcp_n(nodes, query);
+				result = critbit_find_n(nodes, keys, query);
+				result = critbit_lower_n(nodes, keys, query);
+				result = critbit_prefix_n(nodes, keys, query, u16(i % 20), &first);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "lcp_u, critbit_build_n, critbit_lcp_n, critbit_find_n, critbit_lower_n, critbit_prefix_n function register validation. Ran "
+				+ to_string(regvercount / 10) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		/// <summary>
+		/// Fill keys with n 512 bit values of a kind: 0 random, 1 small numbers (low three bytes vary), 2 a shared prefix of five words
+		/// then random, 3 drawn from eight random values (many duplicates), 4 first two words from four values each, then random.
+		/// </summary>
+		void RadixKeys(u64* keys, u64 n, int kind, u64* seed)
+		{
+			u64 few[8 * 8]{};
+			for (int j = 0; j < 8 * 8; j++)
+			{
+				few[j] = RandomU64(seed);
+			};
+			for (u64 i = 0; i < n; i++)
+			{
+				u64 pick = RandomU64(seed) % 8;
+				for (int j = 0; j < 8; j++)
+				{
+					switch (kind)
+					{
+					case 1: keys[i * 8 + j] = (j == 7) ? RandomU64(seed) % 0x1000000ull : 0; break;
+					case 2: keys[i * 8 + j] = (j < 5) ? few[j] : RandomU64(seed); break;
+					case 3: keys[i * 8 + j] = few[pick * 8 + j]; break;
+					case 4: keys[i * 8 + j] = (j < 2) ? few[(RandomU64(seed) % 4) * 8 + j] : RandomU64(seed); break;
+					default: keys[i * 8 + j] = RandomU64(seed); break;
+					};
+				};
+			};
+		};
+
+		TEST_METHOD(ui512bits_20_radix)
+		{
+			u64 seed = 0;
+			const u64 maxkeys = 3000;
+			alignas (64) static u64 orig[maxkeys * 8]{};
+			alignas (64) static u64 keys[maxkeys * 8]{};
+			alignas (64) static u64 work[RADIX_WORK_QWORDS]{};
+			alignas (64) static u64 temp[maxkeys * 9]{};
+			static u64 values[maxkeys]{};
+			const u64 sizes[] = { 0, 1, 2, 3, 17, 47, 48, 256, 1000, maxkeys };
+			int runs = 0;
+
+			for (int rep = 0; rep < 4; rep++)
+			{
+				for (int kind = 0; kind < 5; kind++)
+				{
+					for (u64 n : sizes)
+					{
+						RadixKeys(orig, n, kind, &seed);
+						vector<u64> expected(n);
+						for (u64 i = 0; i < n; i++)
+						{
+							expected[i] = i;
+						};
+						stable_sort(expected.begin(), expected.end(), [](u64 a, u64 b) { return KeyLess(&orig[a * 8], &orig[b * 8]); });
+
+						u64 levels = 0;			// words sorted on: those that vary, most significant first, until no two unequal keys are equal so far
+						for (int j = 0; j < 8; j++)
+						{
+							bool varies = false;
+							for (u64 i = 1; i < n; i++)
+							{
+								varies = varies || (orig[i * 8 + j] != orig[j]);
+							};
+							if (varies)
+							{
+								levels++;
+								bool tied = false;
+								for (u64 i = 1; i < n && !tied; i++)
+								{
+									tied = memcmp(&orig[expected[i - 1] * 8], &orig[expected[i] * 8], (j + 1) * 8) == 0
+										&& memcmp(&orig[expected[i - 1] * 8], &orig[expected[i] * 8], 64) != 0;
+								};
+								if (!tied)
+								{
+									break;
+								};
+							};
+						};
+
+						memcpy(keys, orig, n * 64);
+						Assert::AreEqual(levels, radix_sort_n(keys, n, temp, work));
+						for (u64 i = 0; i < n; i++)
+						{
+							for (int j = 0; j < 8; j++)
+							{
+								Assert::AreEqual(orig[expected[i] * 8 + j], keys[i * 8 + j]);
+							};
+						};
+
+						memcpy(keys, orig, n * 64);
+						for (u64 i = 0; i < n; i++)
+						{
+							values[i] = i;
+						};
+						Assert::AreEqual(levels, radix_sort_kv_n(keys, values, n, temp, work));
+						for (u64 i = 0; i < n; i++)
+						{
+							Assert::AreEqual(expected[i], values[i]);	// stable: equal keys keep their order
+							for (int j = 0; j < 8; j++)
+							{
+								Assert::AreEqual(orig[expected[i] * 8 + j], keys[i * 8 + j]);
+							};
+						};
+
+						memcpy(keys, orig, n * 64);
+						Assert::AreEqual(levels, radix_index_n(values, keys, n, temp, work));
+						for (u64 i = 0; i < n; i++)
+						{
+							Assert::AreEqual(expected[i], values[i]);
+						};
+						Assert::AreEqual(0, memcmp(keys, orig, n * 64));
+						runs++;
+					};
+				};
+			};
+
+			string test_message = "Radix sort functions testing. Ran tests " + to_string(runs) + " times, each against a stable comparison sort.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_20_radix_reg)
+		{
+			// radix_sort_n, radix_sort_kv_n, radix_index_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const u64 nkeys = 100;
+			alignas (64) static u64 keys[nkeys * 8]{};
+			alignas (64) static u64 work[RADIX_WORK_QWORDS]{};
+			alignas (64) static u64 temp[nkeys * 9]{};
+			static u64 values[nkeys]{};
+			for (int i = 0; i < regvercount / 10; i++)
+			{
+				RadixKeys(keys, nkeys, i % 5, &seed);
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				u64 result = radix_index_n(values, keys, nkeys, temp, work);
+				result = radix_sort_kv_n(keys, values, nkeys, temp, work);
+				result = radix_sort_n(keys, nkeys, temp, work);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "radix_sort_n, radix_sort_kv_n, radix_index_n function register validation. Ran "
+				+ to_string(regvercount / 10) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		/// <summary>
+		/// Reference for hash_u: lane i is ( w[i] ^ secret[i] ) low half times high half, plus w[i ^ 1]; lanes in pairs XOR fold
+		/// constants, multiplied to 128 bits, halves XORd and summed; then avalanched.
+		/// </summary>
+		static u64 RefHash(const u64* key)
+		{
+			static const u64 secret[8] = { 0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull,
+				0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull };
+			static const u64 fold[8] = { 0xCB00C391BB52283Cull, 0xA32E531B8B65D088ull, 0x4EF90DA297486471ull, 0xD8ACDEA946EF1938ull,
+				0x3F349CE33F76FAA8ull, 0x1D4F0BC7C7BBDCF9ull, 0x3159B4CD4BE0518Aull, 0x647378D9C97E9FC8ull };
+			u64 lane[8]{};
+			for (int i = 0; i < 8; i++)
+			{
+				u64 x = key[i] ^ secret[i];
+				lane[i] = (x & 0xFFFFFFFFull) * (x >> 32) + key[i ^ 1];
+			};
+			u64 h = 0;
+			for (int j = 0; j < 4; j++)
+			{
+				u64 hi = 0;
+				u64 lo = _umul128(lane[2 * j] ^ fold[2 * j], lane[2 * j + 1] ^ fold[2 * j + 1], &hi);
+				h += lo ^ hi;
+			};
+			h ^= h >> 37;
+			h *= 0x165667919E3779F9ull;
+			h ^= h >> 32;
+			return h;
+		};
+
+		TEST_METHOD(ui512bits_21_hash)
+		{
+			u64 seed = 0;
+			alignas (64) u64 key[8]{};
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					key[j] = (i % 3 == 0) ? RandomU64(&seed) & 0xFF : RandomU64(&seed);
+				};
+				Assert::AreEqual(RefHash(key), hash_u(key));
+			};
+			memset(key, 0, sizeof(key));
+			Assert::AreEqual(RefHash(key), hash_u(key));
+
+			// hash set: keys with repeats, capacities forcing probes past the first group, and full sets
+			const u64 maxcap = 1024;
+			const u64 nkeys = 1200;
+			alignas (64) static u8 tags[maxcap]{};
+			alignas (64) static u8 tags2[maxcap]{};
+			alignas (64) static u64 slots[maxcap * 8]{};
+			alignas (64) static u64 slots2[maxcap * 8]{};
+			alignas (64) static u64 keys[nkeys * 8]{};
+			static u64 results[nkeys]{};
+			const u64 caps[] = { 64, 128, 1024 };
+			int runs = 0;
+			for (int rep = 0; rep < 4; rep++)
+			{
+				for (u64 cap : caps)
+				{
+					for (int kind = 0; kind < 5; kind++)
+					{
+						u64 n = (kind == 3) ? nkeys : cap - cap / 8 + rep * cap / 16;		// rep 2, 3: more distinct keys than slots
+						RadixKeys(keys, n, kind, &seed);
+						memset(tags, 0, cap);
+						memset(tags2, 0, cap);
+						set<vector<u64>> seen;
+						u64 added = 0;
+						for (u64 i = 0; i < n; i++)
+						{
+							const u64* k = &keys[i * 8];
+							bool isnew = seen.count(vector<u64>(k, k + 8)) == 0;
+							u64 r = hset_insert_u(tags, slots, cap, k);
+							if (isnew && seen.size() == cap)
+							{
+								Assert::AreEqual(u64_Max, r);		// full
+								Assert::AreEqual(u64_Max, hset_find_u(tags, slots, cap, k));
+							}
+							else
+							{
+								Assert::AreEqual(isnew, (r & HSET_NEW) != 0);
+								u64 slot = r & ~HSET_NEW;
+								Assert::IsTrue(slot < cap);
+								Assert::AreEqual(0, memcmp(&slots[slot * 8], k, 64));
+								Assert::AreEqual(u8(0x80 | (hash_u(k) >> 57)), tags[slot]);
+								Assert::AreEqual(slot, hset_find_u(tags, slots, cap, k));
+								if (isnew)
+								{
+									seen.insert(vector<u64>(k, k + 8));
+									added++;
+								};
+							};
+							results[i] = r;
+						};
+
+						vector<u64> expected(results, results + n);
+						Assert::AreEqual(added, hset_insert_n(tags2, slots2, cap, keys, n, results));
+						for (u64 i = 0; i < n; i++)
+						{
+							Assert::AreEqual(expected[i], results[i]);		// batched: the same slots, in the same order
+						};
+						Assert::AreEqual(0, memcmp(tags, tags2, cap));
+
+						u64 found = 0;
+						for (u64 i = 0; i < n; i++)
+						{
+							expected[i] = (expected[i] == u64_Max) ? u64_Max : expected[i] & ~HSET_NEW;
+							found += (expected[i] != u64_Max);
+						};
+						Assert::AreEqual(found, hset_find_n(tags2, slots2, cap, keys, n, results));
+						for (u64 i = 0; i < n; i++)
+						{
+							Assert::AreEqual(expected[i], results[i]);
+						};
+
+						RadixKeys(keys, 16, 0, &seed);					// not in the set
+						Assert::AreEqual(0ull, hset_find_n(tags2, slots2, cap, keys, 16, results));
+						for (u64 i = 0; i < 16; i++)
+						{
+							Assert::AreEqual(u64_Max, results[i]);
+							Assert::AreEqual(u64_Max, hset_find_u(tags2, slots2, cap, &keys[i * 8]));
+						};
+						runs++;
+					};
+				};
+			};
+
+			string test_message = "hash_u against a reference, hash set functions testing. Ran tests " + to_string(runs)
+				+ " times, each against std::set.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_21_hash_reg)
+		{
+			// hash_u, hset_find_u, hset_insert_u, hset_find_n, hset_insert_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const u64 cap = 256;
+			const u64 nkeys = 100;
+			alignas (64) static u8 tags[cap]{};
+			alignas (64) static u64 slots[cap * 8]{};
+			alignas (64) static u64 keys[nkeys * 8]{};
+			static u64 results[nkeys]{};
+			for (int i = 0; i < regvercount / 10; i++)
+			{
+				RadixKeys(keys, nkeys, i % 5, &seed);
+				memset(tags, 0, cap);
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				u64 result = hash_u(keys);
+				result = hset_insert_u(tags, slots, cap, keys);
+				result = hset_find_u(tags, slots, cap, keys);
+				result = hset_insert_n(tags, slots, cap, keys, nkeys, results);
+				result = hset_find_n(tags, slots, cap, keys, nkeys, results);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "hash_u, hset_find_u, hset_insert_u, hset_find_n, hset_insert_n function register validation. Ran "
+				+ to_string(regvercount / 10) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		/// <summary>
+		/// Reference carry-less product, a bit of b at a time, and reduction modulo x^512 + poly by long division.
+		/// Values as the procs take them: word 0 most significant.
+		/// </summary>
+		static void RefClMul(u64* hi, u64* lo, const u64* a, const u64* b)
+		{
+			u64 r[16]{};		// least significant word first
+			for (int i = 0; i < 512; i++)
+			{
+				if ((b[7 - i / 64] >> (i % 64)) & 1)
+				{
+					for (int w = 0; w < 8; w++)
+					{
+						u64 x = a[7 - w];
+						r[w + i / 64] ^= x << (i % 64);
+						if (i % 64 != 0)
+						{
+							r[w + i / 64 + 1] ^= x >> (64 - i % 64);
+						};
+					};
+				};
+			};
+			for (int w = 0; w < 8; w++)
+			{
+				lo[7 - w] = r[w];
+				hi[7 - w] = r[w + 8];
+			};
+		};
+
+		static void RefClMod(u64* dest, const u64* hi, const u64* lo, const u64* poly)
+		{
+			u64 r[16]{};
+			for (int w = 0; w < 8; w++)
+			{
+				r[w] = lo[7 - w];
+				r[w + 8] = hi[7 - w];
+			};
+			for (int d = 1023; d >= 512; d--)
+			{
+				if ((r[d / 64] >> (d % 64)) & 1)
+				{
+					r[d / 64] ^= 1ull << (d % 64);
+					int s = d - 512;			// XOR poly * x^s
+					for (int w = 0; w < 8; w++)
+					{
+						u64 x = poly[7 - w];
+						r[w + s / 64] ^= x << (s % 64);
+						if (s % 64 != 0)
+						{
+							r[w + s / 64 + 1] ^= x >> (64 - s % 64);
+						};
+					};
+				};
+			};
+			for (int w = 0; w < 8; w++)
+			{
+				dest[7 - w] = r[w];
+			};
+		};
+
+		// bit j of 512 bit row i of a matrix of such rows
+		static int MatBit(const u64* m, int i, int j)
+		{
+			return (m[i * 8 + 7 - (j >> 6)] >> (j & 63)) & 1;
+		};
+
+		// vector times matrix, bit at a time
+		static void RefMatVec(u64* dest, const u64* v, const u64* m)
+		{
+			u64 r[8]{};
+			for (int i = 0; i < 512; i++)
+			{
+				if ((v[7 - (i >> 6)] >> (i & 63)) & 1)
+				{
+					for (int w = 0; w < 8; w++)
+					{
+						r[w] ^= m[i * 8 + w];
+					};
+				};
+			};
+			memcpy(dest, r, 64);
+		};
+
+		// rand_seed_u, rand_u reference: SplitMix64 seeding, xoshiro256** generator i for word i
+		static void RefRandSeed(u64* state, u64 seed)
+		{
+			for (int i = 0; i < RAND_STATE_QWORDS; i++)
+			{
+				u64 z = (seed += 0x9E3779B97F4A7C15ull);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				state[i] = z ^ (z >> 31);
+			};
+		};
+
+		static void RefRand(u64* dest, u64* state)
+		{
+			auto rotl = [](u64 x, int k) { return (x << k) | (x >> (64 - k)); };
+			for (int i = 0; i < 8; i++)
+			{
+				u64* s0 = &state[i];
+				u64* s1 = &state[8 + i];
+				u64* s2 = &state[16 + i];
+				u64* s3 = &state[24 + i];
+				dest[i] = rotl(*s1 * 5, 7) * 9;
+				const u64 t = *s1 << 17;
+				*s2 ^= *s0;
+				*s3 ^= *s1;
+				*s1 ^= *s2;
+				*s0 ^= *s3;
+				*s2 ^= t;
+				*s3 = rotl(*s3, 45);
+			};
+		};
+
+		// ui<N> reference: bits of words (word 0 most significant) numbered as msb_u / lsb_u
+		static bool WBit(const u64* num, int words, int bit)
+		{
+			return ((num[words - 1 - bit / 64] >> (bit % 64)) & 1ull) != 0;
+		};
+
+		static void RefShiftW(u64* dest, const u64* src, int words, int bits, bool left)
+		{
+			vector<u64> r(words, 0);
+			for (int b = 0; b < words * 64; b++)
+			{
+				const int from = left ? b - bits : b + bits;
+				if (from >= 0 && from < words * 64 && WBit(src, words, from))
+					r[words - 1 - b / 64] |= 1ull << (b % 64);
+			};
+			memcpy(dest, r.data(), words * 8);
+		};
+
+		template<int N>
+		void UiNCheck(u64* seed, int reps)
+		{
+			constexpr int W = N / 64;
+			ui<N> a{}, b{}, r{};
+			u64 e[W]{};
+			const int edges[] = { 0, 1, 63, 64, 65, 127, 128, 255, 256, 257, 511, 512, 513, 1023, 1024, 1025, 2047, 2048 };
+			for (int i = 0; i < reps; i++)
+			{
+				for (int j = 0; j < W; j++)
+				{
+					a.w[j] = (i % 3 == 0 && j % 3 != 0) ? 0 : RandomU64(seed);		// some sparse
+					b.w[j] = RandomU64(seed);
+				};
+				if (i % 7 == 0)
+					memset(a.w, 0, sizeof(a.w));
+				const int bits = (i < int(size(edges))) ? edges[i] : int(RandomU64(seed) % (N + 16));
+
+				shr_u(r, a, u16(bits));
+				RefShiftW(e, a.w, W, bits, false);
+				Assert::AreEqual(0, memcmp(e, r.w, sizeof(e)), L"shr_u");
+				shl_u(r, a, u16(bits));
+				RefShiftW(e, a.w, W, bits, true);
+				Assert::AreEqual(0, memcmp(e, r.w, sizeof(e)), L"shl_u");
+				r = a;
+				shr_u(r, r, u16(bits));												// in place
+				RefShiftW(e, a.w, W, bits, false);
+				Assert::AreEqual(0, memcmp(e, r.w, sizeof(e)), L"shr_u in place");
+				r = a;
+				shl_u(r, r, u16(bits));
+				RefShiftW(e, a.w, W, bits, true);
+				Assert::AreEqual(0, memcmp(e, r.w, sizeof(e)), L"shl_u in place");
+
+				and_u(r, a, b);
+				for (int j = 0; j < W; j++) Assert::AreEqual(a.w[j] & b.w[j], r.w[j]);
+				or_u(r, a, b);
+				for (int j = 0; j < W; j++) Assert::AreEqual(a.w[j] | b.w[j], r.w[j]);
+				xor_u(r, a, b);
+				for (int j = 0; j < W; j++) Assert::AreEqual(a.w[j] ^ b.w[j], r.w[j]);
+				not_u(r, a);
+				for (int j = 0; j < W; j++) Assert::AreEqual(~a.w[j], r.w[j]);
+
+				s16 msb = -1, lsb = -1;
+				for (int bit = 0; bit < N; bit++)
+					if (WBit(a.w, W, bit))
+					{
+						if (lsb < 0) lsb = s16(bit);
+						msb = s16(bit);
+					};
+				Assert::AreEqual(msb, msb_u(a));
+				Assert::AreEqual(lsb, lsb_u(a));
+			};
+		};
+
+		TEST_METHOD(ui512bits_22_clmul)
+		{
+			u64 seed = 0;
+			alignas (64) u64 a[8]{};
+			alignas (64) u64 b[8]{};
+			alignas (64) u64 hi[8]{};
+			alignas (64) u64 lo[8]{};
+			alignas (64) u64 ehi[8]{};
+			alignas (64) u64 elo[8]{};
+			alignas (64) u64 poly[8]{};
+			alignas (64) u64 mu[8]{};
+			alignas (64) u64 result[8]{};
+			alignas (64) u64 expected[8]{};
+
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					a[j] = RandomU64(&seed);
+					b[j] = (i % 4 == 1) ? (j == 7 ? 1ull << (i % 64) : 0) : RandomU64(&seed);	// some b a single power of x
+					a[j] = (i % 4 == 2) ? ~0ull : a[j];
+				};
+				RefClMul(ehi, elo, a, b);
+				clmul_u(hi, lo, a, b);
+				Assert::AreEqual(0, memcmp(ehi, hi, 64));
+				Assert::AreEqual(0, memcmp(elo, lo, 64));
+				memcpy(hi, a, 64);
+				memcpy(lo, b, 64);
+				clmul_u(hi, lo, hi, lo);						// destinations the operands
+				Assert::AreEqual(0, memcmp(ehi, hi, 64));
+				Assert::AreEqual(0, memcmp(elo, lo, 64));
+			};
+
+			for (int i = 0; i < runcount / 10; i++)
+			{
+				memset(poly, 0, 64);
+				switch (i % 3)
+				{
+				case 0: poly[7] = 0x425; break;				// sparse, x^10 + x^5 + x^2 + 1
+				case 1: for (int j = 0; j < 8; j++) poly[j] = RandomU64(&seed); break;
+				default: poly[0] = RandomU64(&seed) | (1ull << 63); poly[7] = 1; break;	// x^511 term
+				};
+				clmod_mu_u(mu, poly);
+				for (int r = 0; r < 10; r++)
+				{
+					for (int j = 0; j < 8; j++)
+					{
+						a[j] = RandomU64(&seed);
+						b[j] = RandomU64(&seed);
+					};
+					clmul_u(hi, lo, a, b);
+					RefClMod(expected, hi, lo, poly);
+					clmod_u(result, hi, lo, poly, mu);
+					Assert::AreEqual(0, memcmp(expected, result, 64));
+					clmod_u(lo, hi, lo, poly, mu);			// destination the low half
+					Assert::AreEqual(0, memcmp(expected, lo, 64));
+				};
+				memset(hi, 0, 64);
+				hi[7] = 1;									// x^512 is poly
+				memset(lo, 0, 64);
+				clmod_u(result, hi, lo, poly, mu);
+				Assert::AreEqual(0, memcmp(poly, result, 64));
+			};
+
+			string test_message = "clmul_u, clmod_mu_u, clmod_u functions testing. Ran tests " + to_string(runcount) + " times, each against bitwise references.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_22_clmul_reg)
+		{
+			// clmul_u, clmod_mu_u, clmod_u function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			alignas (64) u64 a[8]{};
+			alignas (64) u64 b[8]{};
+			alignas (64) u64 hi[8]{};
+			alignas (64) u64 lo[8]{};
+			alignas (64) u64 mu[8]{};
+			for (int i = 0; i < regvercount / 10; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					a[j] = RandomU64(&seed);
+					b[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				clmul_u(hi, lo, a, b);
+				clmod_mu_u(mu, b);
+				clmod_u(a, hi, lo, b, mu);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "clmul_u, clmod_mu_u, clmod_u function register validation. Ran "
+				+ to_string(regvercount / 10) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_23_bitmat)
+		{
+			u64 seed = 0;
+			const int n = 100;
+			alignas (64) static u64 m[512 * 8]{};
+			alignas (64) static u64 t[512 * 8]{};
+			alignas (64) static u64 a[n * 8]{};
+			alignas (64) static u64 c[n * 8]{};
+			alignas (64) static u64 work[BITMAT_WORK_QWORDS]{};
+			alignas (64) u64 v[8]{};
+			alignas (64) u64 result[8]{};
+			alignas (64) u64 expected[8]{};
+
+			for (int r = 0; r < 6; r++)
+			{
+				for (int i = 0; i < 512 * 8; i++)
+				{
+					m[i] = RandomU64(&seed);
+					m[i] = (r == 1) ? m[i] & RandomU64(&seed) & RandomU64(&seed) : m[i];	// sparse
+				};
+				if (r == 2)
+				{
+					memset(m, 0, sizeof(m));
+					for (int i = 0; i < 512; i++)
+					{
+						m[i * 8 + 7 - (i >> 6)] = 1ull << (i & 63);	// identity
+					};
+				};
+
+				bitmat_transpose_n(t, m);
+				for (int i = 0; i < 512; i++)
+				{
+					for (int j = 0; j < 512; j++)
+					{
+						Assert::AreEqual(MatBit(m, i, j), MatBit(t, j, i));
+					};
+				};
+				bitmat_transpose_n(t, t);						// in place, back
+				Assert::AreEqual(0, memcmp(m, t, sizeof(m)));
+
+				for (int i = 0; i < runcount / 10; i++)
+				{
+					for (int j = 0; j < 8; j++)
+					{
+						v[j] = RandomU64(&seed);
+						v[j] = (i % 5 == 1) ? (j == i % 8 ? 1ull << (i % 64) : 0) : v[j];	// a single row
+					};
+					RefMatVec(expected, v, m);
+					bitmat_vec_u(result, v, m);
+					Assert::AreEqual(0, memcmp(expected, result, 64));
+					bitmat_vec_u(v, v, m);						// destination the vector
+					Assert::AreEqual(0, memcmp(expected, v, 64));
+				};
+
+				for (int i = 0; i < n * 8; i++)
+				{
+					a[i] = RandomU64(&seed);
+					a[i] = (r == 3 && (i & 8)) ? 0 : a[i];		// zero words, some rows zero
+				};
+				memset(c, 0xFF, sizeof(c));
+				bitmat_mul_n(c, a, n, m, work);
+				for (int i = 0; i < n; i++)
+				{
+					RefMatVec(expected, &a[i * 8], m);
+					Assert::AreEqual(0, memcmp(expected, &c[i * 8], 64));
+				};
+			};
+
+			string test_message = "bitmat_transpose_n, bitmat_vec_u, bitmat_mul_n functions testing. Ran tests " + to_string(6 * runcount / 10)
+				+ " times, each against bitwise references.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_23_bitmat_reg)
+		{
+			// bitmat_transpose_n, bitmat_vec_u, bitmat_mul_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const int n = 16;
+			alignas (64) static u64 m[512 * 8]{};
+			alignas (64) static u64 a[n * 8]{};
+			alignas (64) static u64 c[n * 8]{};
+			alignas (64) static u64 work[BITMAT_WORK_QWORDS]{};
+			for (int i = 0; i < 512 * 8; i++)
+			{
+				m[i] = RandomU64(&seed);
+			};
+			for (int i = 0; i < regvercount / 1000; i++)
+			{
+				for (int j = 0; j < n * 8; j++)
+				{
+					a[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				bitmat_transpose_n(m, m);
+				bitmat_vec_u(c, a, m);
+				bitmat_mul_n(c, a, n, m, work);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "bitmat_transpose_n, bitmat_vec_u, bitmat_mul_n function register validation. Ran "
+				+ to_string(regvercount / 1000) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_24_pack)
+		{
+			u64 seed = 0;
+			const int maxn = 2000;
+			alignas (64) static u64 values[maxn]{};
+			alignas (64) static u64 out[maxn]{};
+			alignas (64) static u64 blocks[maxn * 8]{};
+			alignas (64) static u64 expected[maxn * 8]{};
+
+			for (int i = 0; i < runcount / 5; i++)
+			{
+				const u64 k = 1 + i % 64;
+				const u64 per = PACK_PER_BLOCK(k);
+				const u64 mask = (k == 64) ? ~0ull : (1ull << k) - 1;
+				const u64 n = (i % 7 == 0) ? i % 10 : RandomU64(&seed) % maxn;
+				for (u64 j = 0; j < n; j++)
+				{
+					values[j] = RandomU64(&seed);
+					values[j] = (i % 3 == 1) ? values[j] & mask : values[j];
+				};
+
+				const u64 nblocks = (n + per - 1) / per;
+				memset(expected, 0, nblocks * 64);
+				for (u64 j = 0; j < n; j++)						// bitwise reference
+				{
+					for (u64 b = 0; b < k; b++)
+					{
+						const u64 bit = (j % per) * k + b;
+						expected[(j / per) * 8 + 7 - bit / 64] |= ((values[j] >> b) & 1) << (bit % 64);
+					};
+				};
+				memset(blocks, 0xAA, nblocks * 64);
+				Assert::AreEqual(nblocks, pack_u(blocks, values, n, k));
+				Assert::AreEqual(0, memcmp(expected, blocks, nblocks * 64));
+
+				memset(out, 0xAA, sizeof(out));
+				Assert::AreEqual(n, unpack_u(out, blocks, n, k));
+				for (u64 j = 0; j < n; j++)
+				{
+					Assert::AreEqual(values[j] & mask, out[j]);
+				};
+				Assert::AreEqual(0xAAAAAAAAAAAAAAAAull, out[n]);
+
+				u64 lo = RandomU64(&seed) & mask;
+				u64 hi = RandomU64(&seed) & mask;								// lo > hi too: an empty range
+				if (k < 4)
+				{
+					lo = hi = 1;
+				};
+				u64 count = unpack_filter_u(out, blocks, n, k, lo, hi);
+				u64 e = 0;
+				for (u64 j = 0; j < n; j++)
+				{
+					const u64 v = values[j] & mask;
+					if (v >= lo && v <= hi)
+					{
+						Assert::IsTrue(e < count);
+						Assert::AreEqual(j, out[e++]);
+					};
+				};
+				Assert::AreEqual(e, count);
+				if (lo > hi)
+				{
+					Assert::AreEqual(0ull, count);
+				};
+			};
+			for (u64 j = 0; j < 26; j++)
+			{
+				values[j] = j & 15;
+			};
+			Assert::AreEqual(1ull, pack_u(blocks, values, 26, 4));						// one block of 128 fields
+			Assert::AreEqual(0ull, unpack_filter_u(out, blocks, 26, 4, 15, 0));		// inverted range: none, not all outside it
+			Assert::AreEqual(2ull, unpack_filter_u(out, blocks, 26, 4, 0, 0));
+			Assert::AreEqual(0ull, pack_u(blocks, values, 10, 0));
+			Assert::AreEqual(0ull, unpack_u(out, blocks, 10, 65));
+			Assert::AreEqual(0ull, unpack_filter_u(out, blocks, 10, 0, 0, ~0ull));
+
+			string test_message = "pack_u, unpack_u, unpack_filter_u functions testing. Ran tests " + to_string(runcount / 5)
+				+ " times, each against bitwise references.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_24_pack_reg)
+		{
+			// pack_u, unpack_u, unpack_filter_u function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const int n = 200;
+			alignas (64) static u64 values[n]{};
+			alignas (64) static u64 blocks[n * 8]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				const u64 k = 1 + i % 64;
+				for (int j = 0; j < n; j++)
+				{
+					values[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				pack_u(blocks, values, n, k);
+				unpack_u(values, blocks, n, k);
+				unpack_filter_u(values, blocks, n, k, 0, 1000);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "pack_u, unpack_u, unpack_filter_u function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_25_shift_insert)
+		{
+			u64 seed = 0;
+			const int n = 300;
+			alignas (64) u64 num[8]{};
+			alignas (64) u64 result[8]{};
+			alignas (64) u64 expected[8]{};
+			alignas (64) u64 window[8]{};
+			alignas (64) u64 mask[8]{};
+			alignas (64) u64 pattern[8]{};
+			alignas (64) static u64 symbols[n]{};
+			alignas (64) static u64 windows[n * 8]{};
+			alignas (64) static u64 ewindows[n * 8]{};
+			alignas (64) static u64 indices[n]{};
+
+			for (int i = 0; i < runcount; i++)
+			{
+				const u16 bits = (i % 10 == 0) ? 64 + i % 3 : i % 64;	// some over 64, taken as 64
+				const u16 b = (bits > 64) ? 64 : bits;
+				const u64 newbits = RandomU64(&seed);
+				for (int j = 0; j < 8; j++)
+				{
+					num[j] = RandomU64(&seed);
+				};
+
+				shl_u(expected, num, b);
+				expected[7] |= (b == 0) ? 0 : (b == 64) ? newbits : newbits & ((1ull << b) - 1);
+				shl_insert_u(result, num, bits, newbits);
+				Assert::AreEqual(0, memcmp(expected, result, 64));
+				memcpy(result, num, 64);
+				shl_insert_u(result, result, bits, newbits);	// in place
+				Assert::AreEqual(0, memcmp(expected, result, 64));
+
+				shr_u(expected, num, b);
+				expected[0] |= (b == 0) ? 0 : newbits << (64 - b);
+				shr_insert_u(result, num, bits, newbits);
+				Assert::AreEqual(0, memcmp(expected, result, 64));
+				memcpy(result, num, 64);
+				shr_insert_u(result, result, bits, newbits);
+				Assert::AreEqual(0, memcmp(expected, result, 64));
+			};
+
+			for (int i = 0; i < runcount / 50; i++)
+			{
+				const u64 bits = 1 + i % 64;
+				for (int j = 0; j < n; j++)
+				{
+					symbols[j] = RandomU64(&seed);					// only the low bits inserted
+				};
+				for (int j = 0; j < 8; j++)
+				{
+					window[j] = RandomU64(&seed);
+					num[j] = window[j];
+					mask[j] = (j == 7) ? 0xF : 0;				// last two 2 bit symbols, or the low 4 bits of the last
+					pattern[j] = (j == 7) ? 0x6 : 0;
+				};
+				for (int j = 0; j < n; j++)
+				{
+					shl_insert_u(&ewindows[j * 8], (j == 0) ? num : &ewindows[(j - 1) * 8], (u16)bits, symbols[j]);
+				};
+				Assert::AreEqual(u64(n), shl_stream_n(windows, window, symbols, n, bits));
+				Assert::AreEqual(0, memcmp(ewindows, windows, sizeof(windows)));
+				Assert::AreEqual(0, memcmp(&ewindows[(n - 1) * 8], window, 64));
+
+				memcpy(window, num, 64);
+				u64 count = shl_stream_match_n(indices, window, symbols, n, bits, mask, pattern);
+				u64 e = 0;
+				for (int j = 0; j < n; j++)
+				{
+					if ((ewindows[j * 8 + 7] & 0xF) == 0x6)
+					{
+						Assert::IsTrue(e < count);
+						Assert::AreEqual(u64(j), indices[e++]);
+					};
+				};
+				Assert::AreEqual(e, count);
+				Assert::AreEqual(0, memcmp(&ewindows[(n - 1) * 8], window, 64));
+			};
+			Assert::AreEqual(0ull, shl_stream_n(windows, window, symbols, n, 0));
+			Assert::AreEqual(0ull, shl_stream_match_n(indices, window, symbols, n, 65, mask, pattern));
+
+			string test_message = "shl_insert_u, shr_insert_u, shl_stream_n, shl_stream_match_n functions testing. Ran tests "
+				+ to_string(runcount) + " times, each against shl_u, shr_u with the bits inserted.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_25_shift_insert_reg)
+		{
+			// shl_insert_u, shr_insert_u, shl_stream_n, shl_stream_match_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			const int n = 16;
+			alignas (64) u64 num[8]{};
+			alignas (64) u64 mask[8]{};
+			alignas (64) u64 pattern[8]{};
+			alignas (64) static u64 symbols[n]{};
+			alignas (64) static u64 windows[n * 8]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				const u64 bits = 1 + i % 64;
+				for (int j = 0; j < n; j++)
+				{
+					symbols[j] = RandomU64(&seed);
+				};
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				shl_insert_u(num, num, (u16)bits, symbols[0]);
+				shr_insert_u(num, num, (u16)bits, symbols[1]);
+				shl_stream_n(windows, num, symbols, n, bits);
+				shl_stream_match_n(windows, num, symbols, n, bits, mask, pattern);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "shl_insert_u, shr_insert_u, shl_stream_n, shl_stream_match_n function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_26_rand)
+		{
+			const int n = 200;
+			alignas (64) u64 state[RAND_STATE_QWORDS]{};
+			alignas (64) u64 estate[RAND_STATE_QWORDS]{};
+			alignas (64) u64 result[8]{};
+			alignas (64) u64 expected[8]{};
+			alignas (64) static u64 values[n * 8]{};
+
+			for (int i = 0; i < runcount / 100; i++)
+			{
+				const u64 seed = (i % 2 == 0) ? i : ~0ull - i;
+				rand_seed_u(state, seed);
+				RefRandSeed(estate, seed);
+				Assert::AreEqual(0, memcmp(estate, state, sizeof(state)));
+
+				for (int r = 0; r < 100; r++)
+				{
+					RefRand(expected, estate);
+					rand_u(result, state);
+					Assert::AreEqual(0, memcmp(expected, result, 64));
+				};
+				Assert::AreEqual(0, memcmp(estate, state, sizeof(state)));
+
+				const int m = (i % 5 == 0) ? 0 : 1 + i % n;		// as many calls of rand_u
+				rand_fill_n(values, state, m);
+				for (int r = 0; r < m; r++)
+				{
+					RefRand(expected, estate);
+					Assert::AreEqual(0, memcmp(expected, &values[r * 8], 64));
+				};
+				Assert::AreEqual(0, memcmp(estate, state, sizeof(state)));
+			};
+
+			alignas (64) static u64 big[RAND_STREAM * 8]{};		// written past the cache
+			rand_seed_u(state, 7);
+			RefRandSeed(estate, 7);
+			rand_fill_n(big, state, RAND_STREAM);
+			for (int r = 0; r < RAND_STREAM; r++)
+			{
+				RefRand(expected, estate);
+				Assert::AreEqual(0, memcmp(expected, &big[r * 8], 64));
+			};
+
+			string test_message = "rand_seed_u, rand_u, rand_fill_n functions testing. Ran tests " + to_string(runcount / 100)
+				+ " times, each against a reference xoshiro256**.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_26_rand_reg)
+		{
+			// rand_seed_u, rand_u, rand_fill_n function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			const int n = 16;
+			alignas (64) u64 state[RAND_STATE_QWORDS]{};
+			alignas (64) u64 result[8]{};
+			alignas (64) static u64 values[n * 8]{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				rand_seed_u(state, i);
+				rand_u(result, state);
+				rand_fill_n(values, state, 1 + i % n);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "rand_seed_u, rand_u, rand_fill_n function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_27_uiN)
+		{
+			u64 seed = 0;
+			UiNCheck<256>(&seed, runcount / 5);
+			UiNCheck<512>(&seed, runcount / 10);
+			UiNCheck<1024>(&seed, runcount / 10);
+			UiNCheck<2048>(&seed, runcount / 25);
+
+			alignas (32) ui<256> s{};											// a single bit through each position
+			alignas (32) ui<256> r{};
+			s.w[3] = 1;
+			for (int bit = 0; bit < 256; bit++)
+			{
+				shl_u(r, s, u16(bit));
+				Assert::AreEqual(s16(bit), msb_u(r));
+				Assert::AreEqual(s16(bit), lsb_u(r));
+				shr_u(r, r, u16(bit));
+				Assert::AreEqual(0, memcmp(s.w, r.w, 32));
+			};
+
+			alignas (64) ui<512> s512{};										// counts of N or more zero, above 32767 too
+			alignas (64) ui<512> r512{};
+			for (int j = 0; j < 8; j++) s512.w[j] = ~0ull;
+			shr_u(r512, s512, u16(40000));
+			Assert::AreEqual(s16(1), is_zero_u(r512.w));
+			shl_u(r512, s512, u16(40000));
+			Assert::AreEqual(s16(1), is_zero_u(r512.w));
+
+			string test_message = "ui<N> shr_u, shl_u, and_u, or_u, xor_u, not_u, msb_u, lsb_u functions testing. Ran tests "
+				+ to_string(runcount / 5 + runcount / 10 + runcount / 10 + runcount / 25)
+				+ " times, N 256, 512, 1024, 2048, each against a bitwise reference.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_27_uiN_reg)
+		{
+			// shr256_u, shl256_u, and256_u, or256_u, xor256_u, not256_u, msb256_u, lsb256_u function register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			regs r_before{};
+			regs r_after{};
+			u64 seed = 0;
+			ui<256> a{}, b{}, r{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				for (int j = 0; j < 4; j++) a.w[j] = RandomU64(&seed), b.w[j] = RandomU64(&seed);
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				shr_u(r, a, u16(i % 260));
+				shl_u(r, a, u16(i % 260));
+				and_u(r, a, b);
+				or_u(r, a, b);
+				xor_u(r, a, b);
+				not_u(r, a);
+				msb_u(r);
+				lsb_u(r);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+
+			string test_message = "shr256_u, shl256_u, and256_u, or256_u, xor256_u, not256_u, msb256_u, lsb256_u function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_28_arena)
+		{
+			static_assert(!is_copy_constructible_v<ui512_vector> && is_nothrow_move_constructible_v<ui512_vector>);
+			static_assert(!is_copy_constructible_v<ui512_arena>);
+			u64 seed = 0;
+			alignas (64) u64 expected[8]{};
+
+			ui512_arena arena(64 * 1024);
+			set<u64*> seen;
+			u64* first = nullptr;
+			for (int i = 0; i < runcount; i++)
+			{
+				const size_t n = (i % 100 == 0) ? 2000 : 1 + i % 7;				// some larger than a chunk
+				u64* p = arena.alloc(n);
+				if (i == 0) first = p;
+				Assert::AreEqual(u64(0), u64(p) % 64, L"alloc not 64 byte aligned");
+				for (size_t k = 0; k < n; k++)
+				{
+					u64* slot = p + k * 8;
+					Assert::IsTrue(seen.insert(slot).second, L"slot handed out twice");
+					for (int j = 0; j < 8; j++)
+						slot[j] = u64(slot) + j;									// each slot its own, written
+				};
+			};
+			for (u64* slot : seen)
+				for (int j = 0; j < 8; j++)
+					Assert::AreEqual(u64(slot) + j, slot[j], L"slot overwritten");
+			const size_t reserved = arena.reserved();
+			arena.reset();
+			Assert::AreEqual(size_t(0), arena.used());
+			Assert::IsTrue(arena.alloc(1) == first, L"reset does not reuse the chunks");
+			Assert::AreEqual(reserved, arena.reserved());
+			u64* z = arena.alloc_zero(3);
+			for (int j = 0; j < 24; j++)
+				Assert::AreEqual(u64(0), z[j]);
+			const bool large = arena.large_pages();
+			arena.release();
+			Assert::AreEqual(size_t(0), arena.reserved());
+
+			// vector: values keep alignment through growth, and moves leave the source empty
+			ui512_vector v(arena);
+			vector<u64> ref;
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					expected[j] = RandomU64(&seed);
+					ref.push_back(expected[j]);
+				};
+				u64* slot = (i % 2 == 0) ? v.push_back(expected) : v.emplace_back();
+				if (i % 2 != 0)
+					or_u(slot, expected, expected);									// filled in place
+				Assert::AreEqual(u64(0), u64(slot) % 64);
+			};
+			Assert::AreEqual(size_t(runcount), v.size());
+			Assert::AreEqual(0, memcmp(ref.data(), v.data(), ref.size() * 8));
+			ui512_vector w(std::move(v));
+			Assert::IsTrue(v.empty() && v.data() == nullptr);
+			Assert::AreEqual(size_t(runcount), w.size());
+			Assert::AreEqual(0, memcmp(ref.data(), w[0], ref.size() * 8));
+			ui512_vector zeros(100, arena);
+			for (int j = 0; j < 800; j++)
+				Assert::AreEqual(u64(0), zeros.data()[j]);
+			zeros = std::move(w);
+			Assert::AreEqual(size_t(runcount), zeros.size());
+
+			// thread local arenas: each thread its own, used on the thread (released as it ends); a vector to outlive its thread
+			// is made on an arena that does
+			ui512_arena* a0 = &ui512_arena::local();
+			ui512_arena* a1 = nullptr;
+			bool aligned = false;
+			bool shifted = false;
+			ui512_arena shared(64 * 1024);
+			ui512_vector kept(shared);
+			alignas (64) u64 want[8]{};
+			shl_u(want, expected, 3);
+			thread t([&]
+				{
+					a1 = &ui512_arena::local();
+					ui512_vector tv(ui512_arena::local());
+					u64* p1 = tv.emplace_back();
+					shl_u(p1, expected, 3);
+					aligned = u64(p1) % 64 == 0;
+					shifted = memcmp(p1, want, 64) == 0;
+					shl_u(kept.emplace_back(), expected, 3);
+				});
+			t.join();
+			Assert::IsTrue(a0 != a1, L"threads share an arena");
+			Assert::IsTrue(aligned && shifted, L"thread local arena");
+			Assert::AreEqual(size_t(1), kept.size());
+			Assert::AreEqual(0, memcmp(kept[0], want, 64), L"vector on a shared arena, after its thread");
+			kept.push_back(want);										// grown on this thread, now the only one using it
+			Assert::AreEqual(0, memcmp(kept[1], kept[0], 64));
+
+			string test_message = "ui512_arena, ui512_vector testing. Ran tests " + to_string(runcount)
+				+ " times, alignment, distinct slots, reset, growth, moves, thread local arenas. Large pages: "
+				+ (large ? "yes" : "no (4K pages)") + ".\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_29_file)
+		{
+			u64 seed = 0;
+			const u64 n = ScanWindow * 2 + 123;									// more than one window
+			const string path = (filesystem::temp_directory_path() / "ui512bits_29_a.u512").string();
+			const string path_b = (filesystem::temp_directory_path() / "ui512bits_29_b.u512").string();
+			const string path_out = (filesystem::temp_directory_path() / "ui512bits_29_out.u512").string();
+			alignas (64) u64 mask[8]{};
+			alignas (64) u64 pattern[8]{};
+			alignas (64) u64 combined[8]{};
+			static u64 indices[n]{};
+
+			{
+				ui512_file a, b;
+				Assert::IsTrue(a.create(path.c_str(), n + 10));
+				Assert::IsTrue(b.create(path_b.c_str(), n));
+				for (u64 i = 0; i < n * 8; i++)
+				{
+					a.data()[i] = RandomU64(&seed);
+					b.data()[i] = RandomU64(&seed);
+				};
+				a.shrink(n);
+			};
+			for (int j = 0; j < 8; j++)
+				mask[j] = (j == 2) ? 0xF000000000000000ull : (j == 5) ? 0x0F00000000000000ull : 0;	// about one in 256 match
+			pattern[2] = 0x3000000000000000ull;
+			pattern[5] = 0x0100000000000000ull;
+
+			ui512_file a, b;
+			Assert::IsTrue(a.open(path.c_str()));
+			Assert::IsTrue(b.open(path_b.c_str()));
+			Assert::AreEqual(n, a.size());
+			Assert::AreEqual(u64(sizeof(ui512_file_header) + n * 64), u64(filesystem::file_size(path)));
+			seed = 0;
+			u64 bits = 0;
+			vector<u64> expected;
+			for (u64 i = 0; i < n; i++)
+			{
+				Assert::AreEqual(u64(0), u64(a[i]) % 64, L"record not 64 byte aligned");
+				for (int j = 0; j < 8; j++)
+				{
+					Assert::AreEqual(RandomU64(&seed), a[i][j]);
+					RandomU64(&seed);
+				};
+				bits += u64(popcnt_u(a[i]));
+				if (MaskedEqual(a[i], mask, pattern))
+					expected.push_back(i);
+			};
+
+			Assert::IsTrue(expected.size() > 100);
+			Assert::AreEqual(u64(expected.size()), ui512_scan_match(a, mask, pattern, indices));
+			Assert::AreEqual(0, memcmp(expected.data(), indices, expected.size() * 8));
+			Assert::AreEqual(u64(expected.size()), ui512_scan_match(a, mask, pattern, nullptr, path_out.c_str()));
+			{
+				ui512_file out;
+				Assert::IsTrue(out.open(path_out.c_str()));
+				Assert::AreEqual(u64(expected.size()), out.size());
+				for (u64 k = 0; k < out.size(); k++)
+					Assert::AreEqual(0, memcmp(a[expected[k]], out[k], 64));
+			};
+
+			Assert::AreEqual(bits, ui512_scan_popcnt(a));
+
+			Assert::AreEqual(n, ui512_scan_combine(a, b, xor_u, path_out.c_str()));
+			{
+				ui512_file out;
+				Assert::IsTrue(out.open(path_out.c_str()));
+				Assert::AreEqual(n, out.size());
+				for (u64 i = 0; i < n; i += 97)
+				{
+					for (int j = 0; j < 8; j++)
+						combined[j] = a[i][j] ^ b[i][j];
+					Assert::AreEqual(0, memcmp(combined, out[i], 64));
+				};
+			};
+
+			ui512_file bad;
+			Assert::IsFalse(bad.open((filesystem::temp_directory_path() / "ui512bits_29_none.u512").string().c_str()));
+			{
+				ui512_file out;
+				Assert::IsTrue(out.create(path_out.c_str(), 1));
+				memset(out.data() - 8, 0, 64);										// header overwritten: not a record file
+			};
+			Assert::IsFalse(bad.open(path_out.c_str()));
+			a.close();
+			b.close();
+			filesystem::remove(path);
+			filesystem::remove(path_b);
+			filesystem::remove(path_out);
+
+			string test_message = "ui512_file, ui512_scan_match, ui512_scan_popcnt, ui512_scan_combine testing. Ran tests on "
+				+ to_string(n) + " records, against the records read back and a reference.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_30_options)
+		{
+			const u32 options = options_u();
+			const string isa(1, OPTIONS_ISA(options));
+			Assert::IsTrue(isa == "Z" || isa == "Y" || isa == "X" || isa == "Q", L"options_u: no ISA path");
+			Assert::AreEqual(u32(0), options & ~(0xFFu | OPTIONS_BMI2 | OPTIONS_CHECKALIGN | OPTIONS_INSTRUMENT | OPTIONS_SYSV), L"options_u: unknown flags");
+
+			regs r_before{};
+			regs r_after{};
+			r_before.Clear();
+			reg_verify((u64*)&r_before);
+			volatile u32 again = options_u();			// in memory: in a non-volatile register, it would change one compared
+			r_after.Clear();
+			reg_verify((u64*)&r_after);
+			Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			Assert::AreEqual(options, u32(again));
+
+			string test_message = "options_u: assembled with path " + isa + ((options & OPTIONS_BMI2) ? ", BMI2" : "")
+				+ ((options & OPTIONS_CHECKALIGN) ? ", CheckAlign" : "") + ((options & OPTIONS_INSTRUMENT) ? ", Instrument" : "")
+				+ ((options & OPTIONS_SYSV) ? ", System V" : "") + ".\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_31_instrument)
+		{
+			vector<ui512_proc_stats> stats(256);
+			const size_t procs = ui512_instrument_snapshot(stats.data(), stats.size());
+			if (!ui512_instrumented())
+			{
+				Assert::AreEqual(size_t(0), procs, L"instrument: procs counted without __Instrument");
+				Logger::WriteMessage(L"instrument: not assembled with __Instrument, nothing counted.\n");
+				return;
+			};
+			Assert::IsTrue(procs > 60 && procs <= stats.size(), L"instrument: table of procs");
+			ui512_proc_stats s{};
+			Assert::IsTrue(ui512_instrument_snapshot("and_u", &s), L"instrument: and_u not in the table");
+			Assert::IsFalse(ui512_instrument_snapshot("no_such_u", &s));
+
+			u64 seed = 0;
+			alignas (64) u64 a[8]{};
+			alignas (64) u64 b[8]{};
+			alignas (64) u64 c[8]{};
+			alignas (64) u64 zero[8]{};
+			ui512_instrument_reset();
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					a[j] = RandomU64(&seed);
+					b[j] = RandomU64(&seed);
+				};
+				and_u(c, a, b);
+				for (int j = 0; j < 8; j++)
+					Assert::AreEqual(a[j] & b[j], c[j]);			// the wrapper keeps the proc's work
+				Assert::AreEqual(s16(-1), msb_u(zero));				// and its return value
+			};
+			shr_u(c, a, 1);											// from another thread: its own slot
+			std::thread other([&a]() { alignas (64) u64 d[8]; for (int i = 0; i < 100; i++) shr_u(d, a, 1); });
+			other.join();
+
+			Assert::IsTrue(ui512_instrument_snapshot("and_u", &s));
+			Assert::AreEqual(u64(runcount), s.calls, L"instrument: and_u calls");
+			u64 bucketed = 0;
+			for (int b = 0; b < InstrumentBuckets; b++)
+				bucketed += s.buckets[b];
+			Assert::AreEqual(s.calls, bucketed, L"instrument: each call in one bucket");
+			Assert::IsTrue(s.cycles >= s.calls, L"instrument: cycles");
+			Assert::IsTrue(s.percentile(0.5) <= s.percentile(0.99) && s.percentile(1.0) != 0);
+			Assert::IsTrue(ui512_instrument_snapshot("msb_u", &s));
+			Assert::AreEqual(u64(runcount), s.calls, L"instrument: msb_u calls");
+			Assert::IsTrue(ui512_instrument_snapshot("shr_u", &s));
+			Assert::AreEqual(u64(101), s.calls, L"instrument: shr_u calls, two threads");
+
+			// threads calling at once: each its own slot (the counts plain adds), none lost
+			ui512_instrument_reset();
+			const int nthreads = 8;
+			const int percall = 20000;
+			vector<std::thread> workers;
+			for (int t = 0; t < nthreads; t++)
+				workers.emplace_back([&a]() { alignas (64) u64 d[8]; for (int i = 0; i < percall; i++) shl_u(d, a, 3); });
+			for (std::thread& w : workers)
+				w.join();
+			Assert::IsTrue(ui512_instrument_snapshot("shl_u", &s));
+			Assert::AreEqual(u64(nthreads) * percall, s.calls, L"instrument: shl_u calls, threads at once");
+			const instrument_entry_u* shl = instrument_table_u;
+			while (shl->name != nullptr && strcmp(shl->name, "shl_u") != 0)
+				shl++;
+			int used = 0;
+			for (int t = 0; t < InstrumentSlots; t++)
+				if (shl->slots[t].calls != 0)
+				{
+					used++;
+					Assert::AreEqual(u64(percall), shl->slots[t].calls, L"instrument: a slot shared by threads");
+				};
+			Assert::AreEqual(nthreads, used, L"instrument: a slot per thread");
+			Assert::IsTrue(ui512_instrument_snapshot("or_u", &s));
+			Assert::AreEqual(u64(0), s.calls, L"instrument: or_u not called");
+			ui512_instrument_reset();
+			Assert::IsTrue(ui512_instrument_snapshot("and_u", &s));
+			Assert::AreEqual(u64(0), s.calls, L"instrument: reset");
+
+			regs r_before{};
+			regs r_after{};
+			r_before.Clear();
+			reg_verify((u64*)&r_before);
+			and_u(c, a, b);
+			r_after.Clear();
+			reg_verify((u64*)&r_after);
+			Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+
+			const ui512_proc_stats& first = stats[0];
+			string test_message = format("instrument: {} procs instrumented, the first {}.\n", procs, first.name);
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_32_policy)
+		{
+			// each proc the policy covers gives the same results wide and light
+			u64 seed = 0;
+			alignas (64) u64 a[8]{};
+			alignas (64) u64 b[8]{};
+			alignas (64) u64 wide[8]{};
+			alignas (64) u64 light[8]{};
+			alignas (64) u64 inplace[8]{};
+			const u32 before = set_vector_policy_u(VECTOR_WIDE);
+			Assert::AreEqual(VECTOR_WIDE, set_vector_policy_u(VECTOR_WIDE));
+			Assert::AreEqual(VECTOR_WIDE, set_vector_policy_u(7), L"policy: not one of the two, not taken");
+			Assert::AreEqual(VECTOR_WIDE, set_vector_policy_u(VECTOR_LIGHT));
+			Assert::AreEqual(VECTOR_LIGHT, set_vector_policy_u(VECTOR_WIDE));
+
+			for (int i = 0; i < runcount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+				{
+					a[j] = (i % 7 == 0 && j != i % 8) ? 0 : RandomU64(&seed);	// some with one non-zero word
+					b[j] = RandomU64(&seed);
+				};
+				if (i % 50 == 0)
+					memset(a, 0, 64);
+				const u16 bits = u16((i < 600) ? i : RandomU64(&seed) % 1024);	// every count to 599, then some over 512
+
+				for (const bool left : { false, true })
+				{
+					set_vector_policy_u(VECTOR_WIDE);
+					left ? shl_u(wide, a, bits) : shr_u(wide, a, bits);
+					set_vector_policy_u(VECTOR_LIGHT);
+					left ? shl_u(light, a, bits) : shr_u(light, a, bits);
+					Assert::AreEqual(0, memcmp(wide, light, 64), left ? L"policy: shl_u" : L"policy: shr_u");
+					memcpy(inplace, a, 64);
+					left ? shl_u(inplace, inplace, bits) : shr_u(inplace, inplace, bits);
+					Assert::AreEqual(0, memcmp(wide, inplace, 64), left ? L"policy: shl_u in place" : L"policy: shr_u in place");
+				};
+
+				void (*const ops[])(const u64*, const u64*, const u64*) = { and_u, or_u, xor_u };
+				for (auto op : ops)
+				{
+					set_vector_policy_u(VECTOR_WIDE);
+					op(wide, a, b);
+					set_vector_policy_u(VECTOR_LIGHT);
+					op(light, a, b);
+					Assert::AreEqual(0, memcmp(wide, light, 64), L"policy: and_u / or_u / xor_u");
+				};
+				set_vector_policy_u(VECTOR_WIDE);
+				not_u(wide, a);
+				const s16 msb = msb_u(a);
+				const s16 lsb = lsb_u(a);
+				set_vector_policy_u(VECTOR_LIGHT);
+				not_u(light, a);
+				Assert::AreEqual(0, memcmp(wide, light, 64), L"policy: not_u");
+				Assert::AreEqual(msb, msb_u(a), L"policy: msb_u");
+				Assert::AreEqual(lsb, lsb_u(a), L"policy: lsb_u");
+			};
+			set_vector_policy_u(before);
+			string test_message = "set_vector_policy_u: shr_u, shl_u, and_u, or_u, xor_u, not_u, msb_u, lsb_u the same wide and light. Ran "
+				+ to_string(runcount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_32_policy_reg)
+		{
+			// the VECTOR_LIGHT kernels, register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			alignas (64) u64 a[8]{ 1, 2, 3, 4, 5, 6, 7, 8 };
+			alignas (64) u64 d[8]{};
+			regs r_before{};
+			regs r_after{};
+			const u32 before = set_vector_policy_u(VECTOR_LIGHT);
+			for (int i = 0; i < regvercount; i++)
+			{
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				shr_u(d, a, u16(i % 520));
+				shl_u(d, d, u16(i % 520));
+				and_u(d, d, a);
+				not_u(d, d);
+				msb_u(d);
+				lsb_u(d);
+				set_vector_policy_u(VECTOR_LIGHT);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+			set_vector_policy_u(before);
+			string test_message = "set_vector_policy_u, VECTOR_LIGHT function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_33_pipe)
+		{
+			// pipe_run_n (ui512pipe.h): each chain the same as the single value procs, op by op, over any n (whole tiles, a part
+			// tile, none), from any first record, in place, and split between threads
+			u64 seed = 0;
+			const u64 maxn = 3 * PIPE_TILE + 17;
+			vector<u64> xs(maxn * 8 + 8), ys(maxn * 8 + 8), outs(maxn * 8 + 8), ins(maxn * 8 + 8);
+			u64* x = xs.data() + ((64 - (reinterpret_cast<uintptr_t>(xs.data()) & 63)) & 63) / 8;	// 64 byte aligned
+			u64* y = ys.data() + ((64 - (reinterpret_cast<uintptr_t>(ys.data()) & 63)) & 63) / 8;
+			u64* out = outs.data() + ((64 - (reinterpret_cast<uintptr_t>(outs.data()) & 63)) & 63) / 8;
+			u64* inplace = ins.data() + ((64 - (reinterpret_cast<uintptr_t>(ins.data()) & 63)) & 63) / 8;
+			vector<s16> pops(maxn), msbs(maxn), lsbs(maxn), pops2(maxn);
+			alignas (64) u64 mask[8]{};
+			alignas (64) u64 key[8]{};
+			alignas (64) u64 r[8]{};
+			alignas (64) u64 t[8]{};
+			const int adjruncount = runcount / 25;
+			for (int i = 0; i < adjruncount; i++)
+			{
+				for (u64 j = 0; j < maxn * 8; j++)
+				{
+					x[j] = (j % 8 == u64(i) % 8 || i % 3 != 0) ? RandomU64(&seed) : 0;	// some records mostly zero
+					y[j] = RandomU64(&seed);
+				};
+				if (i % 10 == 0)
+					memset(x, 0, 64 * 5);											// and some all zero
+				for (int j = 0; j < 8; j++)
+				{
+					mask[j] = RandomU64(&seed);
+					key[j] = RandomU64(&seed);
+				};
+				const u64 sizes[] = { 0, 1, PIPE_TILE - 1, PIPE_TILE, PIPE_TILE + 1, maxn };
+				const u64 n = sizes[i % 6];
+				const u64 first = (i % 4 == 0 && n < maxn) ? 1 : 0;
+				const u16 bits = u16((i < 520) ? i : RandomU64(&seed) % 700);
+				const u8 imm = u8(RandomU64(&seed));
+
+				// ( ( ( x >> bits ) AND mask ) XOR y ) counted, its msb and lsb; tern( x << bits, y, mask ) to out
+				ui512_pipe p;
+				const int sx = p.array(x), sy = p.array(y), so = p.array(out), sm = p.constant(mask), sk = p.constant(key);
+				const int st = p.temp(), st2 = p.temp();
+				const int sp = p.counts(pops.data()), sh = p.counts(msbs.data()), sl = p.counts(lsbs.data());
+				p.shr(st, sx, bits).and_(st, st, sm).xor_(st, st, sy).popcnt(sp, st).msb(sh, st).lsb(sl, st);
+				p.shl(st2, sx, bits).tern(so, st2, sy, sm, imm).not_(st, so).or_(st, st, sk).xor_(so, so, st);
+				const u64 total = p.run(first, n);
+
+				u64 expect = 0;
+				for (u64 k = first; k < first + n; k++)
+				{
+					shr_u(r, x + k * 8, bits);
+					and_u(r, r, mask);
+					xor_u(r, r, y + k * 8);
+					const s16 pc = popcnt_u(r);
+					expect += u64(pc);
+					Assert::AreEqual(pc, pops[k], L"pipe: popcnt");
+					Assert::AreEqual(msb_u(r), msbs[k], L"pipe: msb");
+					Assert::AreEqual(lsb_u(r), lsbs[k], L"pipe: lsb");
+
+					shl_u(t, x + k * 8, bits);
+					for (int j = 0; j < 8; j++)
+					{
+						const u64 a = t[j], b = y[k * 8 + j], c = mask[j];
+						u64 f = 0;
+						for (int m = 0; m < 8; m++)									// each minterm of imm
+							if ((imm >> m) & 1)
+								f |= ((m & 4) ? a : ~a) & ((m & 2) ? b : ~b) & ((m & 1) ? c : ~c);
+						Assert::AreEqual(f ^ (~f | key[j]), out[k * 8 + j], L"pipe: tern, not, or, xor");
+					};
+				};
+				Assert::AreEqual(expect, total, L"pipe: total of the counts");
+
+				// in place, on the records themselves; then the same split between threads
+				memcpy(inplace, x, maxn * 64);
+				ui512_pipe q;
+				const int si = q.array(inplace), sq = q.array(y), sc = q.counts(pops2.data());
+				q.shl(si, si, bits).xor_(si, si, sq).popcnt(sc, si);
+				const u64 qtotal = q.run(first, n);
+				expect = 0;
+				for (u64 k = first; k < first + n; k++)
+				{
+					shl_u(r, x + k * 8, bits);
+					xor_u(r, r, y + k * 8);
+					expect += u64(popcnt_u(r));
+					Assert::AreEqual(0, memcmp(r, inplace + k * 8, 64), L"pipe: in place");
+				};
+				Assert::AreEqual(expect, qtotal, L"pipe: in place total");
+				memcpy(inplace, x, maxn * 64);
+				Assert::AreEqual(qtotal, q.run(first, n, 3), L"pipe: threads total");
+				for (u64 k = first; k < first + n; k++)
+				{
+					shl_u(r, x + k * 8, bits);
+					xor_u(r, r, y + k * 8);
+					Assert::AreEqual(0, memcmp(r, inplace + k * 8, 64), L"pipe: threads");
+				};
+			};
+			string test_message = "pipe_run_n: shift, and, or, xor, not, tern, popcnt, msb, lsb chains as the single value procs. Ran "
+				+ to_string(adjruncount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_33_pipe_reg)
+		{
+			// pipe_run_n, register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			const u64 n = PIPE_TILE + 3;
+			vector<u64> xs(n * 8 + 8);
+			u64* x = xs.data() + ((64 - (reinterpret_cast<uintptr_t>(xs.data()) & 63)) & 63) / 8;
+			vector<s16> pops(n);
+			alignas (64) u64 mask[8]{ 1, 2, 3, 4, 5, 6, 7, 8 };
+			ui512_pipe p;
+			const int sx = p.array(x), sm = p.constant(mask), st = p.temp(), sp = p.counts(pops.data());
+			p.shr(st, sx, 9).tern(st, st, sm, sx, 0x96).not_(st, st).popcnt(sp, st).msb(sp, st).lsb(sp, st).shl(sx, st, 3);
+			vector<pipe_slot_u> slots = p.slot_list();
+			vector<u64> tiles(PIPE_TILE * 8 + 8);
+			slots[st].base = tiles.data() + ((64 - (reinterpret_cast<uintptr_t>(tiles.data()) & 63)) & 63) / 8;
+			const vector<pipe_op_u>& ops = p.op_list();
+			regs r_before{};
+			regs r_after{};
+			for (int i = 0; i < regvercount / 10; i++)
+			{
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				pipe_run_n(slots.data(), ops.data(), ops.size(), 0, n);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+			string test_message = "pipe_run_n function register validation. Ran "
+				+ to_string(regvercount / 10) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_34_bitmap)
+		{
+			u64 seed = 0;
+			const u32 span = 4 * ui512_bitmap::chunk_bits;						// four chunks
+			const u64 nblocks = span / 512;
+			vector<u64> ds(nblocks * 8 + 8);
+			u64* dense = ds.data() + ((64 - (reinterpret_cast<uintptr_t>(ds.data()) & 63)) & 63) / 8;
+
+			// a chunk each: sparse (an array), about half set (dense), all but a few (runs, once optimized), and one left empty
+			auto make = [&](ui512_bitmap& b, set<u32>& ref)
+				{
+					for (int k = 0; k < 300; k++)
+					{
+						const u32 v = u32(RandomU64(&seed) % ui512_bitmap::chunk_bits);
+						b.add(v);
+						ref.insert(v);
+					};
+					for (int k = 0; k < 40000; k++)
+					{
+						const u32 v = ui512_bitmap::chunk_bits + u32(RandomU64(&seed) % ui512_bitmap::chunk_bits);
+						b.add(v);
+						ref.insert(v);
+					};
+					const u32 gap = u32(RandomU64(&seed) % 1000);
+					for (u32 v = 2 * ui512_bitmap::chunk_bits; v < 3 * ui512_bitmap::chunk_bits; v++)
+						if (v % 4096 != gap)
+						{
+							b.add(v);
+							ref.insert(v);
+						};
+				};
+			auto check = [&](const ui512_bitmap& b, const set<u32>& ref, const wchar_t* what)
+				{
+					Assert::AreEqual(u64(ref.size()), b.cardinality(), what);
+					vector<u32> got;
+					b.for_each([&](u32 v) { got.push_back(v); });
+					Assert::IsTrue(vector<u32>(ref.begin(), ref.end()) == got, what);
+				};
+
+			for (int i = 0; i < runcount / 1000 + 2; i++)
+			{
+				ui512_bitmap a;
+				ui512_bitmap b;
+				set<u32> ra;
+				set<u32> rb;
+				make(a, ra);
+				make(b, rb);
+				check(a, ra, L"bitmap: add");
+				Assert::IsTrue(a.chunk_kind(0) == ui512_bitmap::kind::array && a.chunk_kind(1) == ui512_bitmap::kind::dense,
+					L"bitmap: chunk kinds by count");
+				for (int k = 0; k < 1000; k++)
+				{
+					const u32 v = u32(RandomU64(&seed) % span);
+					Assert::AreEqual(ra.count(v) != 0, a.contains(v), L"bitmap: contains");
+				};
+
+				const size_t before = a.bytes();
+				if (i % 2 == 1)
+				{
+					a.optimize();
+					b.optimize();
+					Assert::IsTrue(a.chunk_kind(2) == ui512_bitmap::kind::run, L"bitmap: optimize, mostly full chunk not runs");
+					Assert::IsTrue(a.bytes() < before, L"bitmap: optimize, no smaller");
+					check(a, ra, L"bitmap: optimize");
+					for (int k = 0; k < 1000; k++)
+					{
+						const u32 v = u32(RandomU64(&seed) % span);
+						Assert::AreEqual(ra.count(v) != 0, a.contains(v), L"bitmap: contains, optimized");
+					};
+				};
+
+				set<u32> expected;
+				set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), inserter(expected, expected.end()));
+				check(ui512_bitmap::and_(a, b), expected, L"bitmap: and_");
+				expected.clear();
+				set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), inserter(expected, expected.end()));
+				check(ui512_bitmap::or_(a, b), expected, L"bitmap: or_");
+				expected.clear();
+				set_symmetric_difference(ra.begin(), ra.end(), rb.begin(), rb.end(), inserter(expected, expected.end()));
+				check(ui512_bitmap::xor_(a, b), expected, L"bitmap: xor_");
+
+				// a few values against many: the and_ gallops (the first chunk), merges with runs or tests bits (the third)
+				ui512_bitmap few;
+				set<u32> rf;
+				const vector<u32> low(ra.begin(), ra.lower_bound(ui512_bitmap::chunk_bits));
+				for (int k = 0; k < 8; k++)
+				{
+					const u32 v = (k % 2 == 0) ? low[RandomU64(&seed) % low.size()] : u32(RandomU64(&seed) % ui512_bitmap::chunk_bits);
+					few.add(v);
+					rf.insert(v);
+					const u32 w = 2 * ui512_bitmap::chunk_bits + u32(RandomU64(&seed) % ui512_bitmap::chunk_bits);
+					few.add(w);
+					rf.insert(w);
+				};
+				expected.clear();
+				set_intersection(ra.begin(), ra.end(), rf.begin(), rf.end(), inserter(expected, expected.end()));
+				check(ui512_bitmap::and_(few, a), expected, L"bitmap: and_, galloping");
+
+				// dense blocks, there and back
+				a.to_dense(dense, nblocks);
+				for (int k = 0; k < 1000; k++)
+				{
+					const u32 v = u32(RandomU64(&seed) % span);
+					const u64 bit = (dense[(v / 512) * 8 + 7 - (v / 64) % 8] >> (v % 64)) & 1;
+					Assert::AreEqual(u64(ra.count(v)), bit, L"bitmap: to_dense");
+				};
+				ui512_bitmap back = ui512_bitmap::from_dense(dense, nblocks);
+				check(back, ra, L"bitmap: from_dense");
+				Assert::AreEqual(size_t(3), back.chunks());
+			};
+
+			string test_message = "ui512_bitmap: add, contains, optimize, and_, or_, xor_, for_each, to_dense, from_dense, against "
+				"std::set. Ran " + to_string(runcount / 1000 + 2) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+		TEST_METHOD(ui512bits_35_text)
+		{
+			u64 seed = 0;
+			alignas (64) u64 num[8]{};
+			alignas (64) u64 back[8]{};
+			const int adjruncount = runcount / 5;
+			for (int i = 0; i < adjruncount; i++)
+			{
+				for (int j = 0; j < 8; j++)
+					num[j] = (i % 7 == 0) ? 0 : (i % 7 == 1) ? ~0ull : RandomU64(&seed);
+
+				// hex: as printed, word by word; read back in either case
+				string expected;
+				for (int j = 0; j < 8; j++)
+					expected += format("{:016x}", num[j]);
+				char text[512 + 1]{};
+				to_hex_u(text, num);
+				Assert::IsTrue(expected == string(text, 128), L"to_hex_u");
+				if (i % 2 == 1)
+					for (char& c : text)
+						c = char(toupper(c));
+				memset(back, 0xA5, 64);
+				Assert::AreEqual(s16(-1), from_hex_u(back, text), L"from_hex_u: digits taken as not");
+				Assert::AreEqual(0, memcmp(num, back, 64), L"from_hex_u");
+
+				// a character not a hex digit, at each place in turn over the run
+				const int bad = i % 128;
+				const char bads[] = { 'g', 'G', '/', ':', '@', '`', ' ', '\0', char(0xB0), char(0x10) };
+				const char was = text[bad];
+				text[bad] = bads[i % size(bads)];
+				Assert::AreEqual(s16(bad), from_hex_u(back, text), L"from_hex_u: first not a digit");
+				text[bad] = was;
+
+				// binary: character k the bit 511 - k
+				to_bin_u(text, num);
+				for (int k = 0; k < 512; k++)
+				{
+					const int bit = 511 - k;
+					const char digit = ((num[7 - bit / 64] >> (bit % 64)) & 1) ? '1' : '0';
+					if (text[k] != digit)
+						Assert::Fail(L"to_bin_u");
+				};
+				const s16 top = msb_u(num);
+				if (top >= 0)
+					Assert::AreEqual('1', text[511 - top], L"to_bin_u: msb_u");
+				memset(back, 0xA5, 64);
+				Assert::AreEqual(s16(-1), from_bin_u(back, text), L"from_bin_u: digits taken as not");
+				Assert::AreEqual(0, memcmp(num, back, 64), L"from_bin_u");
+				const int badb = (i * 7) % 512;
+				const char wasb = text[badb];
+				text[badb] = (i % 3 == 0) ? '2' : (i % 3 == 1) ? '/' : 'a';
+				Assert::AreEqual(s16(badb), from_bin_u(back, text), L"from_bin_u: first not a digit");
+				text[badb] = wasb;
+			};
+
+			// batches: stride apart, what lies between left alone; reads stop at the first value with a bad character
+			const u64 n = 37;
+			vector<u64> vs(n * 8 + 8);
+			u64* v = vs.data() + ((64 - (reinterpret_cast<uintptr_t>(vs.data()) & 63)) & 63) / 8;
+			vector<u64> rs(n * 8 + 8);
+			u64* r = rs.data() + ((64 - (reinterpret_cast<uintptr_t>(rs.data()) & 63)) & 63) / 8;
+			for (u64 k = 0; k < n * 8; k++)
+				v[k] = RandomU64(&seed);
+			for (const u64 stride : { 128ull, 129ull, 512ull, 515ull })
+			{
+				vector<char> buf(n * stride + 1, '\n');
+				char one[512];
+				const bool hex = stride < 512;
+				const u64 digits = hex ? 128 : 512;
+				if (hex)
+					to_hex_n(buf.data(), v, n, stride);
+				else
+					to_bin_n(buf.data(), v, n, stride);
+				for (u64 k = 0; k < n; k++)
+				{
+					if (hex)
+						to_hex_u(one, v + k * 8);
+					else
+						to_bin_u(one, v + k * 8);
+					Assert::AreEqual(0, memcmp(one, buf.data() + k * stride, digits), L"to_hex_n / to_bin_n");
+					for (u64 c = digits; c < stride; c++)
+						Assert::AreEqual('\n', buf[k * stride + c], L"to_hex_n / to_bin_n: between overwritten");
+				};
+				Assert::AreEqual('\n', buf[n * stride]);
+				memset(r, 0, n * 64);
+				Assert::AreEqual(n, hex ? from_hex_n(r, buf.data(), n, stride) : from_bin_n(r, buf.data(), n, stride));
+				Assert::AreEqual(0, memcmp(v, r, n * 64), L"from_hex_n / from_bin_n");
+				buf[20 * stride + 5] = 'x';
+				Assert::AreEqual(u64(20), hex ? from_hex_n(r, buf.data(), n, stride) : from_bin_n(r, buf.data(), n, stride));
+				Assert::AreEqual(u64(0), hex ? from_hex_n(r, buf.data(), 0, stride) : from_bin_n(r, buf.data(), 0, stride));
+			};
+
+			string test_message = "to_hex_u, from_hex_u, to_bin_u, from_bin_u and the _n forms, against std::format and bit by bit. Ran "
+				+ to_string(adjruncount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_35_text_reg)
+		{
+			// to_hex_u, from_hex_u, to_bin_u, from_bin_u and the _n forms, register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			alignas (64) u64 num[16]{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+			alignas (64) u64 back[16]{};
+			char text[1024 + 8]{};
+			regs r_before{};
+			regs r_after{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				to_hex_u(text, num);
+				from_hex_u(back, text);
+				to_bin_u(text, num);
+				from_bin_u(back, text);
+				to_hex_n(text, num, 2, 130);
+				from_hex_n(back, text, 2, 130);
+				to_bin_n(text, num, 2, 512);
+				from_bin_n(back, text, 2, 512);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+			string test_message = "to_hex_u, from_hex_u, to_bin_u, from_bin_u and the _n forms, function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+		};
+
+		TEST_METHOD(ui512bits_36_predicates)
+		{
+			// is_zero_u, eq_u, subset_u, intersects_u against word by word loops, on values made to be zero, equal, subsets,
+			// disjoint, or one bit off (in any word); then the _n forms, b an array and b one value, bit for bit against them
+			u64 seed = 0;
+			const u64 nmax = 200;
+			alignas (64) static u64 a[nmax * 8]{};
+			alignas (64) static u64 b[nmax * 8]{};
+			u64 bits[(nmax + 63) / 64 + 1]{};
+			auto make = [&](u64* x, u64* y, int kind)
+				{
+					for (int j = 0; j < 8; j++)
+					{
+						y[j] = RandomU64(&seed);
+						x[j] = (kind == 0) ? 0 : (kind == 1) ? y[j] : (kind == 2) ? y[j] & RandomU64(&seed)
+							: (kind == 3) ? ~y[j] & RandomU64(&seed) : RandomU64(&seed);
+					};
+					if (kind >= 5)									// one bit off, in a random word
+					{
+						const u64 bit = RandomU64(&seed) % 512;
+						memcpy(x, y, 64);
+						if (kind == 6)
+							memset(x, 0, 64);
+						x[7 - bit / 64] ^= 1ull << (bit % 64);
+					};
+				};
+			auto zero = [](const u64* x) { for (int j = 0; j < 8; j++) if (x[j] != 0) return 0; return 1; };
+			auto eq = [](const u64* x, const u64* y) { for (int j = 0; j < 8; j++) if (x[j] != y[j]) return 0; return 1; };
+			auto subset = [](const u64* x, const u64* y) { for (int j = 0; j < 8; j++) if ((x[j] & ~y[j]) != 0) return 0; return 1; };
+			auto meet = [](const u64* x, const u64* y) { for (int j = 0; j < 8; j++) if ((x[j] & y[j]) != 0) return 1; return 0; };
+
+			const int adjruncount = runcount / 5;
+			for (int i = 0; i < adjruncount; i++)
+			{
+				make(a, b, i % 7);
+				Assert::AreEqual(s16(zero(a)), is_zero_u(a), L"is_zero_u");
+				Assert::AreEqual(s16(eq(a, b)), eq_u(a, b), L"eq_u");
+				Assert::AreEqual(s16(subset(a, b)), subset_u(a, b), L"subset_u");
+				Assert::AreEqual(s16(meet(a, b)), intersects_u(a, b), L"intersects_u");
+				Assert::AreEqual(s16(1), subset_u(a, a), L"subset_u: of itself");
+				Assert::AreEqual(s16(1 - zero(a)), intersects_u(a, a), L"intersects_u: with itself");
+			};
+
+			for (const u64 n : { 0ull, 1ull, 63ull, 64ull, 65ull, 130ull, nmax })
+				for (const u64 stride : { 64ull, 0ull })
+				{
+					for (u64 k = 0; k < n; k++)
+						make(&a[k * 8], &b[k * 8], int(RandomU64(&seed) % 7));
+					if (stride == 0)
+						for (u64 k = 0; k < n; k++)
+							if (k % 3 == 0)
+								memcpy(&a[k * 8], b, 64);		// some equal to the one b
+					const u64 words = (n + 63) / 64;
+					for (int p = 0; p < 4; p++)
+					{
+						memset(bits, 0xA5, sizeof(bits));
+						const u64 count = (p == 0) ? is_zero_n(bits, a, n) : (p == 1) ? eq_n(bits, a, b, n, stride)
+							: (p == 2) ? subset_n(bits, a, b, n, stride) : intersects_n(bits, a, b, n, stride);
+						u64 expected = 0;
+						for (u64 k = 0; k < n; k++)
+						{
+							const u64* x = &a[k * 8];
+							const u64* y = &b[k * (stride / 8)];
+							const int want = (p == 0) ? zero(x) : (p == 1) ? eq(x, y) : (p == 2) ? subset(x, y) : meet(x, y);
+							expected += want;
+							Assert::AreEqual(u64(want), (bits[k / 64] >> (k % 64)) & 1, L"_n: result bit");
+						};
+						Assert::AreEqual(expected, count, L"_n: count");
+						if (n % 64 != 0)
+							Assert::AreEqual(u64(0), bits[words - 1] >> (n % 64), L"_n: bits past n set");
+						Assert::AreEqual(0xA5A5A5A5A5A5A5A5ull, bits[words], L"_n: written past the result QWORDS");
+					};
+				};
+
+			string test_message = "is_zero_u, eq_u, subset_u, intersects_u and the _n forms, against word by word loops. Ran "
+				+ to_string(adjruncount) + " times.\n";
+			Logger::WriteMessage(test_message.c_str());
+			Logger::WriteMessage(L"Passed. Tested expected values via assert.\n");
+		};
+
+		TEST_METHOD(ui512bits_36_predicates_reg)
+		{
+			// is_zero_u, eq_u, subset_u, intersects_u and the _n forms, register verification.
+			//	Check register before call, verify non-volatile register remain unchanged after call.
+			alignas (64) u64 a[16]{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+			alignas (64) u64 b[16]{ 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15, 17 };
+			u64 bits[2]{};
+			regs r_before{};
+			regs r_after{};
+			for (int i = 0; i < regvercount; i++)
+			{
+				r_before.Clear();
+				reg_verify((u64*)&r_before);
+				is_zero_u(a);
+				eq_u(a, b);
+				subset_u(a, b);
+				intersects_u(a, b);
+				is_zero_n(bits, a, 2);
+				eq_n(bits, a, b, 2, 64);
+				subset_n(bits, a, b, 2, 0);
+				intersects_n(bits, a, b, 2, 64);
+				r_after.Clear();
+				reg_verify((u64*)&r_after);
+				Assert::IsTrue(r_before.AreEqual(&r_after), L"Register validation failed");
+			};
+			string test_message = "is_zero_u, eq_u, subset_u, intersects_u and the _n forms, function register validation. Ran "
+				+ to_string(regvercount) + " times.\n";
 			Logger::WriteMessage(test_message.c_str());
 		};
 	};
@@ -0,0 +1,557 @@
+#pragma once
+
+#ifndef ui512bitmap_h
+#define ui512bitmap_h
+
+//		ui512bitmap.h
+//
+//		File:			ui512bitmap.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		ui512_bitmap: a set of u32 values, compressed (Roaring style), for bitmaps that are mostly empty or mostly full, where a
+//		dense array of 512 bit blocks would hold (and and_u / or_u would stream) mostly zeroes or ones:
+//
+//			chunks		-	the values with the same high 16 bits, in one of three forms, by its count (popcount):
+//							array: the low 16 bits, sorted, up to array_max of them (2 bytes each)
+//							dense: 128 blocks of 512 bits (8K bytes), value v at bit v mod 512 of block v / 512, numbered as
+//								msb_u / lsb_u (bit 0 the lsb of word 7); the same layout as a dense bitmap of ui512 blocks
+//							run: ( first, last ) pairs of runs of values (4 bytes each); made by optimize, where smaller
+//			and_, or_,	-	chunk by chunk: dense with dense by the procs of ui512b (pipe_run_n: the op, then popcnt of the
+//			xor_			result, one pass); arrays merged (and_: galloping through the larger, if much larger); an array
+//							with a dense chunk by testing / setting its bits; runs with runs (and_, or_) as intervals, and
+//							runs with an array (and_) by a merge; otherwise runs as their array or dense form. Each result
+//							chunk takes the form its count calls for
+//			for_each	-	the values in order; dense chunks a block at a time by lsb_u, clearing each bit found
+//			from_dense,	-	to and from a dense array of 512 bit blocks (popcnt_n choosing each chunk's form)
+//			to_dense
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "CommonTypeDefs.h"
+#include "ui512b.h"
+
+class ui512_bitmap
+{
+public:
+	static constexpr u32 chunk_bits = 65536;							// values to a chunk
+	static constexpr u32 chunk_blocks = chunk_bits / 512;				// 128 blocks, dense
+	static constexpr u32 array_max = 4096;								// more than this: a dense chunk is smaller
+	static constexpr u32 gallop_ratio = 32;								// and_ of arrays: gallop if one is this many times larger
+
+	enum class kind : u8 { array, dense, run };
+
+	void add(u32 v)
+	{
+		chunk& c = find_or_add(u16(v >> 16));
+		const u16 low = u16(v);
+		if (c.k == kind::run)
+			unrun(c);
+		if (c.k == kind::dense)
+		{
+			if (!test_bit(c.dense.data(), low))
+			{
+				set_bit(c.dense.data(), low);
+				c.card++;
+			};
+			return;
+		};
+		auto at = std::lower_bound(c.values.begin(), c.values.end(), low);
+		if (at != c.values.end() && *at == low)
+			return;
+		c.values.insert(at, low);
+		c.card++;
+		if (c.card > array_max)
+			settle(c);
+	};
+
+	bool contains(u32 v) const
+	{
+		const chunk* c = find(u16(v >> 16));
+		if (c == nullptr)
+			return false;
+		const u16 low = u16(v);
+		switch (c->k)
+		{
+		case kind::dense:
+			return test_bit(c->dense.data(), low);
+		case kind::array:
+			return std::binary_search(c->values.begin(), c->values.end(), low);
+		default:
+			for (size_t i = 0; i < c->values.size(); i += 2)
+				if (low >= c->values[i] && low <= c->values[i + 1])
+					return true;
+			return false;
+		};
+	};
+
+	u64 cardinality() const
+	{
+		u64 n = 0;
+		for (const chunk& c : list) n += c.card;
+		return n;
+	};
+
+	// bytes held: the chunks, their values and blocks
+	size_t bytes() const
+	{
+		size_t b = list.capacity() * sizeof(chunk);
+		for (const chunk& c : list)
+			b += c.values.capacity() * sizeof(u16) + c.dense.capacity() * sizeof(block);
+		return b;
+	};
+
+	size_t chunks() const { return list.size(); };
+	kind chunk_kind(size_t i) const { return list[i].k; };
+	void clear() { list.clear(); };
+
+	// f( value ) for each value, ascending
+	template<class F>
+	void for_each(F&& f) const
+	{
+		for (const chunk& c : list)
+		{
+			const u32 high = u32(c.key) << 16;
+			if (c.k == kind::array)
+				for (const u16 low : c.values) f(high | low);
+			else if (c.k == kind::run)
+			{
+				for (size_t i = 0; i < c.values.size(); i += 2)
+					for (u32 v = c.values[i]; v <= c.values[i + 1]; v++) f(high | v);
+			}
+			else
+				for_each_dense(c.dense.data(), [&](u32 low) { f(high | low); });
+		};
+	};
+
+	// each chunk to runs, where that is smaller than its array or dense form
+	void optimize()
+	{
+		for (chunk& c : list)
+		{
+			if (c.k == kind::run)
+				continue;
+			const u32 runs = (c.k == kind::dense) ? dense_runs(c.dense.data()) : array_runs(c.values);
+			if (u64(runs) * 4 < std::min<u64>(u64(c.card) * 2, chunk_blocks * sizeof(block)))
+			{
+				std::vector<u16> pairs;
+				pairs.reserve(runs * 2);
+				each_value(c, [&](u32 low)
+					{
+						if (!pairs.empty() && pairs.back() + 1u == low)
+							pairs.back() = u16(low);
+						else
+						{
+							pairs.push_back(u16(low));
+							pairs.push_back(u16(low));
+						};
+					});
+				c.values = std::move(pairs);
+				c.dense = std::vector<block>();
+				c.k = kind::run;
+			};
+		};
+	};
+
+	// from nblocks 512 bit blocks, 64 byte aligned: value v is bit v mod 512 of block v / 512
+	static ui512_bitmap from_dense(const u64* blocks, u64 nblocks)
+	{
+		ui512_bitmap r;
+		u16 counts[chunk_blocks];
+		for (u64 first = 0; first < nblocks; first += chunk_blocks)
+		{
+			const u64 n = std::min<u64>(chunk_blocks, nblocks - first);
+			const u64 card = popcnt_n(counts, blocks + first * 8, n);
+			if (card == 0)
+				continue;
+			chunk c{ u16(first / chunk_blocks), kind::dense, u32(card), {}, std::vector<block>(chunk_blocks) };
+			std::memcpy(c.dense.data(), blocks + first * 8, n * 64);
+			settle(c);
+			r.list.push_back(std::move(c));
+		};
+		return r;
+	};
+
+	// to nblocks 512 bit blocks, 64 byte aligned (all written; values from nblocks * 512 up left out)
+	void to_dense(u64* blocks, u64 nblocks) const
+	{
+		std::memset(blocks, 0, nblocks * 64);
+		for (const chunk& c : list)
+		{
+			const u64 first = u64(c.key) * chunk_blocks;
+			if (first >= nblocks)
+				break;
+			const u64 n = std::min<u64>(chunk_blocks, nblocks - first);
+			if (c.k == kind::dense)
+				std::memcpy(blocks + first * 8, c.dense.data(), n * 64);
+			else
+				each_value(c, [&](u32 low) { if (low / 512 < n) set_bit(reinterpret_cast<block*>(blocks + first * 8), low); });
+		};
+	};
+
+	static ui512_bitmap and_(const ui512_bitmap& a, const ui512_bitmap& b) { return combine(a, b, PIPE_AND); };
+	static ui512_bitmap or_(const ui512_bitmap& a, const ui512_bitmap& b) { return combine(a, b, PIPE_OR); };
+	static ui512_bitmap xor_(const ui512_bitmap& a, const ui512_bitmap& b) { return combine(a, b, PIPE_XOR); };
+
+private:
+	struct alignas(64) block
+	{
+		u64 w[8];
+	};
+
+	struct chunk
+	{
+		u16 key;														// the high 16 bits
+		kind k;
+		u32 card;														// values, 1 to 65536
+		std::vector<u16> values;										// array: the values; run: first, last of each run
+		std::vector<block> dense;										// dense: chunk_blocks blocks
+	};
+
+	static void set_bit(block* d, u32 low) { d[low >> 9].w[7 - ((low >> 6) & 7)] |= 1ull << (low & 63); };
+	static void flip_bit(block* d, u32 low) { d[low >> 9].w[7 - ((low >> 6) & 7)] ^= 1ull << (low & 63); };
+	static bool test_bit(const block* d, u32 low) { return (d[low >> 9].w[7 - ((low >> 6) & 7)] >> (low & 63)) & 1; };
+
+	// f( low ) for each set bit of the dense blocks, ascending: lsb_u of a copy of each block, the bit found cleared
+	template<class F>
+	static void for_each_dense(const block* d, F&& f)
+	{
+		alignas (64) u64 t[8];
+		for (u32 i = 0; i < chunk_blocks; i++)
+		{
+			std::memcpy(t, d[i].w, 64);
+			for (s16 bit = lsb_u(t); bit >= 0; bit = lsb_u(t))
+			{
+				f(i * 512 + u32(bit));
+				t[7 - bit / 64] &= ~(1ull << (bit & 63));
+			};
+		};
+	};
+
+	// f( low ) for each value of a chunk, ascending
+	template<class F>
+	static void each_value(const chunk& c, F&& f)
+	{
+		if (c.k == kind::array)
+			for (const u16 low : c.values) f(u32(low));
+		else if (c.k == kind::run)
+		{
+			for (size_t i = 0; i < c.values.size(); i += 2)
+				for (u32 v = c.values[i]; v <= c.values[i + 1]; v++) f(v);
+		}
+		else
+			for_each_dense(c.dense.data(), f);
+	};
+
+	// set bits first to last (inclusive) of dense blocks
+	static void fill(block* d, u32 first, u32 last)
+	{
+		while (first <= last)
+		{
+			const u32 bit = first & 63;
+			const u32 n = std::min<u32>(64 - bit, last - first + 1);
+			const u64 m = (n == 64) ? ~0ull : ((1ull << n) - 1) << bit;
+			d[first >> 9].w[7 - ((first >> 6) & 7)] |= m;
+			first += n;
+		};
+	};
+
+	// runs of set bits in dense blocks: popcount of x AND NOT ( x << 1 ), the first bit of each run; bit 511 of each block
+	// carried into bit 0 of the shifted next
+	static u32 dense_runs(const block* d)
+	{
+		alignas (64) u64 t[8];
+		u32 runs = 0;
+		u64 carry = 0;
+		for (u32 i = 0; i < chunk_blocks; i++)
+		{
+			shl_u(t, d[i].w, 1);
+			t[7] |= carry;
+			not_u(t, t);
+			and_u(t, t, d[i].w);
+			runs += u32(popcnt_u(t));
+			carry = d[i].w[0] >> 63;
+		};
+		return runs;
+	};
+
+	static u32 array_runs(const std::vector<u16>& v)
+	{
+		u32 runs = 0;
+		for (size_t i = 0; i < v.size(); i++)
+			if (i == 0 || v[i] != v[i - 1] + 1) runs++;
+		return runs;
+	};
+
+	// the form c's count calls for: array up to array_max values, dense above; a run chunk kept while smaller than both
+	static void settle(chunk& c)
+	{
+		if (c.k == kind::run)
+		{
+			if (c.values.size() * 2 < std::min<u64>(u64(c.card) * 2, chunk_blocks * sizeof(block)))
+				return;
+			unrun(c);
+			return;
+		};
+		if (c.k == kind::dense && c.card <= array_max)
+		{
+			std::vector<u16> values;
+			values.reserve(c.card);
+			for_each_dense(c.dense.data(), [&](u32 low) { values.push_back(u16(low)); });
+			c.values = std::move(values);
+			c.dense = std::vector<block>();
+			c.k = kind::array;
+		}
+		else if (c.k == kind::array && c.card > array_max)
+		{
+			c.dense.assign(chunk_blocks, block{});
+			for (const u16 low : c.values) set_bit(c.dense.data(), low);
+			c.values = std::vector<u16>();
+			c.k = kind::dense;
+		};
+	};
+
+	// a run chunk to its array or dense form
+	static void unrun(chunk& c)
+	{
+		std::vector<u16> pairs = std::move(c.values);
+		c.values = std::vector<u16>();
+		if (c.card > array_max)
+		{
+			c.dense.assign(chunk_blocks, block{});
+			for (size_t i = 0; i < pairs.size(); i += 2)
+				fill(c.dense.data(), pairs[i], pairs[i + 1]);
+			c.k = kind::dense;
+		}
+		else
+		{
+			c.values.reserve(c.card);
+			for (size_t i = 0; i < pairs.size(); i += 2)
+				for (u32 v = pairs[i]; v <= pairs[i + 1]; v++) c.values.push_back(u16(v));
+			c.k = kind::array;
+		};
+	};
+
+	const chunk* find(u16 key) const
+	{
+		auto at = std::lower_bound(list.begin(), list.end(), key, [](const chunk& c, u16 k) { return c.key < k; });
+		return (at != list.end() && at->key == key) ? &*at : nullptr;
+	};
+
+	chunk& find_or_add(u16 key)
+	{
+		auto at = std::lower_bound(list.begin(), list.end(), key, [](const chunk& c, u16 k) { return c.key < k; });
+		if (at == list.end() || at->key != key)
+			at = list.insert(at, chunk{ key, kind::array, 0, {}, {} });
+		return *at;
+	};
+
+	static ui512_bitmap combine(const ui512_bitmap& a, const ui512_bitmap& b, u32 op)
+	{
+		ui512_bitmap r;
+		size_t i = 0;
+		size_t j = 0;
+		while (i < a.list.size() || j < b.list.size())
+		{
+			if (j == b.list.size() || (i < a.list.size() && a.list[i].key < b.list[j].key))
+			{
+				if (op != PIPE_AND) r.list.push_back(a.list[i]);
+				i++;
+			}
+			else if (i == a.list.size() || b.list[j].key < a.list[i].key)
+			{
+				if (op != PIPE_AND) r.list.push_back(b.list[j]);
+				j++;
+			}
+			else
+			{
+				chunk c = combine_chunk(a.list[i++], b.list[j++], op);
+				if (c.card != 0)
+					r.list.push_back(std::move(c));
+			};
+		};
+		return r;
+	};
+
+	static chunk combine_chunk(const chunk& x, const chunk& y, u32 op)
+	{
+		if (x.k == kind::run && y.k == kind::run && op != PIPE_XOR)
+			return combine_runs(x, y, op);
+		if (op == PIPE_AND && (x.k == kind::run) != (y.k == kind::run) && (x.k == kind::array || y.k == kind::array))
+		{
+			// the array's values that fall in the runs, both in order
+			const chunk& arr = (x.k == kind::array) ? x : y;
+			const chunk& run = (x.k == kind::array) ? y : x;
+			chunk r{ x.key, kind::array, 0, {}, {} };
+			size_t i = 0;
+			for (const u16 low : arr.values)
+			{
+				while (i < run.values.size() && run.values[i + 1] < low)
+					i += 2;
+				if (i == run.values.size())
+					break;
+				if (low >= run.values[i])
+					r.values.push_back(low);
+			};
+			r.card = u32(r.values.size());
+			return r;
+		};
+		if (x.k == kind::run || y.k == kind::run)
+		{
+			chunk x2 = x;
+			chunk y2 = y;
+			if (x2.k == kind::run) unrun(x2);
+			if (y2.k == kind::run) unrun(y2);
+			return combine_chunk(x2, y2, op);
+		};
+		chunk r{ x.key, kind::array, 0, {}, {} };
+		if (x.k == kind::dense && y.k == kind::dense)
+		{
+			// the op and the popcount of its result, in one pass over the blocks
+			r.k = kind::dense;
+			r.dense.resize(chunk_blocks);
+			s16 counts[chunk_blocks];
+			const pipe_slot_u slots[] = { { r.dense.data(), 64, 0 }, { x.dense.data(), 64, 0 }, { y.dense.data(), 64, 0 },
+				{ counts, 2, 0 } };
+			const pipe_op_u ops[] = { { u8(op), 0, 1, 2, 0, 0, 0 }, { u8(PIPE_POPCNT), 3, 0, 0, 0, 0, 0 } };
+			r.card = u32(pipe_run_n(slots, ops, 2, 0, chunk_blocks));
+		}
+		else if (x.k == kind::array && y.k == kind::array)
+		{
+			if (op == PIPE_AND)
+				intersect(x.values, y.values, r.values);
+			else
+			{
+				r.values.reserve(x.values.size() + y.values.size());
+				if (op == PIPE_OR)
+					std::set_union(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(), std::back_inserter(r.values));
+				else
+					std::set_symmetric_difference(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(),
+						std::back_inserter(r.values));
+			};
+			r.card = u32(r.values.size());
+		}
+		else
+		{
+			const chunk& arr = (x.k == kind::array) ? x : y;
+			const chunk& den = (x.k == kind::array) ? y : x;
+			if (op == PIPE_AND)
+			{
+				for (const u16 low : arr.values)
+					if (test_bit(den.dense.data(), low)) r.values.push_back(low);
+				r.card = u32(r.values.size());
+			}
+			else
+			{
+				r.k = kind::dense;
+				r.dense = den.dense;
+				r.card = den.card;
+				for (const u16 low : arr.values)
+				{
+					const bool was = test_bit(r.dense.data(), low);
+					if (op == PIPE_OR)
+					{
+						set_bit(r.dense.data(), low);
+						r.card += was ? 0 : 1;
+					}
+					else
+					{
+						flip_bit(r.dense.data(), low);
+						r.card = was ? r.card - 1 : r.card + 1;
+					};
+				};
+			};
+		};
+		if (r.card != 0)
+			settle(r);
+		return r;
+	};
+
+	// sorted intersection; galloping (doubling steps, then a binary search) through the larger if much larger
+	static void intersect(const std::vector<u16>& x, const std::vector<u16>& y, std::vector<u16>& out)
+	{
+		const std::vector<u16>& small = (x.size() <= y.size()) ? x : y;
+		const std::vector<u16>& large = (x.size() <= y.size()) ? y : x;
+		if (small.size() * gallop_ratio < large.size())
+		{
+			size_t lo = 0;
+			for (const u16 v : small)
+			{
+				size_t step = 1;
+				size_t hi = lo;
+				while (hi < large.size() && large[hi] < v)
+				{
+					lo = hi + 1;
+					hi += step;
+					step *= 2;
+				};
+				hi = std::min(hi + 1, large.size());
+				lo = size_t(std::lower_bound(large.begin() + lo, large.begin() + hi, v) - large.begin());
+				if (lo < large.size() && large[lo] == v)
+					out.push_back(v);
+			};
+			return;
+		};
+		std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(out));
+	};
+
+	// runs with runs: the intersection (and_) or union (or_) of the intervals
+	static chunk combine_runs(const chunk& x, const chunk& y, u32 op)
+	{
+		chunk r{ x.key, kind::run, 0, {}, {} };
+		auto emit = [&r](u32 first, u32 last)
+			{
+				if (!r.values.empty() && u32(r.values.back()) + 1 >= first)
+				{
+					if (last > r.values.back()) r.values.back() = u16(last);
+				}
+				else
+				{
+					r.values.push_back(u16(first));
+					r.values.push_back(u16(last));
+				};
+			};
+		size_t i = 0;
+		size_t j = 0;
+		if (op == PIPE_AND)
+		{
+			while (i < x.values.size() && j < y.values.size())
+			{
+				const u32 first = std::max(x.values[i], y.values[j]);
+				const u32 last = std::min(x.values[i + 1], y.values[j + 1]);
+				if (first <= last)
+					emit(first, last);
+				if (x.values[i + 1] < y.values[j + 1]) i += 2; else j += 2;
+			};
+		}
+		else
+		{
+			while (i < x.values.size() || j < y.values.size())
+			{
+				if (j == y.values.size() || (i < x.values.size() && x.values[i] <= y.values[j]))
+				{
+					emit(x.values[i], x.values[i + 1]);
+					i += 2;
+				}
+				else
+				{
+					emit(y.values[j], y.values[j + 1]);
+					j += 2;
+				};
+			};
+		};
+		for (size_t k = 0; k < r.values.size(); k += 2)
+			r.card += u32(r.values[k + 1]) - r.values[k] + 1;
+		if (r.card != 0)
+			settle(r);
+		return r;
+	};
+
+	std::vector<chunk> list;											// by key
+};
+
+#endif//		ui512bitmap_h
@@ -0,0 +1,345 @@
+#pragma once
+
+#ifndef ui512file_h
+#define ui512file_h
+
+//		ui512file.h
+//
+//		File:			ui512file.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		Files of 512 bit records, mapped into memory so the procs of ui512b work on the records in place (no reads, no copies):
+//
+//			format			-	a 64 byte header (ui512_file_header), then the records, 64 bytes each; the payload is at offset 64,
+//								and views are mapped on 64K (Linux: page) boundaries, so every record is 64 byte aligned in memory
+//			ui512_file		-	open maps a file read only; create makes (or replaces) a file of up to n records, mapped for write
+//			scans			-	ui512_scan_match, ui512_scan_popcnt, ui512_scan_combine: a window of ScanWindow records at a time,
+//								the next window prefetched while one is processed; a file larger than memory is paged in and out
+//								by the system as the scan passes
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "CommonTypeDefs.h"
+#include "ui512b.h"
+
+struct ui512_file_header
+{
+	static constexpr u64 magic_value = 0x4345523231356955ull;			// "Ui512REC"
+	static constexpr u32 version_value = 1;
+
+	u64 magic;
+	u32 version;
+	u32 record_bytes;													// 64
+	u64 count;															// records
+	u64 payload;														// offset of the first record, 64
+	u64 reserved[4];
+};
+static_assert(sizeof(ui512_file_header) == 64, "ui512 file header is one record long");
+
+class ui512_file
+{
+public:
+	ui512_file() = default;
+	~ui512_file() { close(); }
+
+	ui512_file(const ui512_file&) = delete;
+	ui512_file& operator=(const ui512_file&) = delete;
+
+	// map an existing file, read only; false if it cannot be opened or is not a ui512 record file
+	bool open(const char* path)
+	{
+		close();
+		if (!os_open(path, false))
+			return false;
+		const u64 size = os_size();
+		if (size < sizeof(ui512_file_header) || !map(false, 0))
+		{
+			close();
+			return false;
+		};
+		const ui512_file_header* h = header();
+		if (h->magic != ui512_file_header::magic_value || h->version != ui512_file_header::version_value
+			|| h->record_bytes != 64 || h->payload != sizeof(ui512_file_header)
+			|| h->count > (size - sizeof(ui512_file_header)) / 64)
+		{
+			close();
+			return false;
+		};
+		records = h->count;
+		return true;
+	};
+
+	// make (or replace) a file with room for capacity records, mapped for write; the size is capacity until shrink
+	bool create(const char* path, u64 capacity)
+	{
+		close();
+		if (!os_open(path, true))
+			return false;
+		if (!map(true, sizeof(ui512_file_header) + capacity * 64))
+		{
+			close();
+			return false;
+		};
+		ui512_file_header* h = header();
+		std::memset(h, 0, sizeof(ui512_file_header));
+		h->magic = ui512_file_header::magic_value;
+		h->version = ui512_file_header::version_value;
+		h->record_bytes = 64;
+		h->count = capacity;
+		h->payload = sizeof(ui512_file_header);
+		records = capacity;
+		writable = true;
+		return true;
+	};
+
+	// (created files) keep only the first count records
+	void shrink(u64 count)
+	{
+		if (writable && count < records)
+			header()->count = records = count;
+	};
+
+	// unmap; a created file is cut to its records
+	void close()
+	{
+		unmap();
+		os_close();
+		records = 0;
+		writable = false;
+	};
+
+	bool is_open() const { return view != nullptr; };
+	u64 size() const { return records; };								// records
+
+	// record i: its 8 QWORDS in the mapped view, 64 byte aligned
+	const u64* data() const { return reinterpret_cast<const u64*>(view + sizeof(ui512_file_header)); };
+	u64* data() { return reinterpret_cast<u64*>(view + sizeof(ui512_file_header)); };
+	const u64* operator[](u64 i) const { return data() + i * 8; };
+
+	// hint that records first to first + n are wanted soon (read ahead)
+	void prefetch(u64 first, u64 n) const
+	{
+		if (first >= records)
+			return;
+		if (n > records - first)
+			n = records - first;
+#ifdef _WIN32
+		WIN32_MEMORY_RANGE_ENTRY range{ const_cast<u64*>((*this)[first]), SIZE_T(n * 64) };
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+		const uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+		const uintptr_t start = uintptr_t((*this)[first]) & ~(page - 1);	// madvise takes a page aligned address
+		madvise(reinterpret_cast<void*>(start), uintptr_t((*this)[first]) + n * 64 - start, MADV_WILLNEED);
+#endif
+	};
+
+private:
+#ifdef _WIN32
+	bool os_open(const char* path, bool write)
+	{
+		file = write ? CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)
+			: CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		return file != INVALID_HANDLE_VALUE;
+	};
+
+	u64 os_size() const
+	{
+		LARGE_INTEGER size{};
+		return GetFileSizeEx(file, &size) ? u64(size.QuadPart) : 0;
+	};
+
+	bool map(bool write, u64 bytes)
+	{
+		mapping = CreateFileMappingA(file, nullptr, write ? PAGE_READWRITE : PAGE_READONLY,
+			DWORD(bytes >> 32), DWORD(bytes), nullptr);
+		if (mapping == nullptr)
+			return false;
+		view = static_cast<u8*>(MapViewOfFile(mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+		return view != nullptr;
+	};
+
+	void unmap()
+	{
+		if (view != nullptr)
+		{
+			if (writable)
+				FlushViewOfFile(view, 0);
+			UnmapViewOfFile(view);
+			view = nullptr;
+		};
+		if (mapping != nullptr)
+		{
+			CloseHandle(mapping);
+			mapping = nullptr;
+		};
+	};
+
+	// a created file is cut to its records
+	void os_close()
+	{
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			if (writable)
+			{
+				LARGE_INTEGER end{};
+				end.QuadPart = LONGLONG(sizeof(ui512_file_header) + records * 64);
+				SetFilePointerEx(file, end, nullptr, FILE_BEGIN);
+				SetEndOfFile(file);
+			};
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		};
+	};
+
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	bool os_open(const char* path, bool write)
+	{
+		file = write ? ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path, O_RDONLY);
+		if (file >= 0 && !write)
+			posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+		return file >= 0;
+	};
+
+	u64 os_size() const
+	{
+		struct stat st {};
+		return fstat(file, &st) == 0 ? u64(st.st_size) : 0;
+	};
+
+	// bytes 0: the whole file
+	bool map(bool write, u64 bytes)
+	{
+		if (bytes == 0)
+			bytes = os_size();
+		else if (ftruncate(file, off_t(bytes)) != 0)
+			return false;
+		void* p = mmap(nullptr, bytes, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file, 0);
+		if (p == MAP_FAILED)
+			return false;
+		view = static_cast<u8*>(p);
+		view_bytes = bytes;
+		return true;
+	};
+
+	void unmap()
+	{
+		if (view != nullptr)
+		{
+			if (writable)
+				msync(view, view_bytes, MS_SYNC);
+			munmap(view, view_bytes);
+			view = nullptr;
+		};
+	};
+
+	// a created file is cut to its records
+	void os_close()
+	{
+		if (file >= 0)
+		{
+			if (writable)
+			{
+				const int cut = ftruncate(file, off_t(sizeof(ui512_file_header) + records * 64));
+				(void)cut;												// if not cut, the header still holds the count
+			};
+			::close(file);
+			file = -1;
+		};
+	};
+
+	int file = -1;
+	u64 view_bytes = 0;
+#endif
+
+	ui512_file_header* header() const { return reinterpret_cast<ui512_file_header*>(view); };
+
+	u8* view = nullptr;
+	u64 records = 0;
+	bool writable = false;
+};
+
+// records a scan works on at once (4M bytes)
+constexpr u64 ScanWindow = 65536;
+
+// indices of the records with ( record AND mask ) equal to pattern (match_n), in order, to out (room for the file size);
+// or, if out_file is given, the records themselves to it (created). returns: number matching
+inline u64 ui512_scan_match(const ui512_file& in, const u64* mask, const u64* pattern, u64* out, const char* out_file = nullptr)
+{
+	ui512_file written;
+	if (out_file != nullptr && !written.create(out_file, in.size()))
+		return 0;
+	u64* window = (out_file != nullptr) ? new u64[ScanWindow] : nullptr;
+	u64 found = 0;
+	for (u64 first = 0; first < in.size(); first += ScanWindow)
+	{
+		const u64 n = (in.size() - first < ScanWindow) ? in.size() - first : ScanWindow;
+		in.prefetch(first + ScanWindow, ScanWindow);
+		u64* indices = (window != nullptr) ? window : out + found;
+		const u64 m = match_n(in[first], n, mask, pattern, indices);
+		for (u64 j = 0; j < m; j++)
+		{
+			if (window != nullptr)
+				std::memcpy(written.data() + (found + j) * 8, in[first + indices[j]], 64);
+			else
+				indices[j] += first;
+		};
+		found += m;
+	};
+	delete[] window;
+	written.shrink(found);
+	return found;
+};
+
+// total of the set bits of all records (popcnt_n)
+inline u64 ui512_scan_popcnt(const ui512_file& in)
+{
+	u16* counts = new u16[ScanWindow];
+	u64 total = 0;
+	for (u64 first = 0; first < in.size(); first += ScanWindow)
+	{
+		const u64 n = (in.size() - first < ScanWindow) ? in.size() - first : ScanWindow;
+		in.prefetch(first + ScanWindow, ScanWindow);
+		total += popcnt_n(counts, in[first], n);
+	};
+	delete[] counts;
+	return total;
+};
+
+// out_file (created) record i from record i of a and of b by op: and_u, or_u or xor_u (as many records as the shorter)
+// returns: records written, 0 if out_file cannot be created
+inline u64 ui512_scan_combine(const ui512_file& a, const ui512_file& b, void (*op)(const u64*, const u64*, const u64*),
+	const char* out_file)
+{
+	const u64 n = (a.size() < b.size()) ? a.size() : b.size();
+	ui512_file out;
+	if (!out.create(out_file, n))
+		return 0;
+	for (u64 first = 0; first < n; first += ScanWindow)
+	{
+		const u64 w = (n - first < ScanWindow) ? n - first : ScanWindow;
+		a.prefetch(first + ScanWindow, ScanWindow);
+		b.prefetch(first + ScanWindow, ScanWindow);
+		for (u64 i = first; i < first + w; i++)
+			op(out.data() + i * 8, a[i], b[i]);
+	};
+	return n;
+};
+
+#endif//		ui512file_h
@@ -0,0 +1,105 @@
+#pragma once
+
+#ifndef ui512instrument_h
+#define ui512instrument_h
+
+//		ui512instrument.h
+//
+//		File:			ui512instrument.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		Reading the call counts and cycle histograms the procs of ui512b keep when assembled with __Instrument
+//		(compile_time_options.inc). Without it, instrument_table_u is empty: there is nothing to read, and nothing is counted.
+//
+//			ui512_instrumented			-	was ui512b.asm assembled with __Instrument?
+//			ui512_instrument_snapshot	-	the counts of each proc, the slots of all threads added together
+//			ui512_instrument_reset		-	zero the counts, and free the slots of the threads (calls in progress on other threads
+//											may still be added after: reset while the other threads are not calling the procs)
+//
+//		Each thread counts in its own slot (given on its first call), with plain adds, so the snapshot adds the slots together.
+//
+//		Cycles are TSC cycles (RDTSC) from before the call of the proc body to after its return, so include the call and return.
+
+#include <cstring>
+
+#include "CommonTypeDefs.h"
+#include "ui512b.h"
+
+static_assert(sizeof(instrument_slot_u) == 256, "instrument slot is four cache lines (InstrumentSlotBytes)");
+
+struct ui512_proc_stats
+{
+	const char* name;
+	u64 calls;
+	u64 cycles;															// total
+	u64 buckets[InstrumentBuckets];										// calls taking 2^b to 2^(b+1) - 1 cycles
+
+	double mean() const { return calls == 0 ? 0.0 : double(cycles) / double(calls); };
+
+	// upper bound (2^(b+1)) of the bucket holding fraction p (0 to 1) of the calls, e.g. 0.99 for the 99th percentile
+	u64 percentile(double p) const
+	{
+		const double want = p * double(calls);
+		u64 seen = 0;
+		for (int b = 0; b < InstrumentBuckets; b++)
+		{
+			seen += buckets[b];
+			if (seen != 0 && double(seen) >= want)
+				return u64(2) << b;
+		};
+		return 0;
+	};
+};
+
+inline bool ui512_instrumented()
+{
+	return (options_u() & OPTIONS_INSTRUMENT) != 0;
+};
+
+// the slots of all threads of entry e, added together, to s
+inline void ui512_instrument_sum(const instrument_entry_u* e, ui512_proc_stats* s)
+{
+	std::memset(s, 0, sizeof(*s));
+	s->name = e->name;
+	for (int t = 0; t < InstrumentSlots; t++)
+	{
+		const instrument_slot_u& slot = e->slots[t];
+		s->calls += slot.calls;
+		s->cycles += slot.cycles;
+		for (int b = 0; b < InstrumentBuckets; b++)
+			s->buckets[b] += slot.buckets[b];
+	};
+};
+
+// counts of up to max procs to out, in the order of ui512b.asm; returns the number of instrumented procs
+inline size_t ui512_instrument_snapshot(ui512_proc_stats* out, size_t max)
+{
+	size_t n = 0;
+	for (const instrument_entry_u* e = instrument_table_u; e->name != nullptr; e++, n++)
+		if (n < max)
+			ui512_instrument_sum(e, &out[n]);
+	return n;
+};
+
+// the counts of the named proc (as exported, e.g. "shr_u"); false if it is not instrumented
+inline bool ui512_instrument_snapshot(const char* name, ui512_proc_stats* out)
+{
+	for (const instrument_entry_u* e = instrument_table_u; e->name != nullptr; e++)
+		if (std::strcmp(e->name, name) == 0)
+		{
+			ui512_instrument_sum(e, out);
+			return true;
+		};
+	return false;
+};
+
+inline void ui512_instrument_reset()
+{
+	for (const instrument_entry_u* e = instrument_table_u; e->name != nullptr; e++)
+		std::memset(e->slots, 0, sizeof(instrument_slot_u) * InstrumentSlots);
+	std::memset(instrument_threads_u, 0, sizeof(u64) * InstrumentThreads);
+};
+
+#endif//		ui512instrument_h
@@ -0,0 +1,125 @@
+#pragma once
+
+#ifndef ui512pipe_h
+#define ui512pipe_h
+
+//		ui512pipe.h
+//
+//		File:			ui512pipe.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		Builds the op lists of pipe_run_n (ui512b.h), and runs them, on one thread or several:
+//
+//			slots		-	array (records, read or written), constant (one value for every record), counts (the s16 results
+//							of popcnt, msb, lsb, one per record), temp (an intermediate, in a tile buffer: never in memory whole)
+//			ops			-	shr, shl, and_, or_, xor_, not_, tern (any function of three, as VPTERNLOGQ), popcnt, msb, lsb;
+//							each d = op( a, ... ) on every record, d may be an operand
+//			run			-	the ops on records first to first + n - 1, a tile at a time; with threads, the tiles split between
+//							them, each with its own tile buffers. Returns the total of the popcnt counts
+//
+//		e.g. ( ( x >> 3 ) AND mask ) XOR key, counted, one pass over x:
+//			ui512_pipe p;
+//			const int x = p.array(records), m = p.constant(mask), k = p.constant(key), t = p.temp(), c = p.counts(out);
+//			p.shr(t, x, 3).and_(t, t, m).xor_(t, t, k).popcnt(c, t);
+//			u64 bits = p.run(n);
+
+#include <thread>
+#include <vector>
+
+#include "CommonTypeDefs.h"
+#include "ui512b.h"
+
+class ui512_pipe
+{
+public:
+	// slots: each returns its number, for the ops
+	int array(const u64* records) { return slot(records, 64, 0); };
+	int constant(const u64* value) { return slot(value, 0, 0); };
+	int counts(const s16* results) { return slot(results, 2, 0); };
+	int temp() { return slot(nullptr, 64, 1); };
+
+	// ops, in the order run
+	ui512_pipe& shr(int d, int a, u16 bits) { return op(PIPE_SHR, d, a, 0, 0, 0, bits); };
+	ui512_pipe& shl(int d, int a, u16 bits) { return op(PIPE_SHL, d, a, 0, 0, 0, bits); };
+	ui512_pipe& and_(int d, int a, int b) { return op(PIPE_AND, d, a, b, 0, 0, 0); };
+	ui512_pipe& or_(int d, int a, int b) { return op(PIPE_OR, d, a, b, 0, 0, 0); };
+	ui512_pipe& xor_(int d, int a, int b) { return op(PIPE_XOR, d, a, b, 0, 0, 0); };
+	ui512_pipe& not_(int d, int a) { return op(PIPE_NOT, d, a, 0, 0, 0, 0); };
+	ui512_pipe& tern(int d, int a, int b, int c, u8 imm) { return op(PIPE_TERN, d, a, b, c, imm, 0); };
+	ui512_pipe& popcnt(int d, int a) { return op(PIPE_POPCNT, d, a, 0, 0, 0, 0); };
+	ui512_pipe& msb(int d, int a) { return op(PIPE_MSB, d, a, 0, 0, 0, 0); };
+	ui512_pipe& lsb(int d, int a) { return op(PIPE_LSB, d, a, 0, 0, 0, 0); };
+
+	// the ops on records first to first + n - 1, split by whole tiles between threads (the calling thread one of them)
+	u64 run(u64 first, u64 n, unsigned threads = 1) const
+	{
+		const u64 tiles = (n + PIPE_TILE - 1) / PIPE_TILE;
+		if (threads > tiles)
+			threads = unsigned(tiles);
+		if (threads <= 1)
+			return run_part(first, n);
+		const u64 per = (tiles + threads - 1) / threads * PIPE_TILE;	// records to a thread
+		std::vector<u64> totals(threads, 0);
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < threads; t++)
+		{
+			const u64 start = t * per;
+			if (start >= n)
+				break;
+			const u64 count = (n - start < per) ? n - start : per;
+			workers.emplace_back([this, &totals, t, first, start, count] { totals[t] = run_part(first + start, count); });
+		};
+		totals[0] = run_part(first, per < n ? per : n);
+		for (std::thread& w : workers)
+			w.join();
+		u64 total = 0;
+		for (const u64 x : totals)
+			total += x;
+		return total;
+	};
+	u64 run(u64 n) const { return run(0, n, 1); };
+
+	const std::vector<pipe_slot_u>& slot_list() const { return slots; };
+	const std::vector<pipe_op_u>& op_list() const { return ops; };
+
+private:
+	struct alignas(64) tile_buffer
+	{
+		u64 w[PIPE_TILE * 8];
+	};
+
+	int slot(const void* base, u32 stride, u32 tile)
+	{
+		slots.push_back(pipe_slot_u{ base, stride, tile });
+		return int(slots.size() - 1);
+	};
+
+	ui512_pipe& op(u32 code, int d, int a, int b, int c, u8 imm, u16 bits)
+	{
+		ops.push_back(pipe_op_u{ u8(code), u8(d), u8(a), u8(b), u8(c), imm, bits });
+		return *this;
+	};
+
+	// on this thread: its own tile buffers for the temps
+	u64 run_part(u64 first, u64 n) const
+	{
+		std::vector<pipe_slot_u> own = slots;
+		size_t ntemps = 0;
+		for (const pipe_slot_u& s : own)
+			if (s.tile != 0)
+				ntemps++;
+		std::vector<tile_buffer> buffers(ntemps);
+		size_t next = 0;
+		for (pipe_slot_u& s : own)
+			if (s.tile != 0)
+				s.base = buffers[next++].w;
+		return pipe_run_n(own.data(), ops.data(), ops.size(), first, n);
+	};
+
+	std::vector<pipe_slot_u> slots;
+	std::vector<pipe_op_u> ops;
+};
+
+#endif//		ui512pipe_h
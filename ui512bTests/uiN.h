@@ -0,0 +1,186 @@
+#pragma once
+
+#ifndef uiN_h
+#define uiN_h
+
+//		uiN.h
+//
+//		File:			uiN.h
+//		Author:			John G.Lynch
+//		Legal:			Copyright @2024, per MIT License below
+//		Date:			June 11, 2024
+//
+//		ui<N>: unsigned N bit values, N 256 or a multiple of 512 up to 32768, with the bit oriented operations of ui512b.h under the same names,
+//		so code can change width without changing its calls. Words as ui512: word 0 most significant, bit 0 the lsb of the last word.
+//
+//			ui<256>		-	the 256 bit procs of ui512b.asm (shr256_u ...), in one YMM register (Z, Y)
+//			ui<512>		-	the ui512b.asm procs
+//			ui<N>		-	N / 512 limbs of 512 bits (limb 0 most significant), the ui512b.asm procs on each limb, carrying between limbs
+
+#include "CommonTypeDefs.h"
+#include "ui512b.h"
+
+template<int N>
+struct alignas(N == 256 ? 32 : 64) ui
+{
+	// msb_u / lsb_u return the bit number as s16, and the shift counts are u16: both hold 0 to N - 1, and N, only to 32768
+	static_assert(N == 256 || (N > 0 && N % 512 == 0 && N <= 32768), "ui<N>: N must be 256 or a multiple of 512, to 32768");
+
+	static constexpr int bits = N;
+	static constexpr int words = N / 64;
+	static constexpr int limbs = N == 256 ? 1 : N / 512;
+
+	u64 w[N / 64];
+};
+
+// void shr_u ( ui<N>& destination, ui<N>& source, u16 bits ); destination may be source; N or more bits zeroes
+template<int N>
+void shr_u(ui<N>& dest, const ui<N>& src, const u16 bits)
+{
+	if constexpr (N == 256)
+		shr256_u(dest.w, src.w, bits);
+	else if constexpr (N == 512)
+		shr_u(dest.w, src.w, bits);
+	else
+	{
+		constexpr int L = ui<N>::limbs;
+		const int q = bits / 512;											// whole limbs
+		const u16 r = bits % 512;
+		alignas (64) u64 t[8];
+		alignas (64) u64 c[8];
+		for (int i = L - 1; i >= 0; i--)									// least significant first: each limb from those above
+		{
+			u64* d = dest.w + i * 8;
+			if (i - q < 0)
+			{
+				for (int j = 0; j < 8; j++) d[j] = 0;
+				continue;
+			}
+			shr_u(t, src.w + (i - q) * 8, r);
+			if (r != 0 && i - q - 1 >= 0)
+			{
+				shl_u(c, src.w + (i - q - 1) * 8, u16(512 - r));				// carry: the low bits of the limb above
+				or_u(t, t, c);
+			}
+			for (int j = 0; j < 8; j++) d[j] = t[j];
+		}
+	}
+}
+
+// void shl_u ( ui<N>& destination, ui<N>& source, u16 bits ); destination may be source; N or more bits zeroes
+template<int N>
+void shl_u(ui<N>& dest, const ui<N>& src, const u16 bits)
+{
+	if constexpr (N == 256)
+		shl256_u(dest.w, src.w, bits);
+	else if constexpr (N == 512)
+		shl_u(dest.w, src.w, bits);
+	else
+	{
+		constexpr int L = ui<N>::limbs;
+		const int q = bits / 512;
+		const u16 r = bits % 512;
+		alignas (64) u64 t[8];
+		alignas (64) u64 c[8];
+		for (int i = 0; i < L; i++)											// most significant first: each limb from those below
+		{
+			u64* d = dest.w + i * 8;
+			if (i + q >= L)
+			{
+				for (int j = 0; j < 8; j++) d[j] = 0;
+				continue;
+			}
+			shl_u(t, src.w + (i + q) * 8, r);
+			if (r != 0 && i + q + 1 < L)
+			{
+				shr_u(c, src.w + (i + q + 1) * 8, u16(512 - r));				// carry: the high bits of the limb below
+				or_u(t, t, c);
+			}
+			for (int j = 0; j < 8; j++) d[j] = t[j];
+		}
+	}
+}
+
+// void and_u ( ui<N>& destination, ui<N>& lh_op, ui<N>& rh_op );
+template<int N>
+void and_u(ui<N>& dest, const ui<N>& lh, const ui<N>& rh)
+{
+	if constexpr (N == 256)
+		and256_u(dest.w, lh.w, rh.w);
+	else
+		for (int i = 0; i < ui<N>::limbs; i++)
+			and_u(dest.w + i * 8, lh.w + i * 8, rh.w + i * 8);
+}
+
+// void or_u ( ui<N>& destination, ui<N>& lh_op, ui<N>& rh_op );
+template<int N>
+void or_u(ui<N>& dest, const ui<N>& lh, const ui<N>& rh)
+{
+	if constexpr (N == 256)
+		or256_u(dest.w, lh.w, rh.w);
+	else
+		for (int i = 0; i < ui<N>::limbs; i++)
+			or_u(dest.w + i * 8, lh.w + i * 8, rh.w + i * 8);
+}
+
+// void xor_u ( ui<N>& destination, ui<N>& lh_op, ui<N>& rh_op );
+template<int N>
+void xor_u(ui<N>& dest, const ui<N>& lh, const ui<N>& rh)
+{
+	if constexpr (N == 256)
+		xor256_u(dest.w, lh.w, rh.w);
+	else
+		for (int i = 0; i < ui<N>::limbs; i++)
+			xor_u(dest.w + i * 8, lh.w + i * 8, rh.w + i * 8);
+}
+
+// void not_u ( ui<N>& destination, ui<N>& source );
+template<int N>
+void not_u(ui<N>& dest, const ui<N>& src)
+{
+	if constexpr (N == 256)
+		not256_u(dest.w, src.w);
+	else
+		for (int i = 0; i < ui<N>::limbs; i++)
+			not_u(dest.w + i * 8, src.w + i * 8);
+}
+
+// s16 msb_u ( ui<N>& source ); returns: -1 if zero, bit number (0 to N - 1) otherwise
+template<int N>
+s16 msb_u(const ui<N>& src)
+{
+	if constexpr (N == 256)
+		return msb256_u(src.w);
+	else
+	{
+		constexpr int L = ui<N>::limbs;
+		for (int i = 0; i < L; i++)
+		{
+			const s16 b = msb_u(src.w + i * 8);
+			if (b >= 0)
+				return s16((L - 1 - i) * 512 + b);
+		}
+		return -1;
+	}
+}
+
+// s16 lsb_u ( ui<N>& source ); returns: -1 if zero, bit number (0 to N - 1) otherwise
+template<int N>
+s16 lsb_u(const ui<N>& src)
+{
+	if constexpr (N == 256)
+		return lsb256_u(src.w);
+	else
+	{
+		constexpr int L = ui<N>::limbs;
+		for (int i = L - 1; i >= 0; i--)
+		{
+			const s16 b = lsb_u(src.w + i * 8);
+			if (b >= 0)
+				return s16((L - 1 - i) * 512 + b);
+		}
+		return -1;
+	}
+}
+
+#endif//		uiN_h